@@ -9,9 +9,17 @@
 #include <atomic>
 #include <optional>
 #include "core/Request.h"
+#include "core/PreparedRequest.h"
 #include "core/Response.h"
 #include "core/HttpResult.h"
+#include "core/Arena.h"
 #include "core/ConnectionPool.h"
+#include "core/ClientMetrics.h"
+#include "core/AsyncResult.h"
+#include "core/WorkerPool.h"
+#include "core/EventLoop.h"
+#include "core/Coroutine.h"
+#include "core/ResponseStream.h"
 #include "Result.h"
 #include "auth/Auth.h"
 #include "core/Connection.h"
@@ -38,7 +46,28 @@ namespace canaspad
         void setWriteTimeout(std::chrono::milliseconds timeout);
 
         Result<HttpResult> send(const Request &request);
-        void cancel(const std::string &requestId);
+        // レスポンスのヘッダーと解析中の一時データを arena から確保する
+        // 結果のヘッダーは arena を reset() するまで有効 (コピーした HttpResult は通常のヒープに作られる)
+        Result<HttpResult> send(const Request &request, Arena &arena);
+        // 本文以外を一度だけ組み立てておき、同じリクエストを本文だけ変えて繰り返し送る
+        Result<PreparedRequest> prepare(const Request &request);
+        Result<HttpResult> send(const PreparedRequest &request, const std::string &body);
+        // ワーカーのタスクで送信し、すぐに戻る。onComplete は完了時にワーカーのタスクで呼ばれる
+        // ワーカーは最初の呼び出しで ClientOptions::asyncWorkers 個起動する
+        // 実行待ちが asyncQueueSize を超える場合は QueueFull のエラーで完了済みの結果を返す
+        AsyncResult sendAsync(Request request, AsyncResult::Callback onComplete = nullptr);
+#if CANASPAD_HAS_COROUTINES
+        // コルーチンから送信する (co_await client.sendCo(request))
+        // 接続の確立、書き込み、レスポンスの受信待ち、リトライ前の待ち時間では Scheduler に制御を返し、同じタスクの他のコルーチンを進める
+        // プロキシ経由の接続と BodySource の本文の書き込みは完了するまでタスクを止める
+        Task<Result<HttpResult>> sendCo(Request request);
+        // ステータスとヘッダーを受け取った時点で返し、本文は ResponseStream::next() で少しずつ受け取る
+        // リトライは本文を受け取り始める前の失敗に限る
+        Task<Result<ResponseStream>> openCo(Request request);
+#endif
+        // Request::setId(requestId) で送信中のリクエストを取り消す (RequestCancelled で完了する)
+        // 取り消した送信の接続だけを閉じ、プールの他の接続は残す。送信中のものが見つからなければ false
+        bool cancel(const std::string &requestId);
 
         void enableCookies(bool enable = true);
         void setProgressCallback(std::function<void(size_t, size_t)> callback);
@@ -48,33 +77,123 @@ namespace canaspad
         Result<HttpResult> sendStreaming(const Request &request, ChunkCallback chunkCallback);
 
         Connection *getConnection() const;
+        ConnectionPool::Stats getConnectionPoolStats() const;
+        TlsSessionCache::Stats getTlsSessionStats() const;
+        DnsCache::Stats getDnsCacheStats() const;
+        // 送信の件数、エラー、ホストごとのレイテンシなどの集計値
+        MetricsSnapshot getMetrics() const;
+        void resetMetrics();
+
+        // ディープスリープ前に状態を保存し、起床後の最初のリクエストで
+        // 名前解決とフルハンドシェイクを省略できるようにする
+        Result<void> saveWarmState(ByteSink &sink) const;
+        Result<void> loadWarmState(ByteSource &source);
 
     private:
+        // 送信の各段階を止まらずに進めるため、接続の確立と組み立ての手順を共有する
+        friend class EventLoop;
+
         std::unique_ptr<ConnectionPool> m_connectionPool;
         std::shared_ptr<Connection> m_mockConnection;
         std::unique_ptr<Auth> m_auth;
         Timeouts m_timeouts;
         bool m_cookiesEnabled = false;
         ClientOptions m_options;
+        Url m_proxyUrl; // options.proxyUrl を構築時に一度だけ解析したもの
+        std::string m_proxyAuthorization;
         std::function<void(size_t, size_t)> m_progressCallback;
         std::function<void(const char *, size_t)> m_responseBodyCallback;
         bool m_useMock = false;
+        ClientMetrics m_metrics;
+        ConnectionPool::Stats m_poolStatsAtReset;
+        TlsSessionCache::Stats m_tlsStatsAtReset;
+        std::unique_ptr<WorkerPool> m_workers; // sendAsync を使うまでは起動しない
+        std::mutex m_workersMutex;
+        CancellationRegistry m_cancellations; // ID を持つ送信中のリクエスト
 
         bool m_isInitialized = true;
         ErrorInfo m_initializationError;
 
         bool checkTimeout(const std::chrono::steady_clock::time_point &start,
                           const std::chrono::milliseconds &timeout) const;
-        Result<HttpResult> sendWithRedirects(const Request &request, int redirectCount = 0);
-        Result<HttpResult> sendWithRetries(const Request &request, int retryCount = 0);
-        Result<std::shared_ptr<Connection>> establishConnection(const Request &request);
-        Result<std::shared_ptr<Connection>> establishDirectConnection(std::shared_ptr<Connection> connection, const std::string &host, int port);
-        Result<std::shared_ptr<Connection>> establishProxyConnection(std::shared_ptr<Connection> connection, const Request &request);
-        Result<std::shared_ptr<Connection>> establishProxyTunnel(std::shared_ptr<Connection> connection, const Request &request, const std::string &proxyHost, int proxyPort);
-        Result<HttpResult> readResponse(Connection *connection, const Request &request);
-        Result<HttpResult> handleChunkedResponse(Connection *connection, HttpResult &result, size_t startingPos);
-
-        std::string buildRequestString(const Request &request);
+        // 作成済みリクエストの送信時に、組み立て済みの部分と今回の本文をまとめて渡す
+        struct PreparedSend
+        {
+            const PreparedRequest &request;
+            const std::string &body;
+        };
+
+        Result<HttpResult> sendWithRedirects(const Request &request, int redirectCount = 0, const ChunkCallback &bodyCallback = nullptr, const PreparedSend *prepared = nullptr, Arena *arena = nullptr, RequestTiming *timing = nullptr);
+        Result<HttpResult> sendWithRetries(const Request &request, int retryCount = 0, const ChunkCallback &bodyCallback = nullptr, const PreparedSend *prepared = nullptr, Arena *arena = nullptr, RequestTiming *timing = nullptr);
+        Result<std::shared_ptr<BufferedConnection>> establishConnection(const Request &request, RequestTiming *timing = nullptr);
+        // ID を持つリクエストに送信ごとのトークン (リクエストのトークンを親にする) を設定し、ID で登録する
+        // ID による取り消しがその送信だけに効き、同じリクエストやそのコピーの後の送信に残らないようにする
+        CancellationRegistry::Registration registerSend(Request &request);
+        bool connectWithWarmState(Connection *connection, const std::string &host, int port, const CancellationToken &token);
+        // 接続の手順を kCheckInterval ごとに区切って進め、取り消された場合は打ち切る
+        bool connectUnlessCancelled(Connection *connection, const std::string &host, int port, const CancellationToken &token);
+        // 名前解決の結果と TLS セッションを接続に渡す / 接続の結果に応じて保存または破棄する
+        void applyWarmState(Connection *connection, const std::string &host, int port);
+        void storeWarmState(Connection *connection, const std::string &host, int port, bool connected);
+        Result<std::shared_ptr<BufferedConnection>> establishDirectConnection(std::shared_ptr<BufferedConnection> connection, const std::string &host, int port, const CancellationToken &token);
+        Result<std::shared_ptr<BufferedConnection>> establishProxyConnection(std::shared_ptr<BufferedConnection> connection, const Request &request);
+        Result<std::shared_ptr<BufferedConnection>> establishProxyTunnel(std::shared_ptr<BufferedConnection> connection, const Request &request, const std::string &proxyHost, int proxyPort);
+        Result<HttpResult> readResponse(BufferedConnection *connection, const Request &request, const ChunkCallback &bodyCallback = nullptr, bool *reusable = nullptr, Arena *arena = nullptr, RequestTiming *timing = nullptr);
+        // NetworkError と Timeout は maxRetries まで送り直す
+        bool isRetryable(const ErrorInfo &error, int retryCount) const;
+        // リトライまで retryDelay の間待つ。途中で取り消された場合は false
+        bool waitBeforeRetry(const Request &request) const;
+        void storeCookies(const Request &request, HttpResult &result);
+        Request makeRedirectRequest(const Request &request, const PreparedSend *prepared, std::string location) const;
+#if CANASPAD_HAS_COROUTINES
+        // リダイレクトを辿り、最後のレスポンスのヘッダーまでを受け取る
+        // registration は返したストリームを読み終えるまで保持する
+        Task<Result<ResponseStream>> openWithRedirectsCo(const Request &request, RequestTiming *timing,
+                                                         std::shared_ptr<CancellationRegistry::Registration> registration = nullptr);
+        // リダイレクトを辿り、本文まで受け取る
+        Task<Result<HttpResult>> exchangeCo(const Request &request, RequestTiming *timing);
+        Task<bool> waitBeforeRetryCo(const Request &request) const;
+        // 接続の確立 (beginConnect / continueConnect) を止まらずに進める。プロキシ経由の接続は establishConnection で確立する
+        Task<Result<std::shared_ptr<BufferedConnection>>> establishConnectionCo(const Request &request, RequestTiming *timing);
+        // ヘッダー部分と本文を writeSome で書き込み、送信バッファが空くまでは他のコルーチンを進める
+        // BodySource の本文は読み出しながら送るため、writeBodySource で書き終えるまで待つ
+        Task<Result<void>> writeRequestCo(Connection *connection, const Request &request);
+#endif
+
+        // 止まらずに進める送信 (EventLoop とコルーチン) の共通の手順。待ち方だけを呼び出し側で行う
+        // 書き込み中のリクエスト
+        struct PendingWrite
+        {
+            std::string head;        // ヘッダー部分 (短い本文は続けて入れ、1 回で書き込む)
+            bool bodyInHead = false;
+            size_t written = 0;      // head と本文のうち書き込んだバイト数
+        };
+        // プールの接続を借り、再利用できなければ接続を始める
+        // 接続の途中で待つ必要がある場合は progress に WantRead / WantWrite を返し、それ以外は Done になる
+        // プロキシ経由の接続は確立するまで待つ。プールの上限に達している場合は nullptr を返す
+        Result<std::shared_ptr<BufferedConnection>> beginConnection(const Request &request, RequestTiming *timing, IoProgress &progress);
+        // 接続の手順の結果 (Done / Failed) を記録し、名前解決の結果と TLS セッションを保存する
+        // 失敗した場合は接続を閉じ、deadline を過ぎていれば Timeout、それ以外は NetworkError を返す
+        Result<void> finishConnection(Connection *connection, const Request &request, IoProgress progress,
+                                      std::chrono::steady_clock::time_point deadline, RequestTiming *timing);
+        void startWrite(const Request &request, PendingWrite &pending);
+        // writeSome で書き込めるだけ書き込む。送信バッファが空くのを待つ場合は WantWrite を返す
+        // 書き込みが進むたびに deadline を write タイムアウト後に延ばす
+        // ヘッダー部分と本文を書き終えたら BodySource の本文を書き終えるまで送り、Done を返す
+        Result<IoProgress> writeStep(Connection *connection, const Request &request, PendingWrite &pending,
+                                     std::chrono::steady_clock::time_point &deadline);
+
+        // ヘッダー部分と本文を書き込む。source がある場合は続けて BodySource から読み出して送る
+        Result<void> writeRequest(Connection *connection, const std::string &head, const std::string &body, BodySource *source, const CancellationToken &token);
+        Result<void> writeBodySource(Connection *connection, BodySource &source, const CancellationToken &token);
+        Result<void> writeFully(Connection *connection, const uint8_t *data, size_t size, const CancellationToken &token);
+        void appendRequestHead(const Request &request, std::string &out) const;
+        void appendHeaders(const Request &request, std::string &out) const;
+        void appendCookieHeader(const Url &url, std::string &out) const;
+        void appendContentLength(size_t length, std::string &out) const;
+        // ヘッダー部分 (末尾の空行まで) を組み立てる。本文は含めない
+        std::string buildRequestHead(const Request &request);
+        std::string buildRequestHead(const PreparedSend &prepared);
     };
 
 } // namespace canaspad
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <variant>
 #include <string>
+#include "core/RequestTiming.h"
 
 namespace canaspad
 {
@@ -25,13 +26,17 @@ namespace canaspad
         DuplicateHeader,
         InvalidBody,
         InvalidOption,
-        InvalidProxyURL
+        InvalidProxyURL,
+        InvalidSnapshot,
+        QueueFull
     };
 
     struct ErrorInfo
     {
         ErrorCode code;
         std::string message;
+        // HttpClient の送信で発生したエラーの場合、失敗するまでの時刻の内訳
+        RequestTiming timing;
 
         ErrorInfo() : code(ErrorCode::None), message("") {}
         ErrorInfo(ErrorCode c, std::string msg) : code(c), message(std::move(msg)) {}
@@ -50,6 +55,8 @@ namespace canaspad
 
         // コピーコンストラクタ
         Result(const Result &other) : m_data(other.m_data) {}
+        // ムーブコンストラクタ (値を返すたびに複製しない)
+        Result(Result &&other) noexcept : m_data(std::move(other.m_data)) {}
         // ムーブ代入演算子
         Result &operator=(Result &&other) noexcept
         {
@@ -65,9 +72,11 @@ namespace canaspad
 
         // value() は T 型の Result でのみ使用されるため、特殊化しない
         const T &value() const & { return std::get<T>(m_data); }
+        T &value() & { return std::get<T>(m_data); }
         T &&value() && { return std::move(std::get<T>(m_data)); }
 
-        const ErrorInfo &error() const { return std::get<ErrorInfo>(m_data); }
+        const ErrorInfo &error() const & { return std::get<ErrorInfo>(m_data); }
+        ErrorInfo &error() & { return std::get<ErrorInfo>(m_data); }
     };
 
     // void 型の特殊化
@@ -83,6 +92,8 @@ namespace canaspad
 
         // コピーコンストラクタ
         Result(const Result &other) : m_data(other.m_data) {}
+        // ムーブコンストラクタ (値を返すたびに複製しない)
+        Result(Result &&other) noexcept : m_data(std::move(other.m_data)) {}
         // ムーブ代入演算子
         Result &operator=(Result &&other) noexcept
         {
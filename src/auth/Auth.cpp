@@ -5,30 +5,27 @@
 namespace canaspad
 {
 
-    Auth::Auth(const ClientOptions &options) : m_authType(options.authType),
-                                               m_username(options.username),
-                                               m_password(options.password),
-                                               m_bearerToken(options.bearerToken)
-    {
-    }
-
-    void Auth::applyAuthentication(Request &request)
+    Auth::Auth(const ClientOptions &options) : m_authType(options.authType)
     {
         switch (m_authType)
         {
         case AuthType::Basic:
-        {
-            std::string auth = m_username + ":" + m_password;
-            std::string encodedAuth = Utils::base64Encode(auth);
-            request.addHeader("Authorization", "Basic " + encodedAuth);
+            m_authorization = "Basic " + Utils::base64Encode(options.username + ":" + options.password);
             break;
-        }
         case AuthType::Bearer:
-            request.addHeader("Authorization", "Bearer " + m_bearerToken);
+            m_authorization = "Bearer " + options.bearerToken;
             break;
         default:
             break;
         }
     }
 
+    void Auth::applyAuthentication(Request &request)
+    {
+        if (!m_authorization.empty())
+        {
+            request.addHeader("Authorization", m_authorization);
+        }
+    }
+
 } // namespace canaspad
\ No newline at end of file
@@ -13,12 +13,12 @@ namespace canaspad
         Auth(const ClientOptions &options);
 
         void applyAuthentication(Request &request);
+        // Authorization ヘッダーの値 (認証なしの場合は空)
+        const std::string &authorizationHeader() const { return m_authorization; }
 
     private:
         AuthType m_authType;
-        std::string m_username;
-        std::string m_password;
-        std::string m_bearerToken;
+        std::string m_authorization; // 資格情報は構築時に一度だけエンコードする
     };
 
 } // namespace canaspad
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <ctime>
 #include <string>
 
 namespace canaspad
@@ -11,9 +12,9 @@ namespace canaspad
         std::string value;
         std::string domain;
         std::string path;
-        bool secure;
-        bool httpOnly;
-        time_t expires;
+        bool secure = false;
+        bool httpOnly = false;
+        time_t expires = 0; // 0 の場合はセッションクッキー
     };
 
 } // namespace canaspad
\ No newline at end of file
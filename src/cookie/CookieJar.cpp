@@ -9,11 +9,17 @@ namespace canaspad
 {
 
     void CookieJar::setCookie(const std::string &url, const std::string &setCookieHeader)
+    {
+        setCookie(Url(url), setCookieHeader);
+    }
+
+    void CookieJar::setCookie(const Url &url, const std::string &setCookieHeader)
     {
         Cookie cookie;
         Utils::parseCookie(setCookieHeader, cookie, url); // リクエストURLを渡す
 
         // クッキーをドメイン単位で保存
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_cookies[cookie.domain].push_back(cookie);
 
         // setCookie 内で有効期限切れのクッキーを削除 (例)
@@ -21,11 +27,17 @@ namespace canaspad
     }
 
     std::vector<std::string> CookieJar::getCookiesForUrl(const std::string &url) const
+    {
+        return getCookiesForUrl(Url(url));
+    }
+
+    std::vector<std::string> CookieJar::getCookiesForUrl(const Url &url) const
     {
         std::vector<std::string> result;
         time_t now = time(nullptr);
-        std::string domain = Utils::extractHost(url); // URLからドメインを取得
+        std::string domain(url.host()); // URLからドメインを取得
 
+        std::lock_guard<std::mutex> lock(m_mutex);
         // ドメインに一致するクッキーを取得
         auto it = m_cookies.find(domain);
         if (it != m_cookies.end())
@@ -42,6 +54,31 @@ namespace canaspad
         return result;
     }
 
+    void CookieJar::addCookie(const Cookie &cookie)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cookies[cookie.domain].push_back(cookie);
+        cleanupExpiredCookies();
+    }
+
+    std::vector<Cookie> CookieJar::getAllCookies() const
+    {
+        std::vector<Cookie> result;
+        time_t now = time(nullptr);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &[domain, cookies] : m_cookies)
+        {
+            for (const auto &cookie : cookies)
+            {
+                if (cookie.expires == 0 || cookie.expires >= now)
+                {
+                    result.push_back(cookie);
+                }
+            }
+        }
+        return result;
+    }
+
     // 有効期限切れのクッキーを削除する
     void CookieJar::cleanupExpiredCookies()
     {
@@ -1,20 +1,29 @@
 #pragma once
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "Cookie.h"
+#include "../utils/Url.h"
 
 namespace canaspad
 {
 
+    // sendAsync のワーカーから同時に使われるため、操作は排他する
     class CookieJar
     {
     public:
         void setCookie(const std::string &url, const std::string &setCookieHeader);
+        void setCookie(const Url &url, const std::string &setCookieHeader);
         std::vector<std::string> getCookiesForUrl(const std::string &url) const;
+        std::vector<std::string> getCookiesForUrl(const Url &url) const;
+        void addCookie(const Cookie &cookie);
+        // 有効期限内のクッキーをすべて返す
+        std::vector<Cookie> getAllCookies() const;
 
     private:
         std::unordered_map<std::string, std::vector<Cookie>> m_cookies;
+        mutable std::mutex m_mutex;
         void cleanupExpiredCookies();
     };
 
@@ -0,0 +1,99 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        size_t alignedOffset(const uint8_t *base, size_t offset, size_t alignment)
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+            return offset + (alignment - address % alignment) % alignment;
+        }
+    } // namespace
+
+    Arena::Arena(void *buffer, size_t size, size_t blockSize)
+        : m_buffer(static_cast<uint8_t *>(buffer)), m_bufferSize(size), m_blockSize(blockSize)
+    {
+        reset();
+    }
+
+    Arena::Arena(size_t blockSize) : m_blockSize(blockSize)
+    {
+        reset();
+    }
+
+    Arena::~Arena()
+    {
+        freeBlocks();
+        if (m_ownsBuffer)
+        {
+            std::free(m_buffer);
+        }
+    }
+
+    void *Arena::allocate(size_t size, size_t alignment)
+    {
+        size_t offset = alignedOffset(m_current, m_offset, alignment);
+        if (!m_current || offset + size > m_currentSize)
+        {
+            if (!m_buffer && size + alignment <= m_blockSize)
+            {
+                // 最初のブロックは reset() 後も手放さずに使い回す
+                m_buffer = static_cast<uint8_t *>(std::malloc(m_blockSize));
+                if (!m_buffer)
+                {
+                    throw std::bad_alloc();
+                }
+                m_bufferSize = m_blockSize;
+                m_ownsBuffer = true;
+                m_current = m_buffer;
+                m_currentSize = m_bufferSize;
+            }
+            else
+            {
+                size_t blockSize = std::max(m_blockSize, sizeof(Block) + size + alignment);
+                Block *block = static_cast<Block *>(std::malloc(blockSize));
+                if (!block)
+                {
+                    throw std::bad_alloc();
+                }
+                block->next = m_blocks;
+                block->size = blockSize;
+                m_blocks = block;
+                m_overflowBlocks++;
+                m_current = reinterpret_cast<uint8_t *>(block) + sizeof(Block);
+                m_currentSize = blockSize - sizeof(Block);
+            }
+            m_offset = 0;
+            offset = alignedOffset(m_current, 0, alignment);
+        }
+
+        m_used += offset - m_offset + size;
+        m_offset = offset + size;
+        return m_current + offset;
+    }
+
+    void Arena::reset()
+    {
+        freeBlocks();
+        m_current = m_buffer;
+        m_currentSize = m_bufferSize;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    void Arena::freeBlocks()
+    {
+        while (m_blocks)
+        {
+            Block *next = m_blocks->next;
+            std::free(m_blocks);
+            m_blocks = next;
+        }
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace canaspad
+{
+
+    // 1 回の送信で使う一時的なメモリを先頭から順に切り出すアロケータ
+    // 個別には解放せず、reset() でまとめて解放するため、長時間動かしてもヒープが断片化しない
+    class Arena
+    {
+    public:
+        // 呼び出し側が用意したバッファを使う。足りない分はヒープから blockSize 単位で追加する
+        Arena(void *buffer, size_t size, size_t blockSize = 1024);
+        // 最初のブロックも含めてヒープから blockSize 単位で確保する (reset() 後も最初のブロックは使い回す)
+        explicit Arena(size_t blockSize = 1024);
+        ~Arena();
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        // 切り出したすべての領域を無効にして先頭から使い直す
+        void reset();
+
+        // 切り出したバイト数 (アラインメントの詰め物を含む)
+        size_t used() const { return m_used; }
+        // 最初のバッファ (またはブロック) に収まらずヒープから追加したブロックの累計
+        size_t overflowBlocks() const { return m_overflowBlocks; }
+
+    private:
+        struct Block
+        {
+            Block *next;
+            size_t size;
+        };
+
+        uint8_t *m_buffer = nullptr; // 最初のバッファ (呼び出し側のもの、または所有するブロック)
+        size_t m_bufferSize = 0;
+        bool m_ownsBuffer = false;
+        Block *m_blocks = nullptr; // 追加したブロック (先頭が最新)
+        uint8_t *m_current = nullptr;
+        size_t m_currentSize = 0;
+        size_t m_offset = 0;
+        size_t m_blockSize;
+        size_t m_used = 0;
+        size_t m_overflowBlocks = 0;
+
+        void freeBlocks();
+    };
+
+    // 標準コンテナから Arena を使うためのアロケータ
+    // arena が nullptr の場合は通常のヒープを使う。コンテナのコピーは常にヒープへ作る
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() noexcept = default;
+        ArenaAllocator(Arena *arena) noexcept : m_arena(arena) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) noexcept : m_arena(other.arena()) {}
+
+        T *allocate(size_t n)
+        {
+            if (m_arena)
+            {
+                return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t) noexcept
+        {
+            // Arena から切り出した領域は reset() でまとめて解放する
+            if (!m_arena)
+            {
+                ::operator delete(p);
+            }
+        }
+
+        // 送信が終わって Arena が解放された後もコピーは使えるよう、ヒープへ複製する
+        ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+        Arena *arena() const noexcept { return m_arena; }
+
+    private:
+        Arena *m_arena = nullptr;
+    };
+
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept { return a.arena() == b.arena(); }
+
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept { return a.arena() != b.arena(); }
+
+} // namespace canaspad
\ No newline at end of file
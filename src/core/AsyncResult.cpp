@@ -0,0 +1,91 @@
+#include "AsyncResult.h"
+
+namespace canaspad
+{
+
+    AsyncResult AsyncResult::create()
+    {
+        AsyncResult asyncResult;
+        asyncResult.m_state = std::make_shared<State>();
+        return asyncResult;
+    }
+
+    AsyncResult AsyncResult::completed(Result<HttpResult> result)
+    {
+        AsyncResult asyncResult = create();
+        asyncResult.complete(std::move(result));
+        return asyncResult;
+    }
+
+    bool AsyncResult::ready() const
+    {
+        if (!m_state)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->ready;
+    }
+
+    void AsyncResult::wait() const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->done.wait(lock, [this]()
+                           { return m_state->ready; });
+    }
+
+    bool AsyncResult::waitFor(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        return m_state->done.wait_for(lock, timeout, [this]()
+                                      { return m_state->ready; });
+    }
+
+    const Result<HttpResult> &AsyncResult::get() const
+    {
+        wait();
+        // 結果は一度設定されると変更されないため、ロックの外で参照してよい
+        return *m_state->result;
+    }
+
+    void AsyncResult::then(Callback callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (!m_state->ready)
+            {
+                m_state->callbacks.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback(*m_state->result);
+    }
+
+    void AsyncResult::complete(Result<HttpResult> result)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->result.emplace(std::move(result));
+        }
+        // コールバックをすべて呼んでから完了とする (get() から戻った時点でコールバックは終わっている)
+        while (true)
+        {
+            std::vector<Callback> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                if (m_state->callbacks.empty())
+                {
+                    m_state->ready = true;
+                    break;
+                }
+                callbacks.swap(m_state->callbacks);
+            }
+            for (auto &callback : callbacks)
+            {
+                callback(*m_state->result);
+            }
+        }
+        m_state->done.notify_all();
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "HttpResult.h"
+#include "../Result.h"
+
+namespace canaspad
+{
+
+    // HttpClient::sendAsync と EventLoop::submit の結果。完了を待つか、完了時に呼ばれるコールバックを登録する
+    // コピーしたものは同じ結果を共有する
+    class AsyncResult
+    {
+    public:
+        using Callback = std::function<void(const Result<HttpResult> &)>;
+
+        // 結果を持たない (valid() が false の) 状態
+        AsyncResult() = default;
+
+        bool valid() const { return m_state != nullptr; }
+        bool ready() const;
+        void wait() const;
+        // timeout までに完了した場合は true
+        bool waitFor(std::chrono::milliseconds timeout) const;
+        // 完了まで待って結果を返す。結果はこの AsyncResult (またはそのコピー) がある間有効
+        const Result<HttpResult> &get() const;
+
+        // 完了時に呼ばれるコールバックを追加する。コールバックはワーカーのタスクで呼ばれる
+        // 既に完了している場合は、呼び出したタスクですぐに呼ぶ
+        void then(Callback callback);
+
+        // 完了済みの結果を作る (送信を始められなかった場合など)
+        static AsyncResult completed(Result<HttpResult> result);
+
+    private:
+        friend class HttpClient;
+        friend class EventLoop;
+
+        struct State
+        {
+            mutable std::mutex mutex;
+            mutable std::condition_variable done;
+            std::optional<Result<HttpResult>> result;
+            std::vector<Callback> callbacks;
+            bool ready = false; // 結果を設定し、コールバックを呼び終えた
+        };
+        std::shared_ptr<State> m_state;
+
+        static AsyncResult create();
+        // 結果を設定し、待っているタスクとコールバックに知らせる
+        void complete(Result<HttpResult> result);
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "BodySource.h"
+
+#include <algorithm>
+
+namespace canaspad
+{
+
+    size_t BodySource::pull(uint8_t *buf, size_t size)
+    {
+        size_t n = read(buf, size);
+        m_position += n;
+        return n;
+    }
+
+    bool BodySource::restart()
+    {
+        if (m_position == 0)
+        {
+            return true;
+        }
+        if (!rewind())
+        {
+            return false;
+        }
+        m_position = 0;
+        return true;
+    }
+
+    CallbackBodySource::CallbackBodySource(Reader reader)
+        : m_reader(std::move(reader)), m_length(0), m_hasLength(false)
+    {
+    }
+
+    CallbackBodySource::CallbackBodySource(Reader reader, size_t length)
+        : m_reader(std::move(reader)), m_length(length), m_hasLength(true)
+    {
+    }
+
+    bool CallbackBodySource::contentLength(size_t &length) const
+    {
+        if (m_hasLength)
+        {
+            length = m_length;
+        }
+        return m_hasLength;
+    }
+
+    size_t CallbackBodySource::read(uint8_t *buf, size_t size)
+    {
+        if (m_hasLength)
+        {
+            // 宣言した長さを超えて読み出さない
+            size = std::min(size, m_length - std::min(m_length, position()));
+            if (size == 0)
+            {
+                return 0;
+            }
+        }
+        return m_reader(buf, size);
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace canaspad
+{
+
+    // 送信時に少しずつ読み出すリクエスト本文
+    // 長さが分かる場合は Content-Length、分からない場合は Transfer-Encoding: chunked で送る
+    class BodySource
+    {
+    public:
+        virtual ~BodySource() = default;
+
+        // 本文全体の長さが分かっている場合は true を返し、length に設定する
+        virtual bool contentLength(size_t &length) const { return false; }
+
+        // 最大 size バイトを buf に読み込み、読み込んだバイト数を返す (0 は本文の終わり)
+        size_t pull(uint8_t *buf, size_t size);
+        // 本文を最初から送れる状態にする。読み始めていて巻き戻せない場合は false
+        bool restart();
+        // これまでに読み出したバイト数
+        size_t position() const { return m_position; }
+
+    protected:
+        virtual size_t read(uint8_t *buf, size_t size) = 0;
+        // リトライとリダイレクトで送り直すために先頭へ戻す。対応しない場合は false
+        virtual bool rewind() { return false; }
+
+    private:
+        size_t m_position = 0;
+    };
+
+    // コールバックから本文を読み出す (巻き戻しには対応しない)
+    class CallbackBodySource : public BodySource
+    {
+    public:
+        // buf に最大 size バイトを書き込み、書き込んだバイト数を返す。0 で終わり
+        using Reader = std::function<size_t(uint8_t *buf, size_t size)>;
+
+        // 長さ不明 (chunked で送る)
+        explicit CallbackBodySource(Reader reader);
+        // 長さが分かっている (Content-Length で送る)
+        CallbackBodySource(Reader reader, size_t length);
+
+        bool contentLength(size_t &length) const override;
+
+    protected:
+        size_t read(uint8_t *buf, size_t size) override;
+
+    private:
+        Reader m_reader;
+        size_t m_length;
+        bool m_hasLength;
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "BufferedConnection.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace canaspad
+{
+
+    BufferedConnection::BufferedConnection(std::shared_ptr<Connection> inner, size_t bufferSize)
+        : m_inner(std::move(inner)), m_buffer(std::max<size_t>(bufferSize, 64))
+    {
+    }
+
+    bool BufferedConnection::connect(const std::string &host, int port)
+    {
+        clear();
+        return m_inner->connect(host, port);
+    }
+
+    int BufferedConnection::nativeHandle() const
+    {
+        return m_inner->nativeHandle();
+    }
+
+    IoProgress BufferedConnection::beginConnect(const std::string &host, int port)
+    {
+        clear();
+        return m_inner->beginConnect(host, port);
+    }
+
+    IoProgress BufferedConnection::continueConnect()
+    {
+        return m_inner->continueConnect();
+    }
+
+    void BufferedConnection::disconnect()
+    {
+        clear();
+        m_inner->disconnect();
+    }
+
+    bool BufferedConnection::isConnected() const
+    {
+        return m_inner->isConnected();
+    }
+
+    size_t BufferedConnection::write(const uint8_t *buf, size_t size)
+    {
+        size_t written = m_inner->write(buf, size);
+        m_bytesWritten += written;
+        return written;
+    }
+
+    size_t BufferedConnection::writeSome(const uint8_t *buf, size_t size)
+    {
+        size_t written = m_inner->writeSome(buf, size);
+        m_bytesWritten += written;
+        return written;
+    }
+
+    size_t BufferedConnection::writev(const WriteSegment *segments, size_t count)
+    {
+        size_t written = m_inner->writev(segments, count);
+        m_bytesWritten += written;
+        return written;
+    }
+
+    int BufferedConnection::read(uint8_t *buf, size_t size)
+    {
+        if (buffered() == 0 && size >= m_buffer.size())
+        {
+            // バッファより大きい読み込みはコピーを挟まず直接読む
+            int count = m_inner->read(buf, size);
+            m_bytesRead += std::max(count, 0);
+            return count;
+        }
+        if (buffered() == 0 && fill() == 0)
+        {
+            return 0;
+        }
+
+        size_t count = std::min(size, buffered());
+        std::memcpy(buf, bufferedData(), count);
+        consume(count);
+        return static_cast<int>(count);
+    }
+
+    void BufferedConnection::setTimeouts(const std::chrono::milliseconds &connectTimeout,
+                                         const std::chrono::milliseconds &readTimeout,
+                                         const std::chrono::milliseconds &writeTimeout)
+    {
+        m_inner->setTimeouts(connectTimeout, readTimeout, writeTimeout);
+    }
+
+    std::string BufferedConnection::readLine()
+    {
+        std::string line;
+        char chunk[128];
+        bool found = false;
+        while (!found)
+        {
+            size_t count = readUntil('\n', chunk, sizeof(chunk), found);
+            line.append(chunk, count);
+            if (!found && count < sizeof(chunk))
+            {
+                break; // 受信データが尽きた
+            }
+        }
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        return line;
+    }
+
+    std::string BufferedConnection::read(size_t size)
+    {
+        std::string result;
+        result.resize(size);
+        size_t total = 0;
+        while (total < size)
+        {
+            int count = read(reinterpret_cast<uint8_t *>(&result[total]), size - total);
+            if (count <= 0)
+            {
+                break;
+            }
+            total += count;
+        }
+        result.resize(total);
+        return result;
+    }
+
+    void BufferedConnection::setVerifySsl(bool verify)
+    {
+        m_inner->setVerifySsl(verify);
+    }
+
+    void BufferedConnection::setCACert(const char *rootCA)
+    {
+        m_inner->setCACert(rootCA);
+    }
+
+    void BufferedConnection::setClientCert(const char *cert)
+    {
+        m_inner->setClientCert(cert);
+    }
+
+    void BufferedConnection::setClientPrivateKey(const char *privateKey)
+    {
+        m_inner->setClientPrivateKey(privateKey);
+    }
+
+    bool BufferedConnection::connected() const
+    {
+        // 切断後もバッファに残ったデータは読み出せる
+        return buffered() > 0 || m_inner->connected();
+    }
+
+    int BufferedConnection::available()
+    {
+        return static_cast<int>(buffered()) + std::max(m_inner->available(), 0);
+    }
+
+    int BufferedConnection::read()
+    {
+        int value = peek();
+        if (value >= 0)
+        {
+            consume(1);
+        }
+        return value;
+    }
+
+    int BufferedConnection::setTimeout(uint32_t seconds)
+    {
+        return m_inner->setTimeout(seconds);
+    }
+
+    bool BufferedConnection::setTlsSession(const std::vector<uint8_t> &session)
+    {
+        return m_inner->setTlsSession(session);
+    }
+
+    bool BufferedConnection::getTlsSession(std::vector<uint8_t> &session) const
+    {
+        return m_inner->getTlsSession(session);
+    }
+
+    bool BufferedConnection::isTlsSessionResumed() const
+    {
+        return m_inner->isTlsSessionResumed();
+    }
+
+    bool BufferedConnection::setResolvedAddress(uint32_t address)
+    {
+        return m_inner->setResolvedAddress(address);
+    }
+
+    bool BufferedConnection::getResolvedAddress(uint32_t &address) const
+    {
+        return m_inner->getResolvedAddress(address);
+    }
+
+    bool BufferedConnection::getConnectTiming(ConnectTiming &timing) const
+    {
+        return m_inner->getConnectTiming(timing);
+    }
+
+    ReadReadiness BufferedConnection::waitForData(std::chrono::steady_clock::time_point deadline)
+    {
+        if (buffered() > 0)
+        {
+            return ReadReadiness::Ready;
+        }
+        return m_inner->waitForData(deadline);
+    }
+
+    int BufferedConnection::peek()
+    {
+        if (buffered() == 0 && fill() == 0)
+        {
+            return -1;
+        }
+        return m_buffer[m_start];
+    }
+
+    size_t BufferedConnection::readUntil(char delimiter, char *out, size_t capacity, bool &found)
+    {
+        found = false;
+        size_t written = 0;
+        while (written < capacity)
+        {
+            if (buffered() == 0 && fill() == 0)
+            {
+                break;
+            }
+
+            size_t count = std::min(buffered(), capacity - written);
+            const uint8_t *begin = bufferedData();
+            const uint8_t *hit = static_cast<const uint8_t *>(std::memchr(begin, delimiter, count));
+            if (hit)
+            {
+                count = hit - begin;
+            }
+            std::memcpy(out + written, begin, count);
+            written += count;
+            consume(count);
+
+            if (hit)
+            {
+                consume(1);
+                found = true;
+                break;
+            }
+        }
+
+        if (!found && written == capacity && peek() == static_cast<uint8_t>(delimiter))
+        {
+            // ちょうど区切り文字の直前で一杯になった場合
+            consume(1);
+            found = true;
+        }
+        return written;
+    }
+
+    void BufferedConnection::consume(size_t size)
+    {
+        m_start += std::min(size, buffered());
+        if (m_start == m_end)
+        {
+            m_start = m_end = 0;
+        }
+    }
+
+    size_t BufferedConnection::fill()
+    {
+        if (m_start > 0 && m_end == m_buffer.size())
+        {
+            // 末尾に空きがない場合は未読部分を先頭へ詰める
+            std::memmove(m_buffer.data(), bufferedData(), buffered());
+            m_end -= m_start;
+            m_start = 0;
+        }
+        if (m_end == m_buffer.size() || m_inner->available() <= 0)
+        {
+            return 0;
+        }
+
+        int count = m_inner->read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+        if (count <= 0)
+        {
+            return 0;
+        }
+        m_end += count;
+        m_bytesRead += count;
+        return static_cast<size_t>(count);
+    }
+
+    void BufferedConnection::clear()
+    {
+        m_start = m_end = 0;
+    }
+
+} // namespace canaspad
\ No newline at end of file
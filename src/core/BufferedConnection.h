@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Connection.h"
+
+#include <memory>
+#include <vector>
+
+namespace canaspad
+{
+
+    // 任意の Connection を包み、受信をまとめて読み込むデコレータ
+    // 1 バイトずつの読み込みを避け、行単位・区切り文字単位の読み込みもバッファ上で行う
+    class BufferedConnection : public Connection
+    {
+    public:
+        explicit BufferedConnection(std::shared_ptr<Connection> inner, size_t bufferSize = 2048);
+
+        bool connect(const std::string &host, int port) override;
+        int nativeHandle() const override;
+        IoProgress beginConnect(const std::string &host, int port) override;
+        IoProgress continueConnect() override;
+        void disconnect() override;
+        bool isConnected() const override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        size_t writev(const WriteSegment *segments, size_t count) override;
+        size_t writeSome(const uint8_t *buf, size_t size) override;
+        int read(uint8_t *buf, size_t size) override;
+        void setTimeouts(const std::chrono::milliseconds &connectTimeout,
+                         const std::chrono::milliseconds &readTimeout,
+                         const std::chrono::milliseconds &writeTimeout) override;
+        // 改行 (\n または \r\n) を取り除いた 1 行を返す
+        std::string readLine() override;
+        std::string read(size_t size) override;
+        void setVerifySsl(bool verify) override;
+        void setCACert(const char *rootCA) override;
+        void setClientCert(const char *cert) override;
+        void setClientPrivateKey(const char *privateKey) override;
+        bool connected() const override;
+        int available() override;
+        int read() override;
+        int setTimeout(uint32_t seconds) override;
+
+        bool setTlsSession(const std::vector<uint8_t> &session) override;
+        bool getTlsSession(std::vector<uint8_t> &session) const override;
+        bool isTlsSessionResumed() const override;
+        bool setResolvedAddress(uint32_t address) override;
+        bool getResolvedAddress(uint32_t &address) const override;
+        bool getConnectTiming(ConnectTiming &timing) const override;
+        ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline) override;
+
+        // 次の 1 バイトを消費せずに返す (受信データがない場合は -1)
+        int peek();
+        // delimiter の直前までを out に書き込み、書き込んだバイト数を返す
+        // delimiter は消費するが out には含めない。見つかったかどうかを found に返す
+        // 区切り文字より前に out が一杯になった場合や受信データが尽きた場合は found が false のまま戻る
+        size_t readUntil(char delimiter, char *out, size_t capacity, bool &found);
+
+        // バッファ上のデータを直接参照する (パーサへのコピーなしの受け渡し用)
+        const uint8_t *bufferedData() const { return m_buffer.data() + m_start; }
+        size_t buffered() const { return m_end - m_start; }
+        void consume(size_t size);
+        // 下位の接続から読めるだけ読み込み、追加したバイト数を返す
+        size_t fill();
+
+        size_t capacity() const { return m_buffer.size(); }
+        Connection *inner() const { return m_inner.get(); }
+
+        // 下位の接続との間で送受信した累計バイト数
+        size_t bytesWritten() const { return m_bytesWritten; }
+        size_t bytesRead() const { return m_bytesRead; }
+
+    private:
+        std::shared_ptr<Connection> m_inner;
+        std::vector<uint8_t> m_buffer;
+        size_t m_start = 0;
+        size_t m_end = 0;
+        size_t m_bytesWritten = 0;
+        size_t m_bytesRead = 0;
+
+        void clear();
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "CancellationToken.h"
+
+namespace canaspad
+{
+
+    void CancellationRegistry::Registration::reset()
+    {
+        if (m_registry)
+        {
+            m_registry->remove(m_id, m_token);
+            m_registry = nullptr;
+        }
+    }
+
+    CancellationRegistry::Registration CancellationRegistry::add(const std::string &id, const CancellationToken &token)
+    {
+        Registration registration;
+        if (id.empty() || !token.valid())
+        {
+            return registration;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tokens.emplace(id, token);
+        }
+        registration.m_registry = this;
+        registration.m_id = id;
+        registration.m_token = token;
+        return registration;
+    }
+
+    bool CancellationRegistry::cancel(const std::string &id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto range = m_tokens.equal_range(id);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            it->second.cancel();
+        }
+        return range.first != range.second;
+    }
+
+    size_t CancellationRegistry::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tokens.size();
+    }
+
+    void CancellationRegistry::remove(const std::string &id, const CancellationToken &token)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto range = m_tokens.equal_range(id);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            // 同じ ID の別の送信 (sendAsync と、その中の send など) の登録は残す
+            if (it->second == token)
+            {
+                m_tokens.erase(it);
+                return;
+            }
+        }
+    }
+
+} // namespace canaspad
\ No newline at end of file
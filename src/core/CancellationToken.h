@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace canaspad
+{
+
+    // 送信を途中で取り消すための共有フラグ。コピーしたものは同じフラグを指す
+    // 既定で構築したトークンはフラグを持たず、取り消せない (送信中の確認も行わない)
+    // 親を指定して作ったトークンは、親が取り消された場合も取り消されたものとして扱う
+    class CancellationToken
+    {
+    public:
+        // 取り消しを確かめる間隔 (接続の確立、受信待ち、リトライ前の待ち時間をこの間隔で区切る)
+        static constexpr std::chrono::milliseconds kCheckInterval{10};
+
+        CancellationToken() = default;
+
+        static CancellationToken create() { return CancellationToken(std::make_shared<State>()); }
+        // 自身の取り消しは parent に伝わらない
+        static CancellationToken create(const CancellationToken &parent)
+        {
+            auto state = std::make_shared<State>();
+            state->parent = parent.m_state;
+            return CancellationToken(std::move(state));
+        }
+
+        bool valid() const { return m_state != nullptr; }
+        // 取り消しを要求する。どのタスクからも呼べる。一度取り消したトークンは元に戻らない
+        void cancel() const
+        {
+            if (m_state)
+            {
+                m_state->cancelled.store(true, std::memory_order_release);
+            }
+        }
+        bool cancelled() const
+        {
+            for (const State *state = m_state.get(); state; state = state->parent.get())
+            {
+                if (state->cancelled.load(std::memory_order_acquire))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool operator==(const CancellationToken &other) const { return m_state == other.m_state; }
+        bool operator!=(const CancellationToken &other) const { return !(*this == other); }
+
+    private:
+        struct State
+        {
+            std::atomic<bool> cancelled{false};
+            std::shared_ptr<State> parent;
+        };
+
+        std::shared_ptr<State> m_state;
+
+        explicit CancellationToken(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+    };
+
+    // HttpClient::cancel(requestId) で取り消せるよう、送信中のリクエストの ID とトークンを覚えておく
+    class CancellationRegistry
+    {
+    public:
+        // 登録を保持している間だけ ID で取り消せる。破棄すると登録を外す
+        class Registration
+        {
+        public:
+            Registration() = default;
+            ~Registration() { reset(); }
+            Registration(Registration &&other) noexcept
+                : m_registry(other.m_registry), m_id(std::move(other.m_id)), m_token(std::move(other.m_token))
+            {
+                other.m_registry = nullptr;
+            }
+            Registration &operator=(Registration &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    m_registry = other.m_registry;
+                    m_id = std::move(other.m_id);
+                    m_token = std::move(other.m_token);
+                    other.m_registry = nullptr;
+                }
+                return *this;
+            }
+            Registration(const Registration &) = delete;
+            Registration &operator=(const Registration &) = delete;
+
+            void reset();
+
+        private:
+            friend class CancellationRegistry;
+
+            CancellationRegistry *m_registry = nullptr;
+            std::string m_id;
+            CancellationToken m_token;
+        };
+
+        // ID が空、またはトークンを持たない場合は何も登録しない
+        Registration add(const std::string &id, const CancellationToken &token);
+        // id で登録されているすべての送信を取り消す。見つからなければ false
+        bool cancel(const std::string &id);
+        // 登録されている送信の数
+        size_t size() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_multimap<std::string, CancellationToken> m_tokens;
+
+        void remove(const std::string &id, const CancellationToken &token);
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,433 @@
+#include "ClientMetrics.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "HeaderMap.h"
+
+namespace canaspad
+{
+
+    namespace
+    {
+        void appendUint(std::string &out, uint64_t value)
+        {
+            char buffer[24];
+            int length = snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+            out.append(buffer, length);
+        }
+
+        void appendField(std::string &out, const char *name, uint64_t value)
+        {
+            out += '"';
+            out += name;
+            out += "\":";
+            appendUint(out, value);
+            out += ',';
+        }
+
+        void appendJsonString(std::string &out, std::string_view value)
+        {
+            out += '"';
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out += '\\';
+                    out += c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+            out += '"';
+        }
+
+        // 末尾の ',' を閉じ括弧に置き換える (空の場合は閉じ括弧を足す)
+        void closeObject(std::string &out, char close)
+        {
+            if (out.back() == ',')
+            {
+                out.back() = close;
+            }
+            else
+            {
+                out += close;
+            }
+        }
+
+        void appendHistogram(std::string &out, const HistogramSnapshot &histogram)
+        {
+            out += '{';
+            appendField(out, "count", histogram.count);
+            appendField(out, "sum", histogram.sumMs);
+            appendField(out, "max", histogram.maxMs);
+            appendField(out, "p50", histogram.percentile(0.5));
+            appendField(out, "p90", histogram.percentile(0.9));
+            appendField(out, "p99", histogram.percentile(0.99));
+            // 末尾の 0 の区間は省略する
+            size_t used = histogram.counts.size();
+            while (used > 0 && histogram.counts[used - 1] == 0)
+            {
+                --used;
+            }
+            out += "\"buckets\":[";
+            for (size_t i = 0; i < used; ++i)
+            {
+                appendUint(out, histogram.counts[i]);
+                out += ',';
+            }
+            closeObject(out, ']');
+            out += '}';
+        }
+
+        void storeMax(std::atomic<uint32_t> &target, uint32_t value)
+        {
+            uint32_t current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
+    constexpr std::array<uint32_t, HistogramSnapshot::kBucketCount - 1> HistogramSnapshot::kBucketBounds;
+
+    uint32_t HistogramSnapshot::percentile(double p) const
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        p = std::min(std::max(p, 0.0), 1.0);
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * count)));
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] == 0 || cumulative + counts[i] < rank)
+            {
+                cumulative += counts[i];
+                continue;
+            }
+            if (i == counts.size() - 1)
+            {
+                // 上限のない区間は最大値で代表する
+                return maxMs;
+            }
+            uint32_t lower = i == 0 ? 0 : kBucketBounds[i - 1];
+            uint32_t upper = std::min(kBucketBounds[i], std::max(maxMs, lower));
+            double fraction = static_cast<double>(rank - cumulative) / counts[i];
+            return lower + static_cast<uint32_t>(std::lround((upper - lower) * fraction));
+        }
+        return maxMs;
+    }
+
+    void HistogramSnapshot::merge(const HistogramSnapshot &other)
+    {
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        sumMs += other.sumMs;
+        maxMs = std::max(maxMs, other.maxMs);
+    }
+
+    size_t LatencyHistogram::bucketIndex(uint32_t ms)
+    {
+        const auto &bounds = HistogramSnapshot::kBucketBounds;
+        return std::lower_bound(bounds.begin(), bounds.end(), ms) - bounds.begin();
+    }
+
+    void LatencyHistogram::record(std::chrono::microseconds latency)
+    {
+        // 1 ミリ秒未満は切り上げて最初の区間に入れる
+        uint64_t us = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+        uint32_t ms = static_cast<uint32_t>(std::min<uint64_t>((us + 999) / 1000, UINT32_MAX));
+        m_counts[bucketIndex(ms)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumMs.fetch_add(ms, std::memory_order_relaxed);
+        storeMax(m_maxMs, ms);
+    }
+
+    HistogramSnapshot LatencyHistogram::snapshot() const
+    {
+        HistogramSnapshot snapshot;
+        for (size_t i = 0; i < m_counts.size(); ++i)
+        {
+            snapshot.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count = m_count.load(std::memory_order_relaxed);
+        snapshot.sumMs = m_sumMs.load(std::memory_order_relaxed);
+        snapshot.maxMs = m_maxMs.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for (auto &count : m_counts)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumMs.store(0, std::memory_order_relaxed);
+        m_maxMs.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t MetricsSnapshot::errorCount() const
+    {
+        uint32_t total = 0;
+        for (uint32_t count : errors)
+        {
+            total += count;
+        }
+        return total;
+    }
+
+    double MetricsSnapshot::poolHitRate() const
+    {
+        size_t total = poolHits + poolMisses;
+        return total == 0 ? 0.0 : static_cast<double>(poolHits) / total;
+    }
+
+    const char *MetricsSnapshot::errorCodeName(ErrorCode code)
+    {
+        static const char *const names[kErrorCodeCount] = {
+            "None", "NetworkError", "Timeout", "SSLError", "InvalidResponse", "TooManyRedirects",
+            "UnsupportedProtocol", "InvalidURL", "RequestCancelled", "TimeNotSet", "UnsupportedOperation",
+            "ProxyAuthenticationRequired", "MissingHeader", "InvalidHeader", "DuplicateHeader", "InvalidBody",
+            "InvalidOption", "InvalidProxyURL", "InvalidSnapshot", "QueueFull"};
+        size_t index = static_cast<size_t>(code);
+        return index < kErrorCodeCount ? names[index] : "Unknown";
+    }
+
+    std::string MetricsSnapshot::toJson() const
+    {
+        std::string out;
+        out.reserve(512 + endpoints.size() * 192);
+        out += '{';
+        appendField(out, "requests", requests);
+
+        out += "\"status\":{";
+        for (size_t i = 0; i < statusClasses.size(); ++i)
+        {
+            if (statusClasses[i] != 0)
+            {
+                char name[4] = {static_cast<char>('1' + i), 'x', 'x', '\0'};
+                appendField(out, name, statusClasses[i]);
+            }
+        }
+        closeObject(out, '}');
+        out += ',';
+
+        // 発生したエラーのみ出力する
+        out += "\"errors\":{";
+        for (size_t i = 0; i < errors.size(); ++i)
+        {
+            if (errors[i] != 0)
+            {
+                appendField(out, errorCodeName(static_cast<ErrorCode>(i)), errors[i]);
+            }
+        }
+        closeObject(out, '}');
+        out += ',';
+
+        appendField(out, "retries", retries);
+        appendField(out, "redirects", redirects);
+        appendField(out, "reused", reusedConnections);
+        appendField(out, "bytesOut", bytesSent);
+        appendField(out, "bytesIn", bytesReceived);
+        appendField(out, "poolHits", poolHits);
+        appendField(out, "poolMisses", poolMisses);
+        appendField(out, "fullHandshakes", fullHandshakes);
+        appendField(out, "resumedHandshakes", resumedHandshakes);
+
+        out += "\"bounds\":[";
+        for (uint32_t bound : HistogramSnapshot::kBucketBounds)
+        {
+            appendUint(out, bound);
+            out += ',';
+        }
+        closeObject(out, ']');
+        out += ",\"latency\":";
+        appendHistogram(out, latency);
+
+        out += ",\"endpoints\":{";
+        for (const auto &endpoint : endpoints)
+        {
+            appendJsonString(out, endpoint.host);
+            out += ":{";
+            appendField(out, "requests", endpoint.requests);
+            appendField(out, "errors", endpoint.errors);
+            out += "\"latency\":";
+            appendHistogram(out, endpoint.latency);
+            out += "},";
+        }
+        closeObject(out, '}');
+        out += '}';
+        return out;
+    }
+
+    ClientMetrics::ClientMetrics()
+    {
+        auto &other = m_endpoints[kMaxEndpoints];
+        other.host[0] = '*';
+        other.hash.store(headerNameHash("*") | 1, std::memory_order_release);
+    }
+
+    ClientMetrics::EndpointSlot &ClientMetrics::endpoint(std::string_view host)
+    {
+        host = host.substr(0, kMaxHostLength);
+        // ホスト名は大文字小文字を区別しない。0 は未使用の印のため最下位ビットを立てる
+        uint32_t hash = headerNameHash(host) | 1;
+        auto find = [&]() -> EndpointSlot *
+        {
+            for (size_t i = 0; i < kMaxEndpoints; ++i)
+            {
+                auto &slot = m_endpoints[i];
+                uint32_t slotHash = slot.hash.load(std::memory_order_acquire);
+                if (slotHash == 0)
+                {
+                    // 登録は前から順に行うため、以降は未使用
+                    return nullptr;
+                }
+                if (slotHash == hash && HeaderMap::equalsIgnoreCase(slot.host, host))
+                {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        };
+
+        if (auto *slot = find())
+        {
+            return *slot;
+        }
+
+        std::lock_guard<std::mutex> lock(m_registerMutex);
+        if (auto *slot = find())
+        {
+            return *slot;
+        }
+        for (size_t i = 0; i < kMaxEndpoints; ++i)
+        {
+            auto &slot = m_endpoints[i];
+            if (slot.hash.load(std::memory_order_relaxed) == 0)
+            {
+                std::memcpy(slot.host, host.data(), host.size());
+                slot.host[host.size()] = '\0';
+                slot.hash.store(hash, std::memory_order_release);
+                return slot;
+            }
+        }
+        return m_endpoints[kMaxEndpoints];
+    }
+
+    void ClientMetrics::record(std::string_view host, int statusCode, ErrorCode error, const RequestTiming &timing)
+    {
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        if (statusCode >= 100 && statusCode < 600)
+        {
+            m_statusClasses[statusCode / 100 - 1].fetch_add(1, std::memory_order_relaxed);
+        }
+        bool failed = error != ErrorCode::None;
+        if (failed && static_cast<size_t>(error) < m_errors.size())
+        {
+            m_errors[static_cast<size_t>(error)].fetch_add(1, std::memory_order_relaxed);
+        }
+        m_retries.fetch_add(timing.retries, std::memory_order_relaxed);
+        m_redirects.fetch_add(timing.redirects, std::memory_order_relaxed);
+        if (timing.connectionReused)
+        {
+            m_reusedConnections.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto latency = timing.total();
+        m_latency.record(latency);
+
+        auto &slot = endpoint(host);
+        slot.requests.fetch_add(1, std::memory_order_relaxed);
+        if (failed)
+        {
+            slot.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot.latency.record(latency);
+    }
+
+    void ClientMetrics::addBytes(size_t sent, size_t received)
+    {
+        m_bytesSent.fetch_add(sent, std::memory_order_relaxed);
+        m_bytesReceived.fetch_add(received, std::memory_order_relaxed);
+    }
+
+    MetricsSnapshot ClientMetrics::snapshot() const
+    {
+        MetricsSnapshot snapshot;
+        snapshot.requests = m_requests.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < m_statusClasses.size(); ++i)
+        {
+            snapshot.statusClasses[i] = m_statusClasses[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < m_errors.size(); ++i)
+        {
+            snapshot.errors[i] = m_errors[i].load(std::memory_order_relaxed);
+        }
+        snapshot.retries = m_retries.load(std::memory_order_relaxed);
+        snapshot.redirects = m_redirects.load(std::memory_order_relaxed);
+        snapshot.reusedConnections = m_reusedConnections.load(std::memory_order_relaxed);
+        snapshot.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+        snapshot.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+        snapshot.latency = m_latency.snapshot();
+
+        for (const auto &slot : m_endpoints)
+        {
+            if (slot.hash.load(std::memory_order_acquire) == 0 || slot.requests.load(std::memory_order_relaxed) == 0)
+            {
+                continue;
+            }
+            MetricsSnapshot::Endpoint endpoint;
+            endpoint.host = slot.host;
+            endpoint.requests = slot.requests.load(std::memory_order_relaxed);
+            endpoint.errors = slot.errors.load(std::memory_order_relaxed);
+            endpoint.latency = slot.latency.snapshot();
+            snapshot.endpoints.push_back(std::move(endpoint));
+        }
+        return snapshot;
+    }
+
+    void ClientMetrics::reset()
+    {
+        // 登録済みのホストは残し、値だけを消す
+        m_requests.store(0, std::memory_order_relaxed);
+        for (auto &count : m_statusClasses)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        for (auto &count : m_errors)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        m_retries.store(0, std::memory_order_relaxed);
+        m_redirects.store(0, std::memory_order_relaxed);
+        m_reusedConnections.store(0, std::memory_order_relaxed);
+        m_bytesSent.store(0, std::memory_order_relaxed);
+        m_bytesReceived.store(0, std::memory_order_relaxed);
+        m_latency.reset();
+        for (auto &slot : m_endpoints)
+        {
+            slot.requests.store(0, std::memory_order_relaxed);
+            slot.errors.store(0, std::memory_order_relaxed);
+            slot.latency.reset();
+        }
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Result.h"
+#include "RequestTiming.h"
+
+namespace canaspad
+{
+
+    // 固定区間のヒストグラムのスナップショット
+    struct HistogramSnapshot
+    {
+        static constexpr size_t kBucketCount = 25;
+        // 各区間の上限 (ミリ秒、以下を含む)。最後の区間は上限なし
+        static constexpr std::array<uint32_t, kBucketCount - 1> kBucketBounds{
+            1, 2, 3, 5, 7, 10, 15, 20, 30, 50, 70, 100, 150, 200, 300, 500, 700, 1000, 1500, 2000, 3000, 5000, 10000, 30000};
+
+        std::array<uint32_t, kBucketCount> counts{};
+        uint32_t count = 0;
+        uint64_t sumMs = 0;
+        uint32_t maxMs = 0;
+
+        // p (0.0 - 1.0) パーセンタイルの推定値 (ミリ秒)。区間内は線形に補間する
+        uint32_t percentile(double p) const;
+        uint32_t meanMs() const { return count == 0 ? 0 : static_cast<uint32_t>(sumMs / count); }
+        // 別の端末などのヒストグラムを足し合わせる
+        void merge(const HistogramSnapshot &other);
+    };
+
+    // 送信ごとに記録するレイテンシのヒストグラム
+    // 記録は区間のカウンタを加算するだけで、ロックもヒープ確保も行わない
+    class LatencyHistogram
+    {
+    public:
+        void record(std::chrono::microseconds latency);
+        HistogramSnapshot snapshot() const;
+        void reset();
+
+        static size_t bucketIndex(uint32_t ms);
+
+    private:
+        std::array<std::atomic<uint32_t>, HistogramSnapshot::kBucketCount> m_counts{};
+        std::atomic<uint32_t> m_count{0};
+        std::atomic<uint64_t> m_sumMs{0};
+        std::atomic<uint32_t> m_maxMs{0};
+    };
+
+    // HttpClient 全体の集計値のスナップショット
+    struct MetricsSnapshot
+    {
+        static constexpr size_t kErrorCodeCount = static_cast<size_t>(ErrorCode::QueueFull) + 1;
+
+        struct Endpoint
+        {
+            std::string host;
+            uint32_t requests = 0;
+            uint32_t errors = 0;
+            HistogramSnapshot latency;
+        };
+
+        uint32_t requests = 0;
+        std::array<uint32_t, 5> statusClasses{}; // 1xx - 5xx
+        std::array<uint32_t, kErrorCodeCount> errors{};
+        uint32_t retries = 0;
+        uint32_t redirects = 0;
+        uint32_t reusedConnections = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        HistogramSnapshot latency;
+        std::vector<Endpoint> endpoints;
+
+        // 接続プールと TLS セッションキャッシュから取り込む値
+        size_t poolHits = 0;
+        size_t poolMisses = 0;
+        size_t fullHandshakes = 0;
+        size_t resumedHandshakes = 0;
+
+        uint32_t errorCount() const;
+        double poolHitRate() const;
+        // アップロード用の 1 行の JSON
+        // ヒストグラムは区間ごとの件数も含めるため、集計側で複数の端末を足し合わせてからパーセンタイルを求められる
+        std::string toJson() const;
+
+        static const char *errorCodeName(ErrorCode code);
+    };
+
+    // HttpClient ごとの集計
+    // 送信の記録はアトミックな加算のみで行い、ホストの登録 (初回のみ) だけロックを取る
+    class ClientMetrics
+    {
+    public:
+        // ホストごとに集計する上限。超えたホストはまとめて "*" に集計する
+        static constexpr size_t kMaxEndpoints = 8;
+        static constexpr size_t kMaxHostLength = 63;
+
+        ClientMetrics();
+
+        // 送信 1 回 (リトライ・リダイレクトを含む) の結果を記録する。statusCode はエラーの場合 0
+        void record(std::string_view host, int statusCode, ErrorCode error, const RequestTiming &timing);
+        void addBytes(size_t sent, size_t received);
+
+        MetricsSnapshot snapshot() const;
+        void reset();
+
+    private:
+        struct EndpointSlot
+        {
+            std::atomic<uint32_t> hash{0}; // 0 は未使用。host を書き終えてから設定する
+            char host[kMaxHostLength + 1] = {};
+            std::atomic<uint32_t> requests{0};
+            std::atomic<uint32_t> errors{0};
+            LatencyHistogram latency;
+        };
+
+        std::atomic<uint32_t> m_requests{0};
+        std::array<std::atomic<uint32_t>, 5> m_statusClasses{};
+        std::array<std::atomic<uint32_t>, MetricsSnapshot::kErrorCodeCount> m_errors{};
+        std::atomic<uint32_t> m_retries{0};
+        std::atomic<uint32_t> m_redirects{0};
+        std::atomic<uint32_t> m_reusedConnections{0};
+        std::atomic<uint64_t> m_bytesSent{0};
+        std::atomic<uint64_t> m_bytesReceived{0};
+        LatencyHistogram m_latency;
+
+        // 末尾の 1 つは上限を超えたホストの集計用
+        std::array<EndpointSlot, kMaxEndpoints + 1> m_endpoints;
+        std::mutex m_registerMutex;
+
+        EndpointSlot &endpoint(std::string_view host);
+    };
+
+} // namespace canaspad
\ No newline at end of file
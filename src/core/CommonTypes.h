@@ -12,6 +12,8 @@
 
 namespace canaspad
 {
+    class Connection;
+
     enum class AuthType
     {
         None,
@@ -35,5 +37,20 @@ namespace canaspad
         std::string rootCA;
         std::string clientCert;
         std::string clientPrivateKey;
+        size_t maxConnections = 4;                                           // プール全体の最大接続数 (TLS 接続は 1 本あたり数十KBのヒープを使用する)
+        size_t maxIdleConnectionsPerHost = 2;                                // host:port ごとに保持するアイドル接続数
+        std::chrono::milliseconds connectionIdleTimeout = std::chrono::seconds(60); // アイドル接続を保持する時間
+        size_t tlsSessionCacheSize = 4;                                      // 保持する TLS セッション数 (0 で無効)
+        std::chrono::milliseconds tlsSessionLifetime = std::chrono::hours(1); // TLS セッションを再利用する期間
+        size_t dnsCacheSize = 8;                                             // 保持する名前解決結果の数 (0 で無効)
+        std::chrono::milliseconds dnsCacheTtl = std::chrono::minutes(5);     // 名前解決結果を再利用する期間
+        size_t readBufferSize = 2048;                                        // 接続ごとの受信バッファサイズ
+        size_t uploadChunkSize = 1024;                                       // BodySource から一度に読み出して送るサイズ
+        std::function<std::shared_ptr<Connection>(const std::string &scheme)> connectionFactory; // scheme ごとの接続の生成方法 (未指定の場合はプラットフォームの既定の接続)
+        size_t asyncWorkers = 1;                                             // sendAsync を実行するワーカー数 (最初の sendAsync で起動する)
+        size_t asyncQueueSize = 8;                                           // 実行待ちにできる sendAsync の数
+        size_t asyncWorkerStackSize = 8192;                                  // ワーカーのタスクのスタックサイズ (実機のみ、TLS のハンドシェイクに足りる大きさにする)
+        int asyncWorkerPriority = 1;                                         // ワーカーのタスクの優先度 (実機のみ)
+        int asyncWorkerCore = -1;                                            // ワーカーのタスクを固定するコア (-1 で固定しない、実機のみ)
     };
 }
\ No newline at end of file
@@ -3,10 +3,39 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "RequestTiming.h"
 
 namespace canaspad
 {
 
+    // waitForData の結果
+    enum class ReadReadiness
+    {
+        Ready,   // 読み込めるデータがある
+        Closed,  // 相手が接続を閉じ、これ以上データは届かない
+        TimedOut // 期限までにデータが届かなかった
+    };
+
+    // 止まらずに進める操作 (接続の確立) の結果
+    enum class IoProgress
+    {
+        Done,      // 完了した
+        WantRead,  // 記述子が読み込み可能になったら続きを進める
+        WantWrite, // 記述子が書き込み可能になったら続きを進める
+        Failed
+    };
+
+    // writev で書き込む断片
+    struct WriteSegment
+    {
+        const uint8_t *data;
+        size_t size;
+    };
+
     class Connection
     {
     public:
@@ -30,6 +59,111 @@ namespace canaspad
         virtual int available() = 0;
         virtual int read() = 0;
         virtual int setTimeout(uint32_t seconds) = 0;
+
+        // TLS セッション再開 (対応していない接続では何もしない)
+        // setTlsSession は次回の connect で提示するセッションを設定する
+        virtual bool setTlsSession(const std::vector<uint8_t> &session) { return false; }
+        // 直近のハンドシェイクで確立したセッションを取り出す
+        virtual bool getTlsSession(std::vector<uint8_t> &session) const { return false; }
+        // 直近のハンドシェイクがセッション再開で完了したか
+        virtual bool isTlsSessionResumed() const { return false; }
+
+        // 名前解決の省略 (0 は未解決)
+        // setResolvedAddress は次回の connect で名前解決の代わりに使う IPv4 アドレスを設定する
+        virtual bool setResolvedAddress(uint32_t address) { return false; }
+        // 直近の接続で使用した IPv4 アドレスを取り出す
+        virtual bool getResolvedAddress(uint32_t &address) const { return false; }
+
+        // 直近の connect の各段階の時刻 (計測しない接続では false)
+        virtual bool getConnectTiming(ConnectTiming &timing) const { return false; }
+
+        // select / poll で待つためのソケットの記述子 (持たない接続では -1)
+        virtual int nativeHandle() const { return -1; }
+
+        // 接続を始める。完了を待たずに戻れる実装は WantRead / WantWrite を返し、
+        // 記述子がその状態になったら continueConnect で続きを進める
+        // 既定の実装は connect を呼び、完了 (TLS ではハンドシェイクまで) するまで戻らない
+        virtual IoProgress beginConnect(const std::string &host, int port)
+        {
+            return connect(host, port) ? IoProgress::Done : IoProgress::Failed;
+        }
+        virtual IoProgress continueConnect() { return IoProgress::Failed; }
+
+        // 止まらずに書き込めるだけ書き込み、書き込めたバイト数を返す (送信バッファが一杯の場合は 0)
+        // 続きは書き込めなかった部分をそのまま渡す (TLS の再試行は同じ内容で行う必要がある)
+        // 既定の実装は write を呼ぶため、送信バッファが空くまで止まる場合がある
+        virtual size_t writeSome(const uint8_t *buf, size_t size) { return write(buf, size); }
+
+        // 小さな断片をまとめる上限 (まとめた断片は 1 回の write、TLS では 1 レコードで送る)
+        static constexpr size_t kWriteCoalesceSize = 512;
+
+        // 複数の断片を順に書き込み、書き込めたバイト数の合計を返す
+        // 小さな断片はまとめて書き込み、大きな断片はコピーせずそのまま write に渡す
+        virtual size_t writev(const WriteSegment *segments, size_t count)
+        {
+            uint8_t staging[kWriteCoalesceSize];
+            size_t staged = 0;
+            size_t written = 0;
+            for (size_t i = 0; i <= count; ++i)
+            {
+                bool last = i == count;
+                if (!last && staged + segments[i].size <= kWriteCoalesceSize)
+                {
+                    std::memcpy(staging + staged, segments[i].data, segments[i].size);
+                    staged += segments[i].size;
+                    continue;
+                }
+                if (staged > 0)
+                {
+                    size_t n = write(staging, staged);
+                    written += n;
+                    if (n != staged)
+                    {
+                        return written;
+                    }
+                    staged = 0;
+                }
+                if (last)
+                {
+                    break;
+                }
+                if (segments[i].size < kWriteCoalesceSize)
+                {
+                    std::memcpy(staging, segments[i].data, segments[i].size);
+                    staged = segments[i].size;
+                    continue;
+                }
+                size_t n = write(segments[i].data, segments[i].size);
+                written += n;
+                if (n != segments[i].size)
+                {
+                    return written;
+                }
+            }
+            return written;
+        }
+
+        // deadline までデータの到着を待つ
+        // ソケットの準備完了を待てない実装向けの既定動作として 1ms 間隔で確認する
+        virtual ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline)
+        {
+            while (true)
+            {
+                if (available() > 0)
+                {
+                    return ReadReadiness::Ready;
+                }
+                if (!connected())
+                {
+                    return ReadReadiness::Closed;
+                }
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return ReadReadiness::TimedOut;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
     };
 
 } // namespace canaspad
\ No newline at end of file
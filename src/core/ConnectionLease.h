@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+
+#include "BufferedConnection.h"
+#include "ClientMetrics.h"
+#include "ConnectionPool.h"
+
+namespace canaspad
+{
+
+    // 接続をプールから借りている間保持し、スコープを抜けるときに返却する
+    // 借りている間に送受信したバイト数は返却時に metrics へ加算する
+    class ConnectionLease
+    {
+    public:
+        ConnectionLease(ConnectionPool &pool, std::shared_ptr<BufferedConnection> connection, ClientMetrics &metrics)
+            : m_pool(pool), m_connection(std::move(connection)), m_metrics(metrics),
+              m_initialWritten(m_connection->bytesWritten()), m_initialRead(m_connection->bytesRead()) {}
+        ~ConnectionLease() { release(false); }
+
+        ConnectionLease(const ConnectionLease &) = delete;
+        ConnectionLease &operator=(const ConnectionLease &) = delete;
+
+        // reusable が true の場合はアイドル接続としてプールに戻す
+        void release(bool reusable)
+        {
+            if (m_connection)
+            {
+                m_metrics.addBytes(m_connection->bytesWritten() - m_initialWritten, m_connection->bytesRead() - m_initialRead);
+                m_pool.releaseConnection(m_connection, reusable);
+                m_connection.reset();
+            }
+        }
+
+    private:
+        ConnectionPool &m_pool;
+        std::shared_ptr<BufferedConnection> m_connection;
+        ClientMetrics &m_metrics;
+        size_t m_initialWritten;
+        size_t m_initialRead;
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -4,88 +4,114 @@
 
 #include "Connection.h"
 #include "CommonTypes.h"
+#include "../utils/Platform.h"
+#if CANASPAD_PLATFORM_ARDUINO
 #include "WiFiSecureConnection.h"
+#else
+#include "PosixConnection.h"
+#if CANASPAD_USE_OPENSSL
+#include "OpenSslConnection.h"
+#endif
+#endif
 
 namespace canaspad
 {
 
-    ConnectionPool::ConnectionPool(const ClientOptions &options,
-                                   std::shared_ptr<Connection> connection)
-        : m_maxConnections(10),
-          m_maxIdleTime(std::chrono::seconds(60)),
+    ConnectionPool::ConnectionPool(const ClientOptions &options, ConnectionFactory factory)
+        : m_maxConnections(std::max<size_t>(1, options.maxConnections)),
+          m_maxIdlePerHost(options.maxIdleConnectionsPerHost),
+          m_maxIdleTime(options.connectionIdleTimeout),
           m_cookieJar(std::make_shared<CookieJar>()),
+          m_tlsSessionCache(std::make_shared<TlsSessionCache>(options.tlsSessionCacheSize, options.tlsSessionLifetime)),
+          m_dnsCache(std::make_shared<DnsCache>(options.dnsCacheSize, options.dnsCacheTtl)),
           m_options(options),
-          m_defaultConnection(connection ? connection : std::make_shared<WiFiSecureConnection>())
+          m_factory(factory ? std::move(factory) : options.connectionFactory)
     {
+        if (!m_factory)
+        {
+            m_factory = [](const std::string &scheme)
+            {
+#if CANASPAD_PLATFORM_ARDUINO
+                // WiFiClientSecure は常に TLS で接続する
+                return std::shared_ptr<Connection>(std::make_shared<WiFiSecureConnection>());
+#else
+                if (scheme != "https")
+                {
+                    return std::shared_ptr<Connection>(std::make_shared<PosixConnection>());
+                }
+#if CANASPAD_USE_OPENSSL
+                return std::shared_ptr<Connection>(std::make_shared<OpenSslConnection>());
+#else
+                // https を平文の接続で送らない
+                return std::shared_ptr<Connection>();
+#endif
+#endif
+            };
+        }
     }
 
     ConnectionPool::~ConnectionPool() { disconnectAll(); }
 
-    std::shared_ptr<Connection> ConnectionPool::getConnection(
-        const std::string &host, int port)
+    Result<std::shared_ptr<BufferedConnection>> ConnectionPool::getConnection(
+        const std::string &scheme, const std::string &host, int port)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
-        if (m_defaultConnection)
+        cleanupIdleConnections();
+
+        std::string key = generateConnectionKey(scheme, host, port);
+        auto it = m_idle.find(key);
+        if (it != m_idle.end())
         {
-            // デフォルト接続が設定されている場合は、それを返す前に証明書情報を設定
-            auto wifiSecureConnection = std::static_pointer_cast<WiFiSecureConnection>(m_defaultConnection);
-            if (wifiSecureConnection)
+            auto &idleList = it->second;
+            while (!idleList.empty())
             {
-                wifiSecureConnection->setVerifySsl(m_options.verifySsl);
-                if (m_options.verifySsl)
+                // 直近に返却された接続から使う
+                auto pooled = std::move(idleList.back());
+                idleList.pop_back();
+                if (pooled.connection->isConnected())
                 {
-                    wifiSecureConnection->setCACert(m_options.rootCA.c_str());
-                    wifiSecureConnection->setClientCert(m_options.clientCert.c_str());
-                    wifiSecureConnection->setClientPrivateKey(m_options.clientPrivateKey.c_str());
+                    if (idleList.empty())
+                    {
+                        m_idle.erase(it);
+                    }
+                    m_stats.hits++;
+                    m_active[pooled.connection.get()] = key;
+                    m_lastConnection = pooled.connection;
+                    return Result<std::shared_ptr<BufferedConnection>>(pooled.connection);
                 }
+                // サーバー側で閉じられていた接続は破棄する
+                pooled.connection->disconnect();
+                m_stats.evictions++;
             }
-            return m_defaultConnection;
+            m_idle.erase(it);
         }
 
-        // 既存の接続プールのロジック
-        cleanupIdleConnections();
-
-        std::string key = generateConnectionKey(host, port);
-        auto it = m_pool.find(key);
-        if (it != m_pool.end())
+        if (m_active.size() + idleCount() >= m_maxConnections && !evictOldestIdleConnection())
         {
-            it->second.lastUsed = std::chrono::steady_clock::now();
-            return it->second.connection;
+            // すべての接続が貸し出し中
+            return Result<std::shared_ptr<BufferedConnection>>(std::shared_ptr<BufferedConnection>());
         }
 
-        if (m_pool.size() >= m_maxConnections)
+        auto newConnection = createNewConnection(scheme);
+        if (!newConnection)
         {
-            auto oldestIt = std::min_element(
-                m_pool.begin(), m_pool.end(),
-                [](const auto &a, const auto &b)
-                { return a.second.lastUsed < b.second.lastUsed; });
-            m_pool.erase(oldestIt);
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::UnsupportedProtocol, "No connection available for scheme: " + scheme));
         }
-
-        // 新しい接続を作成
-        auto newConnection = createNewConnection(host, port);
-        m_pool[key] = {newConnection, std::chrono::steady_clock::now(), host, port};
-        return newConnection;
+        m_stats.misses++;
+        m_active[newConnection.get()] = key;
+        m_lastConnection = newConnection;
+        return Result<std::shared_ptr<BufferedConnection>>(newConnection);
     }
 
-    std::shared_ptr<Connection> ConnectionPool::getConnection() const
+    std::shared_ptr<BufferedConnection> ConnectionPool::createNewConnection(const std::string &scheme)
     {
-        if (m_defaultConnection)
-        {
-            return m_defaultConnection;
-        }
-
-        if (!m_pool.empty())
+        auto connection = m_factory(scheme);
+        if (!connection)
         {
-            return m_pool.begin()->second.connection;
+            return nullptr;
         }
-        return nullptr;
-    }
-
-    std::shared_ptr<Connection> ConnectionPool::createNewConnection(const std::string &host, int port)
-    {
-        auto newConnection = std::make_shared<WiFiSecureConnection>();
+        auto newConnection = std::make_shared<BufferedConnection>(std::move(connection), m_options.readBufferSize);
         newConnection->setVerifySsl(m_options.verifySsl);
         if (m_options.verifySsl)
         {
@@ -97,17 +123,51 @@ namespace canaspad
     }
 
     void ConnectionPool::releaseConnection(
-        const std::shared_ptr<Connection> &connection)
+        const std::shared_ptr<Connection> &connection, bool reusable)
     {
+        if (!connection)
+        {
+            return;
+        }
+
         std::lock_guard<std::mutex> lock(m_mutex);
-        for (auto &[key, pooledConnection] : m_pool)
+        auto it = m_active.find(connection.get());
+        if (it == m_active.end())
+        {
+            return;
+        }
+        std::string key = std::move(it->second);
+        m_active.erase(it);
+
+        if (!reusable || !connection->isConnected())
+        {
+            connection->disconnect();
+            return;
+        }
+
+        auto &idleList = m_idle[key];
+        if (idleList.size() >= m_maxIdlePerHost)
         {
-            if (pooledConnection.connection == connection)
+            // ホストごとの上限を超える場合は最も古いアイドル接続を閉じる
+            if (m_maxIdlePerHost == 0)
             {
-                pooledConnection.lastUsed = std::chrono::steady_clock::now();
+                m_idle.erase(key);
+                connection->disconnect();
+                m_stats.evictions++;
                 return;
             }
+            idleList.front().connection->disconnect();
+            idleList.erase(idleList.begin());
+            m_stats.evictions++;
         }
+        // m_active に登録されている接続はすべてこのプールが作成した BufferedConnection
+        idleList.push_back({std::static_pointer_cast<BufferedConnection>(connection), std::chrono::steady_clock::now()});
+    }
+
+    Connection *ConnectionPool::getLastConnection() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastConnection.get();
     }
 
     std::shared_ptr<CookieJar> ConnectionPool::getCookieJar() const
@@ -115,42 +175,122 @@ namespace canaspad
         return m_cookieJar;
     }
 
+    std::shared_ptr<TlsSessionCache> ConnectionPool::getTlsSessionCache() const
+    {
+        return m_tlsSessionCache;
+    }
+
+    std::shared_ptr<DnsCache> ConnectionPool::getDnsCache() const
+    {
+        return m_dnsCache;
+    }
+
+    WarmState ConnectionPool::exportWarmState() const
+    {
+        WarmState state;
+        state.tlsSessions = m_tlsSessionCache->snapshot();
+        state.dnsEntries = m_dnsCache->snapshot();
+        state.cookies = m_cookieJar->getAllCookies();
+        return state;
+    }
+
+    void ConnectionPool::importWarmState(const WarmState &state)
+    {
+        m_tlsSessionCache->restore(state.tlsSessions);
+        m_dnsCache->restore(state.dnsEntries);
+        for (const auto &cookie : state.cookies)
+        {
+            m_cookieJar->addCookie(cookie);
+        }
+    }
+
+    ConnectionPool::Stats ConnectionPool::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.idle = idleCount();
+        stats.active = m_active.size();
+        return stats;
+    }
+
     void ConnectionPool::disconnectAll()
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        for (auto &[key, pooledConnection] : m_pool)
+        for (auto &[key, idleList] : m_idle)
         {
-            pooledConnection.connection->disconnect();
+            for (auto &pooledConnection : idleList)
+            {
+                pooledConnection.connection->disconnect();
+            }
         }
-        m_pool.clear();
+        m_idle.clear();
     }
 
     void ConnectionPool::cleanupIdleConnections()
     {
         auto now = std::chrono::steady_clock::now();
-        for (auto it = m_pool.begin(); it != m_pool.end();)
+        for (auto it = m_idle.begin(); it != m_idle.end();)
         {
-            if (now - it->second.lastUsed > m_maxIdleTime)
-            {
-                it->second.connection->disconnect();
-                it = m_pool.erase(it);
-            }
-            else
+            auto &idleList = it->second;
+            idleList.erase(std::remove_if(idleList.begin(), idleList.end(),
+                                          [&](PooledConnection &pooled)
+                                          {
+                                              if (now - pooled.lastUsed > m_maxIdleTime)
+                                              {
+                                                  pooled.connection->disconnect();
+                                                  m_stats.evictions++;
+                                                  return true;
+                                              }
+                                              return false;
+                                          }),
+                           idleList.end());
+            it = idleList.empty() ? m_idle.erase(it) : std::next(it);
+        }
+    }
+
+    bool ConnectionPool::evictOldestIdleConnection()
+    {
+        // 全ホストの中で最も長く使われていないアイドル接続を閉じる (LRU)
+        auto oldestList = m_idle.end();
+        for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+        {
+            if (oldestList == m_idle.end() ||
+                it->second.front().lastUsed < oldestList->second.front().lastUsed)
             {
-                ++it;
+                oldestList = it;
             }
         }
+        if (oldestList == m_idle.end())
+        {
+            return false;
+        }
+
+        oldestList->second.front().connection->disconnect();
+        oldestList->second.erase(oldestList->second.begin());
+        if (oldestList->second.empty())
+        {
+            m_idle.erase(oldestList);
+        }
+        m_stats.evictions++;
+        return true;
     }
 
-    std::string ConnectionPool::generateConnectionKey(const std::string &host,
-                                                      int port)
+    size_t ConnectionPool::idleCount() const
     {
-        return host + ":" + std::to_string(port);
+        size_t count = 0;
+        for (const auto &[key, idleList] : m_idle)
+        {
+            count += idleList.size();
+        }
+        return count;
     }
 
-    Connection *ConnectionPool::getDefaultConnection() const
+    std::string ConnectionPool::generateConnectionKey(const std::string &scheme,
+                                                      const std::string &host,
+                                                      int port)
     {
-        return m_defaultConnection.get();
+        // http と https の接続を取り違えないよう scheme も含める
+        return scheme + "://" + host + ":" + std::to_string(port);
     }
 
 } // namespace canaspad
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Connection.h"
+#include "BufferedConnection.h"
 #include "../cookie/CookieJar.h"
 
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <chrono>
 #include <mutex>
 #include <algorithm>
@@ -13,6 +15,9 @@
 
 #include "HttpResult.h"
 #include "CommonTypes.h"
+#include "TlsSessionCache.h"
+#include "DnsCache.h"
+#include "WarmState.h"
 
 namespace canaspad
 {
@@ -20,36 +25,63 @@ namespace canaspad
     class ConnectionPool
     {
     public:
-        ConnectionPool(const ClientOptions &options, std::shared_ptr<Connection> connection = nullptr);
+        // scheme ("http" / "https") に合った接続を作る。対応しない scheme には nullptr を返す
+        using ConnectionFactory = std::function<std::shared_ptr<Connection>(const std::string &scheme)>;
+
+        struct Stats
+        {
+            size_t hits = 0;      // アイドル接続を再利用した回数
+            size_t misses = 0;    // 新しい接続を作成した回数
+            size_t evictions = 0; // 上限またはアイドル時間超過で破棄した回数
+            size_t idle = 0;      // 現在のアイドル接続数
+            size_t active = 0;    // 現在貸し出し中の接続数
+        };
+
+        ConnectionPool(const ClientOptions &options, ConnectionFactory factory = nullptr);
         ~ConnectionPool();
 
-        std::shared_ptr<Connection> getConnection(const std::string &host, int port);
-        std::shared_ptr<Connection> getConnection() const; // 引数なしのメソッドを統合
-        Connection *getDefaultConnection() const;
-        void releaseConnection(const std::shared_ptr<Connection> &connection);
+        // scheme://host:port のアイドル接続を貸し出す。なければ新しく作成する
+        // 接続は受信バッファ付きで貸し出す。全体の上限に達していて空きがない場合は nullptr を返す
+        // scheme に対応する接続を作れない場合は UnsupportedProtocol のエラーを返す
+        Result<std::shared_ptr<BufferedConnection>> getConnection(const std::string &scheme, const std::string &host, int port);
+        // 貸し出した接続を返却する。reusable が false の場合は切断して破棄する
+        void releaseConnection(const std::shared_ptr<Connection> &connection, bool reusable = true);
+        Connection *getLastConnection() const;
         std::shared_ptr<CookieJar> getCookieJar() const;
+        std::shared_ptr<TlsSessionCache> getTlsSessionCache() const;
+        std::shared_ptr<DnsCache> getDnsCache() const;
+        // TLS セッション、名前解決の結果、クッキーをまとめて取り出す / 戻す
+        WarmState exportWarmState() const;
+        void importWarmState(const WarmState &state);
+        Stats getStats() const;
         void disconnectAll();
 
     private:
         struct PooledConnection
         {
-            std::shared_ptr<Connection> connection;
+            std::shared_ptr<BufferedConnection> connection;
             std::chrono::steady_clock::time_point lastUsed;
-            std::string host;
-            int port;
         };
 
-        std::unordered_map<std::string, PooledConnection> m_pool;
+        std::unordered_map<std::string, std::vector<PooledConnection>> m_idle; // キーごとのアイドル接続 (末尾が最新)
+        std::unordered_map<Connection *, std::string> m_active;               // 貸し出し中の接続とそのキー
         size_t m_maxConnections;
-        std::chrono::seconds m_maxIdleTime;
+        size_t m_maxIdlePerHost;
+        std::chrono::milliseconds m_maxIdleTime;
         std::shared_ptr<CookieJar> m_cookieJar;
-        std::mutex m_mutex;
+        std::shared_ptr<TlsSessionCache> m_tlsSessionCache;
+        std::shared_ptr<DnsCache> m_dnsCache;
+        mutable std::mutex m_mutex;
         ClientOptions m_options;
-        std::shared_ptr<Connection> m_defaultConnection; // デフォルト接続用
+        ConnectionFactory m_factory;
+        std::shared_ptr<BufferedConnection> m_lastConnection;
+        Stats m_stats;
 
         void cleanupIdleConnections();
-        std::string generateConnectionKey(const std::string &host, int port);
-        std::shared_ptr<Connection> createNewConnection(const std::string &host, int port);
+        bool evictOldestIdleConnection();
+        size_t idleCount() const;
+        std::string generateConnectionKey(const std::string &scheme, const std::string &host, int port);
+        std::shared_ptr<BufferedConnection> createNewConnection(const std::string &scheme);
     };
 
 } // namespace canaspad
\ No newline at end of file
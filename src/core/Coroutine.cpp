@@ -0,0 +1,241 @@
+#include "Coroutine.h"
+
+#if CANASPAD_HAS_COROUTINES
+
+#include <algorithm>
+#include <sys/select.h>
+#include <sys/time.h>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        thread_local Scheduler *t_currentScheduler = nullptr;
+
+        bool validHandle(int socket) { return socket >= 0 && socket < FD_SETSIZE; }
+
+        // socket が読み込み / 書き込み可能になるまで until を上限に待つ (until を過ぎていれば確かめるだけ)
+        bool waitHandle(int socket, bool forWrite, Scheduler::Clock::time_point until)
+        {
+            auto remaining = std::max(std::chrono::microseconds(0),
+                                      std::chrono::duration_cast<std::chrono::microseconds>(until - Scheduler::Clock::now()));
+            fd_set handles;
+            FD_ZERO(&handles);
+            FD_SET(socket, &handles);
+            timeval timeout;
+            timeout.tv_sec = static_cast<long>(remaining.count() / 1000000);
+            timeout.tv_usec = static_cast<long>(remaining.count() % 1000000);
+            return select(socket + 1, forWrite ? nullptr : &handles, forWrite ? &handles : nullptr, nullptr, &timeout) > 0;
+        }
+    } // namespace
+
+    Scheduler::~Scheduler()
+    {
+        // 待ち合わせ中のハンドルはタスクの破棄と一緒に無効になる
+        m_waiters.clear();
+        m_ready.clear();
+        m_tasks.clear();
+    }
+
+    Scheduler *Scheduler::current() { return t_currentScheduler; }
+
+    void Scheduler::spawn(Task<void> task)
+    {
+        if (!task.valid())
+        {
+            return;
+        }
+        m_ready.push_back(task.m_handle);
+        m_tasks.push_back(std::move(task));
+    }
+
+    bool Scheduler::runOnce(std::chrono::milliseconds maxWait)
+    {
+        Scheduler *previous = t_currentScheduler;
+        t_currentScheduler = this;
+
+        if (!step() && maxWait > std::chrono::milliseconds(0) && !m_tasks.empty())
+        {
+            idle(maxWait);
+            step();
+        }
+        m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), [](const Task<void> &task)
+                                     { return task.done(); }),
+                      m_tasks.end());
+
+        t_currentScheduler = previous;
+        return !m_tasks.empty();
+    }
+
+    void Scheduler::run()
+    {
+        // 待ち時間の上限は idle で次のタイマーや受信の確認までに縮める
+        while (runOnce(std::chrono::milliseconds(1000)))
+        {
+        }
+    }
+
+    bool Scheduler::step()
+    {
+        std::vector<std::coroutine_handle<>> ready;
+        ready.swap(m_ready);
+
+        auto now = Clock::now();
+        for (size_t i = 0; i < m_waiters.size();)
+        {
+            Waiter &waiter = m_waiters[i];
+            bool due = now >= waiter.deadline;
+            if (waiter.connection)
+            {
+                // 期限を現在時刻にして、止まらずに受信の有無だけを確かめる
+                ReadReadiness readiness = waiter.connection->waitForData(now);
+                if (readiness != ReadReadiness::TimedOut || due)
+                {
+                    *waiter.readiness = readiness;
+                    due = true;
+                }
+            }
+            else if (waiter.socket >= 0 && !due)
+            {
+                due = waitHandle(waiter.socket, waiter.forWrite, now);
+            }
+            if (!due)
+            {
+                ++i;
+                continue;
+            }
+            ready.push_back(waiter.handle);
+            m_waiters[i] = m_waiters.back();
+            m_waiters.pop_back();
+        }
+
+        for (auto handle : ready)
+        {
+            handle.resume();
+        }
+        return !ready.empty();
+    }
+
+    void Scheduler::idle(std::chrono::milliseconds maxWait)
+    {
+        if (!m_ready.empty())
+        {
+            return;
+        }
+        auto now = Clock::now();
+        auto wake = now + maxWait;
+        fd_set readSet;
+        fd_set writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        int maxHandle = -1;
+
+        for (const auto &waiter : m_waiters)
+        {
+            wake = std::min(wake, waiter.deadline);
+            if (!waiter.connection && waiter.socket < 0)
+            {
+                continue;
+            }
+            int socket = waiter.connection ? waiter.connection->nativeHandle() : waiter.socket;
+            if (!validHandle(socket))
+            {
+                // 記述子を持たない接続は一定間隔で確かめる
+                wake = std::min(wake, now + kPollInterval);
+                continue;
+            }
+            FD_SET(socket, waiter.forWrite ? &writeSet : &readSet);
+            maxHandle = std::max(maxHandle, socket);
+        }
+
+        if (wake <= now)
+        {
+            return;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(wake - now);
+        if (maxHandle < 0)
+        {
+            platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(remaining));
+            return;
+        }
+        // どれかの記述子の準備ができたら戻り、step で待ち合わせごとに確かめる
+        timeval timeout;
+        timeout.tv_sec = static_cast<long>(remaining.count() / 1000000);
+        timeout.tv_usec = static_cast<long>(remaining.count() % 1000000);
+        select(maxHandle + 1, &readSet, &writeSet, nullptr, &timeout);
+    }
+
+    bool Scheduler::SleepAwaiter::await_ready() const
+    {
+        auto now = Clock::now();
+        if (now >= until)
+        {
+            return true;
+        }
+        if (current() == nullptr)
+        {
+            platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(until - now));
+            return true;
+        }
+        return false;
+    }
+
+    void Scheduler::SleepAwaiter::await_suspend(std::coroutine_handle<> handle) const
+    {
+        current()->m_waiters.push_back(Waiter{handle, until, nullptr, nullptr});
+    }
+
+    bool Scheduler::ReadAwaiter::await_ready()
+    {
+        if (current() == nullptr)
+        {
+            readiness = connection->waitForData(deadline);
+            return true;
+        }
+        auto now = Clock::now();
+        readiness = connection->waitForData(now);
+        return readiness != ReadReadiness::TimedOut || now >= deadline;
+    }
+
+    void Scheduler::ReadAwaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        current()->m_waiters.push_back(Waiter{handle, deadline, connection, &readiness});
+    }
+
+    bool Scheduler::HandleAwaiter::await_ready() const
+    {
+        auto now = Clock::now();
+        if (now >= deadline)
+        {
+            return true;
+        }
+        if (current() == nullptr)
+        {
+            if (validHandle(socket))
+            {
+                waitHandle(socket, forWrite, deadline);
+            }
+            else
+            {
+                platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(std::min<Clock::duration>(deadline - now, kPollInterval)));
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void Scheduler::HandleAwaiter::await_suspend(std::coroutine_handle<> handle) const
+    {
+        if (!validHandle(socket))
+        {
+            // 記述子を持たない接続は一定間隔で再開し、呼び出し側で確かめ直す
+            current()->m_waiters.push_back(Waiter{handle, std::min(deadline, Clock::now() + kPollInterval), nullptr, nullptr});
+            return;
+        }
+        current()->m_waiters.push_back(Waiter{handle, deadline, nullptr, nullptr, socket, forWrite});
+    }
+
+} // namespace canaspad
+
+#endif // CANASPAD_HAS_COROUTINES
\ No newline at end of file
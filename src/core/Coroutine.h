@@ -0,0 +1,261 @@
+#pragma once
+
+#include "../utils/Platform.h"
+
+#if CANASPAD_HAS_COROUTINES
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Connection.h"
+
+namespace canaspad
+{
+
+    class Scheduler;
+    template <typename T>
+    class Task;
+
+    namespace detail
+    {
+        // 完了したコルーチンから、それを co_await していたコルーチンへ直接制御を移す
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                auto continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase
+        {
+            std::coroutine_handle<> continuation; // 完了時に再開するコルーチン
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            // 例外を無効にしたビルドと同じ動作になるよう、コルーチンの外へは伝えない
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        template <typename T>
+        struct TaskPromise : PromiseBase
+        {
+            std::optional<T> value;
+            Task<T> get_return_object();
+            void return_value(T result) { value.emplace(std::move(result)); }
+        };
+
+        template <>
+        struct TaskPromise<void> : PromiseBase
+        {
+            Task<void> get_return_object();
+            void return_void() {}
+        };
+
+        template <typename T>
+        class TaskBase
+        {
+        public:
+            using promise_type = TaskPromise<T>;
+
+            TaskBase(TaskBase &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+            TaskBase &operator=(TaskBase &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    destroy();
+                    m_handle = std::exchange(other.m_handle, nullptr);
+                }
+                return *this;
+            }
+            ~TaskBase() { destroy(); }
+
+            bool valid() const { return static_cast<bool>(m_handle); }
+            bool done() const { return m_handle && m_handle.done(); }
+
+            // co_await した時点で開始し、完了すると co_await したコルーチンへ戻る
+            bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_handle.promise().continuation = awaiting;
+                return m_handle;
+            }
+
+        protected:
+            friend class canaspad::Scheduler;
+
+            std::coroutine_handle<promise_type> m_handle;
+
+            explicit TaskBase(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+            void destroy()
+            {
+                if (m_handle)
+                {
+                    m_handle.destroy();
+                    m_handle = nullptr;
+                }
+            }
+        };
+    } // namespace detail
+
+    // co_await されるまで始まらないコルーチン。co_return した値を co_await の結果として受け取る
+    // Scheduler::spawn に渡した Task<void> は独立したタスクとして動く
+    template <typename T>
+    class [[nodiscard]] Task : public detail::TaskBase<T>
+    {
+    public:
+        T await_resume() { return std::move(*this->m_handle.promise().value); }
+
+    private:
+        friend struct detail::TaskPromise<T>;
+        using detail::TaskBase<T>::TaskBase;
+    };
+
+    template <>
+    class [[nodiscard]] Task<void> : public detail::TaskBase<void>
+    {
+    public:
+        void await_resume() const noexcept {}
+
+    private:
+        friend struct detail::TaskPromise<void>;
+        using detail::TaskBase<void>::TaskBase;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        Task<T> TaskPromise<T>::get_return_object()
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object()
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    } // namespace detail
+
+    // コルーチンを 1 つのタスク (スレッド) の中で切り替えながら動かす
+    // 待ち合わせ (Scheduler::sleep や受信待ち、接続と書き込みの待ち) で止まっている間は他のコルーチンを進める
+    // 記述子を持つ待ち合わせは 1 回の select でまとめて待つ
+    // loop() から runOnce を繰り返し呼ぶか、run ですべてのタスクが完了するまで回す
+    class Scheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Scheduler() = default;
+        // 完了していないタスクは途中で破棄する
+        ~Scheduler();
+
+        Scheduler(const Scheduler &) = delete;
+        Scheduler &operator=(const Scheduler &) = delete;
+
+        // 独立したタスクとして登録する。次の runOnce で開始する
+        void spawn(Task<void> task);
+        // 進められるコルーチンを進め、未完了のタスクが残っていれば true を返す
+        // 何も進められない場合は maxWait を上限に、次のタイマーかデータの到着まで待つ
+        bool runOnce(std::chrono::milliseconds maxWait = std::chrono::milliseconds(0));
+        // すべてのタスクが完了するまで回す
+        void run();
+        // 未完了のタスクの数
+        size_t tasks() const { return m_tasks.size(); }
+
+        // このタスク (スレッド) で runOnce を実行中のスケジューラ (なければ nullptr)
+        static Scheduler *current();
+
+        // 以下の待ち合わせを runOnce の外で co_await した場合は、呼び出したタスクをその場で止めて待つ
+        struct SleepAwaiter
+        {
+            Clock::time_point until;
+            bool await_ready() const;
+            void await_suspend(std::coroutine_handle<> handle) const;
+            void await_resume() const noexcept {}
+        };
+
+        struct YieldAwaiter
+        {
+            bool await_ready() const { return current() == nullptr; }
+            void await_suspend(std::coroutine_handle<> handle) const { current()->m_ready.push_back(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        struct ReadAwaiter
+        {
+            Connection *connection;
+            Clock::time_point deadline;
+            ReadReadiness readiness;
+            bool await_ready();
+            void await_suspend(std::coroutine_handle<> handle);
+            ReadReadiness await_resume() const noexcept { return readiness; }
+        };
+
+        struct HandleAwaiter
+        {
+            int socket;
+            bool forWrite;
+            Clock::time_point deadline;
+            bool await_ready() const;
+            void await_suspend(std::coroutine_handle<> handle) const;
+            void await_resume() const noexcept {}
+        };
+
+        // duration の間止まる
+        static SleepAwaiter sleep(std::chrono::milliseconds duration) { return SleepAwaiter{Clock::now() + duration}; }
+        static SleepAwaiter sleepUntil(Clock::time_point until) { return SleepAwaiter{until}; }
+        // 他のコルーチンに一度順番を譲る
+        static YieldAwaiter yield() { return YieldAwaiter{}; }
+        // connection にデータが届くか、閉じられるか、deadline を過ぎるまで止まる (結果は waitForData と同じ)
+        static ReadAwaiter readable(Connection &connection, Clock::time_point deadline)
+        {
+            return ReadAwaiter{&connection, deadline, ReadReadiness::TimedOut};
+        }
+        // 記述子 socket が書き込み可能になるか、deadline を過ぎるまで止まる (書き込めるかは再開後に writeSome で確かめる)
+        // 記述子を持たない接続 (-1) は kPollInterval 後に再開する
+        static HandleAwaiter writable(int socket, Clock::time_point deadline)
+        {
+            return HandleAwaiter{socket, true, deadline};
+        }
+        // beginConnect / continueConnect が返した want (WantRead / WantWrite) の状態になるまで止まる
+        // 再開後に continueConnect で続きを進める
+        static HandleAwaiter connectProgress(int socket, IoProgress want, Clock::time_point deadline)
+        {
+            return HandleAwaiter{socket, want == IoProgress::WantWrite, deadline};
+        }
+
+    private:
+        struct Waiter
+        {
+            std::coroutine_handle<> handle;
+            Clock::time_point deadline;
+            Connection *connection;   // 受信待ちの接続 (nullptr の場合は記述子か時刻だけを待つ)
+            ReadReadiness *readiness; // 受信待ちの結果の書き込み先
+            int socket = -1;          // 接続と書き込みで待つ記述子 (-1 の場合は時刻だけを待つ)
+            bool forWrite = false;
+        };
+
+        // 記述子を持たない接続の受信や書き込みを確かめる間隔
+        static constexpr std::chrono::milliseconds kPollInterval{1};
+
+        std::vector<Task<void>> m_tasks;
+        std::vector<std::coroutine_handle<>> m_ready; // 次に進めるコルーチン
+        std::vector<Waiter> m_waiters;
+
+        // 待ち合わせを終えたコルーチンを再開する。1 つでも再開すれば true
+        bool step();
+        void idle(std::chrono::milliseconds maxWait);
+    };
+
+} // namespace canaspad
+
+#endif // CANASPAD_HAS_COROUTINES
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "DnsCache.h"
+
+#include <algorithm>
+
+namespace canaspad
+{
+
+    DnsCache::DnsCache(size_t capacity, std::chrono::milliseconds ttl)
+        : m_capacity(capacity), m_ttl(ttl)
+    {
+    }
+
+    void DnsCache::store(const std::string &host, uint32_t address)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insert(host, address, std::chrono::steady_clock::now() + m_ttl);
+    }
+
+    bool DnsCache::lookup(const std::string &host, uint32_t &address)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(host);
+        if (it != m_entries.end() && std::chrono::steady_clock::now() < it->second.expiresAt)
+        {
+            m_stats.hits++;
+            address = it->second.address;
+            return true;
+        }
+        if (it != m_entries.end())
+        {
+            m_entries.erase(it);
+        }
+        m_stats.misses++;
+        return false;
+    }
+
+    void DnsCache::remove(const std::string &host)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.erase(host);
+    }
+
+    void DnsCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    DnsCache::Stats DnsCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.entries = m_entries.size();
+        return stats;
+    }
+
+    std::vector<DnsCache::Snapshot> DnsCache::snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        time_t wallNow = time(nullptr);
+        std::vector<Snapshot> entries;
+        for (const auto &[host, entry] : m_entries)
+        {
+            if (entry.expiresAt <= now)
+            {
+                continue;
+            }
+            // スリープを挟んでも有効期限を判定できるよう、残り時間をエポック秒に変換する
+            auto remaining = std::chrono::duration_cast<std::chrono::seconds>(entry.expiresAt - now);
+            entries.push_back({host, entry.address, wallNow + static_cast<time_t>(remaining.count())});
+        }
+        return entries;
+    }
+
+    void DnsCache::restore(const std::vector<Snapshot> &entries)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        time_t wallNow = time(nullptr);
+        for (const auto &entry : entries)
+        {
+            if (entry.expiresAt <= wallNow)
+            {
+                continue;
+            }
+            auto remaining = std::min<std::chrono::milliseconds>(std::chrono::seconds(entry.expiresAt - wallNow), m_ttl);
+            insert(entry.host, entry.address, now + remaining);
+        }
+    }
+
+    void DnsCache::insert(const std::string &host, uint32_t address, std::chrono::steady_clock::time_point expiresAt)
+    {
+        if (m_capacity == 0 || address == 0)
+        {
+            return;
+        }
+
+        if (m_entries.find(host) == m_entries.end() && m_entries.size() >= m_capacity)
+        {
+            // 最も早く期限切れになるエントリを破棄する
+            auto oldest = std::min_element(
+                m_entries.begin(), m_entries.end(),
+                [](const auto &a, const auto &b)
+                { return a.second.expiresAt < b.second.expiresAt; });
+            m_entries.erase(oldest);
+        }
+        m_entries[host] = {address, expiresAt};
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+
+namespace canaspad
+{
+
+    // ホスト名ごとに解決済みの IPv4 アドレスを TTL 付きで保持する
+    class DnsCache
+    {
+    public:
+        struct Stats
+        {
+            size_t hits = 0;    // キャッシュから解決した回数
+            size_t misses = 0;  // 名前解決が必要だった回数
+            size_t entries = 0; // 現在保持しているエントリ数
+        };
+
+        // スナップショット用のエントリ (有効期限はエポック秒)
+        struct Snapshot
+        {
+            std::string host;
+            uint32_t address;
+            time_t expiresAt;
+        };
+
+        DnsCache(size_t capacity, std::chrono::milliseconds ttl);
+
+        void store(const std::string &host, uint32_t address);
+        bool lookup(const std::string &host, uint32_t &address);
+        void remove(const std::string &host);
+        void clear();
+        Stats getStats() const;
+
+        std::vector<Snapshot> snapshot() const;
+        void restore(const std::vector<Snapshot> &entries);
+
+    private:
+        struct Entry
+        {
+            uint32_t address;
+            std::chrono::steady_clock::time_point expiresAt;
+        };
+
+        std::unordered_map<std::string, Entry> m_entries;
+        size_t m_capacity;
+        std::chrono::milliseconds m_ttl;
+        mutable std::mutex m_mutex;
+        Stats m_stats;
+
+        void insert(const std::string &host, uint32_t address, std::chrono::steady_clock::time_point expiresAt);
+    };
+
+} // namespace canaspad
\ No newline at end of file
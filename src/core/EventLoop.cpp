@@ -0,0 +1,521 @@
+#include "EventLoop.h"
+
+#include <algorithm>
+#include <string>
+#include <sys/select.h>
+#include <sys/time.h>
+
+#include "../HttpClient.h"
+#include "ConnectionLease.h"
+#include "RequestValidator.h"
+#include "ResponseParser.h"
+#include "mock/MockWiFiClientSecure.h"
+#include "../utils/Log.h"
+#include "../utils/Platform.h"
+#include "../utils/Utils.h"
+
+namespace canaspad
+{
+
+    namespace
+    {
+        // Content-Length から本文用に先に確保する上限 (不正に大きな値でヒープを使い切らないため)
+        constexpr size_t kMaxBodyReserve = 16 * 1024;
+    } // namespace
+
+    struct EventLoop::Exchange
+    {
+        enum class Stage
+        {
+            Start,      // 接続を借りる (プールに空きがなければここで待つ)
+            Connecting, // TCP の接続と TLS のハンドシェイク
+            Writing,
+            Reading,
+            Backoff, // リトライまでの待ち時間
+            Done
+        };
+
+        Request request; // 送信中のリクエスト (リダイレクトでは移動先に置き換える)
+        std::string host; // メトリクスに記録するホスト (最初のリクエストのもの)
+        AsyncResult result;
+        CancellationRegistry::Registration registration; // 完了するまで ID で取り消せる
+        Stage stage = Stage::Start;
+        IoProgress want = IoProgress::Done; // Connecting で待つ記述子の状態
+        std::chrono::steady_clock::time_point deadline; // 現在の段階の期限
+        std::shared_ptr<BufferedConnection> connection;
+        std::unique_ptr<ConnectionLease> lease;
+        HttpClient::PendingWrite pending;
+        ResponseParser parser;
+        HttpResult response;
+        size_t bytesRead = 0;
+        RequestTiming timing;
+        int retryCount = 0;
+        int redirectCount = 0;
+    };
+
+    EventLoop::EventLoop(HttpClient &client) : m_client(client) {}
+
+    EventLoop::~EventLoop()
+    {
+        for (auto *exchanges : {&m_exchanges, &m_submitted})
+        {
+            for (auto &exchange : *exchanges)
+            {
+                if (exchange->stage != Exchange::Stage::Done)
+                {
+                    releaseConnection(*exchange, false);
+                    exchange->result.complete(ErrorInfo(ErrorCode::RequestCancelled, "Event loop destroyed before the request completed"));
+                }
+            }
+        }
+    }
+
+    AsyncResult EventLoop::submit(Request request, AsyncResult::Callback onComplete)
+    {
+        CANASPAD_LOGD("EventLoop::submit - %s", request.getUrl().c_str());
+        if (!m_client.m_isInitialized)
+        {
+            AsyncResult result = AsyncResult::completed(m_client.m_initializationError);
+            if (onComplete)
+            {
+                result.then(std::move(onComplete));
+            }
+            return result;
+        }
+
+        auto exchange = std::make_unique<Exchange>();
+        Exchange *state = exchange.get();
+        state->request = std::move(request);
+        state->host.assign(state->request.getParsedUrl().host());
+        state->registration = m_client.registerSend(state->request);
+        state->result = AsyncResult::create();
+        if (onComplete)
+        {
+            state->result.then(std::move(onComplete));
+        }
+        state->timing.start = std::chrono::steady_clock::now();
+
+        state->parser.onStatus([state](int code, std::string_view message)
+                               {
+                                   state->response.statusCode = code;
+                                   state->response.statusMessage.assign(message.data(), message.size()); });
+        state->parser.onHeader([state](std::string_view key, std::string_view value)
+                               { state->response.headers.add(key, value); });
+        // チャンクのトレーラーは通常のヘッダーとして扱う
+        state->parser.onTrailer([state](std::string_view key, std::string_view value)
+                                { state->response.headers.add(key, value); });
+        state->parser.onBody([state](const char *data, size_t size)
+                             {
+                                 if (state->response.body.empty() && state->parser.hasContentLength())
+                                 {
+                                     // 長さが分かっている場合は一度で確保し、伸ばすたびの再確保を避ける
+                                     state->response.body.reserve(std::min(state->parser.contentLength(), kMaxBodyReserve));
+                                 }
+                                 state->response.body.append(data, size); });
+
+        AsyncResult result = state->result;
+        m_submitted.push_back(std::move(exchange));
+        return result;
+    }
+
+    bool EventLoop::runOnce(std::chrono::milliseconds maxWait)
+    {
+        for (auto &exchange : m_submitted)
+        {
+            m_exchanges.push_back(std::move(exchange));
+        }
+        m_submitted.clear();
+
+        // 各送信は進められなくなるまで進むため、その後は準備ができるまで待ってよい
+        for (auto &exchange : m_exchanges)
+        {
+            advance(*exchange);
+        }
+        bool waiting = std::any_of(m_exchanges.begin(), m_exchanges.end(), [](const std::unique_ptr<Exchange> &exchange)
+                                   { return exchange->stage != Exchange::Stage::Done; });
+        if (waiting && m_submitted.empty() && maxWait > std::chrono::milliseconds(0))
+        {
+            waitForSockets(maxWait);
+            for (auto &exchange : m_exchanges)
+            {
+                advance(*exchange);
+            }
+        }
+
+        m_exchanges.erase(std::remove_if(m_exchanges.begin(), m_exchanges.end(), [](const std::unique_ptr<Exchange> &exchange)
+                                         { return exchange->stage == Exchange::Stage::Done; }),
+                          m_exchanges.end());
+        return pending() > 0;
+    }
+
+    void EventLoop::run()
+    {
+        // 待ち時間の上限は waitForSockets で次の期限までに縮める
+        while (runOnce(std::chrono::milliseconds(1000)))
+        {
+        }
+    }
+
+    void EventLoop::advance(Exchange &exchange)
+    {
+        // 段階が進んだ場合は、次の段階も止まらずに進められるところまで進める
+        while (true)
+        {
+            auto stage = exchange.stage;
+            if (stage != Exchange::Stage::Done && exchange.request.getCancellationToken().cancelled())
+            {
+                // 使っていた接続だけを閉じ、名前解決の結果や TLS セッションは残す
+                complete(exchange, ErrorInfo(ErrorCode::RequestCancelled, "Request was cancelled"));
+                return;
+            }
+            switch (stage)
+            {
+            case Exchange::Stage::Start:
+                start(exchange);
+                break;
+            case Exchange::Stage::Connecting:
+                if (std::chrono::steady_clock::now() >= exchange.deadline)
+                {
+                    onConnectProgress(exchange, IoProgress::Failed);
+                }
+                else
+                {
+                    onConnectProgress(exchange, exchange.connection->continueConnect());
+                }
+                break;
+            case Exchange::Stage::Writing:
+                write(exchange);
+                break;
+            case Exchange::Stage::Reading:
+                read(exchange);
+                break;
+            case Exchange::Stage::Backoff:
+                if (std::chrono::steady_clock::now() >= exchange.deadline)
+                {
+                    exchange.stage = Exchange::Stage::Start;
+                    exchange.deadline = std::chrono::steady_clock::time_point();
+                }
+                break;
+            case Exchange::Stage::Done:
+                return;
+            }
+            if (exchange.stage == stage)
+            {
+                return;
+            }
+        }
+    }
+
+    void EventLoop::start(Exchange &exchange)
+    {
+        const Request &request = exchange.request;
+        auto now = std::chrono::steady_clock::now();
+        if (exchange.deadline == std::chrono::steady_clock::time_point())
+        {
+            // 最初の試行でのみ検証する (プールの空きを待って再び呼ばれる場合は省く)
+            auto validationResult = RequestValidator::validate(request, m_client.m_options);
+            if (validationResult.isError())
+            {
+                fail(exchange, validationResult.error());
+                return;
+            }
+            const auto &source = request.getBodySource();
+            if (source && !source->restart())
+            {
+                fail(exchange, ErrorInfo(ErrorCode::InvalidBody, "Request body source cannot be rewound to send it again"));
+                return;
+            }
+            exchange.deadline = now + m_client.m_timeouts.connect;
+        }
+
+        exchange.timing.resetAttempt();
+        exchange.timing.retries = exchange.retryCount;
+        exchange.timing.redirects = exchange.redirectCount;
+        exchange.parser.reset();
+
+        IoProgress progress = IoProgress::Failed;
+        auto connectionResult = m_client.beginConnection(request, &exchange.timing, progress);
+        if (connectionResult.isError())
+        {
+            fail(exchange, connectionResult.error());
+            return;
+        }
+        exchange.connection = connectionResult.value();
+        if (!exchange.connection)
+        {
+            // プールの上限に達している場合は、他の送信が接続を返すのを待つ
+            if (now >= exchange.deadline)
+            {
+                fail(exchange, ErrorInfo(ErrorCode::NetworkError, "Failed to get connection from pool"));
+            }
+            return;
+        }
+        exchange.lease = std::make_unique<ConnectionLease>(*m_client.m_connectionPool, exchange.connection, m_client.m_metrics);
+
+        if (progress == IoProgress::Done)
+        {
+            startWriting(exchange);
+            return;
+        }
+        exchange.deadline = std::chrono::steady_clock::now() + m_client.m_timeouts.connect;
+        onConnectProgress(exchange, progress);
+    }
+
+    void EventLoop::onConnectProgress(Exchange &exchange, IoProgress progress)
+    {
+        if (progress == IoProgress::WantRead || progress == IoProgress::WantWrite)
+        {
+            exchange.stage = Exchange::Stage::Connecting;
+            exchange.want = progress;
+            return;
+        }
+
+        auto finished = m_client.finishConnection(exchange.connection.get(), exchange.request, progress, exchange.deadline, &exchange.timing);
+        if (finished.isError())
+        {
+            fail(exchange, finished.error());
+            return;
+        }
+        startWriting(exchange);
+    }
+
+    void EventLoop::startWriting(Exchange &exchange)
+    {
+        m_client.startWrite(exchange.request, exchange.pending);
+        exchange.deadline = std::chrono::steady_clock::now() + m_client.m_timeouts.write;
+        exchange.stage = Exchange::Stage::Writing;
+    }
+
+    void EventLoop::write(Exchange &exchange)
+    {
+        auto step = m_client.writeStep(exchange.connection.get(), exchange.request, exchange.pending, exchange.deadline);
+        if (step.isError())
+        {
+            fail(exchange, step.error());
+            return;
+        }
+        if (step.value() != IoProgress::Done)
+        {
+            // 送信バッファが空くのを待つ
+            return;
+        }
+        exchange.timing.requestSent = std::chrono::steady_clock::now();
+        startReading(exchange);
+    }
+
+    void EventLoop::startReading(Exchange &exchange)
+    {
+        exchange.parser.reset();
+        exchange.parser.setRequestMethod(exchange.request.getMethod());
+        exchange.response = HttpResult();
+        exchange.bytesRead = 0;
+        // レスポンス全体を 1 つの期限で読み込む
+        exchange.deadline = std::chrono::steady_clock::now() + m_client.m_timeouts.read;
+        exchange.stage = Exchange::Stage::Reading;
+    }
+
+    void EventLoop::read(Exchange &exchange)
+    {
+        BufferedConnection *connection = exchange.connection.get();
+        ResponseParser &parser = exchange.parser;
+        while (!parser.isComplete() && !parser.hasError())
+        {
+            if (connection->buffered() == 0)
+            {
+                auto now = std::chrono::steady_clock::now();
+                // 期限を現在時刻にして、止まらずに受信の有無だけを確かめる
+                auto readiness = connection->waitForData(now);
+                if (readiness == ReadReadiness::TimedOut)
+                {
+                    if (now >= exchange.deadline)
+                    {
+                        fail(exchange, ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading response"));
+                    }
+                    return;
+                }
+                if (readiness == ReadReadiness::Closed)
+                {
+                    if (parser.state() == ResponseParser::State::BodyUntilClose)
+                    {
+                        // 長さ指定のないボディは接続の終端で完了とする
+                        parser.finish();
+                        break;
+                    }
+                    // 途中で切断された場合はネットワークエラーとして扱い、リトライの対象にする
+                    fail(exchange, ErrorInfo(ErrorCode::NetworkError,
+                                             exchange.bytesRead == 0 ? "Connection closed before the response was received"
+                                                                     : "Connection closed before the response was complete"));
+                    return;
+                }
+                if (connection->fill() == 0)
+                {
+                    // TLS のレコードが揃うまでは平文を読めない
+                    return;
+                }
+            }
+
+            if (exchange.timing.firstByte == RequestTiming::TimePoint())
+            {
+                exchange.timing.firstByte = std::chrono::steady_clock::now();
+            }
+            size_t consumed = parser.feed(connection->bufferedData(), connection->buffered());
+            connection->consume(consumed);
+            exchange.bytesRead += consumed;
+        }
+        finishResponse(exchange);
+    }
+
+    void EventLoop::finishResponse(Exchange &exchange)
+    {
+        ResponseParser &parser = exchange.parser;
+        if (parser.hasError())
+        {
+            fail(exchange, ErrorInfo(ErrorCode::InvalidResponse, parser.errorMessage()));
+            return;
+        }
+        exchange.timing.responseEnd = std::chrono::steady_clock::now();
+        // 最後まで読み切り、サーバーが接続を維持する場合のみ再利用できる
+        releaseConnection(exchange, parser.keepAlive());
+
+        HttpResult &response = exchange.response;
+        m_client.storeCookies(exchange.request, response);
+        if (response.statusCode >= 300 && response.statusCode < 400 && m_client.m_options.followRedirects)
+        {
+            auto location = Utils::extractHeaderValue(response.headers, HeaderNames::Location);
+            if (location.empty())
+            {
+                complete(exchange, ErrorInfo(ErrorCode::InvalidResponse, "Redirect location not found"));
+                return;
+            }
+            if (exchange.redirectCount >= m_client.m_options.maxRedirects)
+            {
+                complete(exchange, ErrorInfo(ErrorCode::TooManyRedirects, "Too many redirects"));
+                return;
+            }
+            CANASPAD_LOGD("EventLoop::finishResponse - Redirecting to: %s", location.c_str());
+            exchange.request = m_client.makeRedirectRequest(exchange.request, nullptr, std::move(location));
+            ++exchange.redirectCount;
+            exchange.stage = Exchange::Stage::Start;
+            exchange.deadline = std::chrono::steady_clock::time_point();
+            return;
+        }
+        complete(exchange, std::move(response));
+    }
+
+    void EventLoop::fail(Exchange &exchange, ErrorInfo error)
+    {
+        CANASPAD_LOGW("EventLoop - Error %d: %s", static_cast<int>(error.code), error.message.c_str());
+        releaseConnection(exchange, false);
+
+        const auto &source = exchange.request.getBodySource();
+        if (m_client.isRetryable(error, exchange.retryCount) && (!source || source->restart()))
+        {
+            CANASPAD_LOGI("EventLoop - Retrying request (%d/%d)", exchange.retryCount + 1, m_client.m_options.maxRetries);
+            ++exchange.retryCount;
+            exchange.stage = Exchange::Stage::Backoff;
+            exchange.deadline = std::chrono::steady_clock::now() + m_client.m_options.retryDelay;
+            return;
+        }
+        complete(exchange, std::move(error));
+    }
+
+    void EventLoop::complete(Exchange &exchange, Result<HttpResult> result)
+    {
+        releaseConnection(exchange, false);
+        RequestTiming &timing = exchange.timing;
+        timing.end = std::chrono::steady_clock::now();
+        if (result.isSuccess())
+        {
+            result.value().timing = timing;
+            m_client.m_metrics.record(exchange.host, result.value().statusCode, ErrorCode::None, timing);
+        }
+        else
+        {
+            result.error().timing = timing;
+            m_client.m_metrics.record(exchange.host, 0, result.error().code, timing);
+        }
+        exchange.stage = Exchange::Stage::Done;
+        exchange.registration.reset();
+        exchange.result.complete(std::move(result));
+    }
+
+    void EventLoop::releaseConnection(Exchange &exchange, bool reusable)
+    {
+        if (!exchange.lease)
+        {
+            return;
+        }
+        if (m_client.m_useMock && exchange.parser.headersComplete())
+        {
+            static_cast<MockWiFiClientSecure *>(m_client.m_mockConnection.get())->moveToNextResponse();
+        }
+        exchange.lease->release(reusable && exchange.parser.isComplete());
+        exchange.lease.reset();
+        exchange.connection.reset();
+    }
+
+    void EventLoop::waitForSockets(std::chrono::milliseconds maxWait)
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto wake = now + maxWait;
+        fd_set readSet;
+        fd_set writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        int maxHandle = -1;
+
+        for (const auto &exchange : m_exchanges)
+        {
+            auto stage = exchange->stage;
+            if (stage == Exchange::Stage::Done)
+            {
+                continue;
+            }
+            wake = std::min(wake, exchange->deadline);
+            if (exchange->request.getCancellationToken().valid())
+            {
+                // 他のタスクからの取り消しに気付けるよう、待ち時間を区切る
+                wake = std::min(wake, now + CancellationToken::kCheckInterval);
+            }
+            if (stage == Exchange::Stage::Start)
+            {
+                // プールの空きは記述子では待てない
+                wake = std::min(wake, now + kPollInterval);
+                continue;
+            }
+            bool wantRead = stage == Exchange::Stage::Reading ||
+                            (stage == Exchange::Stage::Connecting && exchange->want == IoProgress::WantRead);
+            bool wantWrite = stage == Exchange::Stage::Writing ||
+                             (stage == Exchange::Stage::Connecting && exchange->want == IoProgress::WantWrite);
+            if (!wantRead && !wantWrite)
+            {
+                continue;
+            }
+            int handle = exchange->connection->nativeHandle();
+            if (handle < 0 || handle >= FD_SETSIZE)
+            {
+                // 記述子を持たない接続は一定間隔で確かめる
+                wake = std::min(wake, now + kPollInterval);
+                continue;
+            }
+            FD_SET(handle, wantRead ? &readSet : &writeSet);
+            maxHandle = std::max(maxHandle, handle);
+        }
+
+        if (wake <= now)
+        {
+            return;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(wake - now);
+        if (maxHandle < 0)
+        {
+            platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(remaining));
+            return;
+        }
+        timeval timeout;
+        timeout.tv_sec = static_cast<long>(remaining.count() / 1000000);
+        timeout.tv_usec = static_cast<long>(remaining.count() % 1000000);
+        select(maxHandle + 1, &readSet, &writeSet, nullptr, &timeout);
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "AsyncResult.h"
+#include "Connection.h"
+#include "Request.h"
+
+namespace canaspad
+{
+
+    class HttpClient;
+
+    // 1 つのタスク (スレッド) で複数の送信を同時に進める
+    // 各送信は接続、TLS ハンドシェイク、書き込み、受信の段階をソケットの準備ができた分だけ進め、
+    // 進められない間はすべてのソケットを 1 回の select でまとめて待つ
+    // 多数のエンドポイントへ送る場合も、送信ごとにタスク (とスタック) を用意せずに済む
+    // client の接続プールやキャッシュを共有する。client より先に破棄する
+    class EventLoop
+    {
+    public:
+        explicit EventLoop(HttpClient &client);
+        // 完了していない送信は RequestCancelled で完了させる
+        ~EventLoop();
+
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        // 送信を登録し、次の runOnce から進める
+        // 結果は runOnce の中で設定され、onComplete もそこで呼ばれる (runOnce を呼ぶタスクで wait() しない)
+        AsyncResult submit(Request request, AsyncResult::Callback onComplete = nullptr);
+        // 進められる送信を進め、未完了の送信が残っていれば true を返す
+        // 何も進められない場合は maxWait を上限に、ソケットの準備ができるか期限が来るまで待つ
+        bool runOnce(std::chrono::milliseconds maxWait = std::chrono::milliseconds(0));
+        // すべての送信が完了するまで回す
+        void run();
+        // 未完了の送信の数
+        size_t pending() const { return m_exchanges.size() + m_submitted.size(); }
+
+    private:
+        struct Exchange;
+
+        // ソケットを持たない接続 (モックなど) の受信を確かめる間隔
+        static constexpr std::chrono::milliseconds kPollInterval{1};
+
+        HttpClient &m_client;
+        std::vector<std::unique_ptr<Exchange>> m_exchanges;
+        std::vector<std::unique_ptr<Exchange>> m_submitted; // 次の runOnce で m_exchanges に加える
+
+        // 止まらずに進められるところまで進める
+        void advance(Exchange &exchange);
+        void start(Exchange &exchange);
+        void onConnectProgress(Exchange &exchange, IoProgress progress);
+        void startWriting(Exchange &exchange);
+        void write(Exchange &exchange);
+        void startReading(Exchange &exchange);
+        void read(Exchange &exchange);
+        void finishResponse(Exchange &exchange);
+        // 送り直せるエラーならリトライを待つ段階へ、そうでなければ完了させる
+        void fail(Exchange &exchange, ErrorInfo error);
+        void complete(Exchange &exchange, Result<HttpResult> result);
+        void releaseConnection(Exchange &exchange, bool reusable);
+        void waitForSockets(std::chrono::milliseconds maxWait);
+    };
+
+} // namespace canaspad
\ No newline at end of file
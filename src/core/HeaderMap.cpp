@@ -0,0 +1,147 @@
+#include "HeaderMap.h"
+
+#include <algorithm>
+
+namespace canaspad
+{
+
+    void HeaderMap::add(std::string_view name, std::string_view value)
+    {
+        Entry entry;
+        entry.hash = headerNameHash(name);
+        entry.offset = static_cast<uint32_t>(m_buffer.size());
+        entry.nameLength = static_cast<uint16_t>(name.size());
+        entry.valueLength = static_cast<uint32_t>(value.size());
+
+        m_buffer.append(name.data(), name.size()).push_back('\0');
+        m_buffer.append(value.data(), value.size()).push_back('\0');
+        m_fields.push_back(entry);
+    }
+
+    void HeaderMap::set(std::string_view name, std::string_view value)
+    {
+        remove(HeaderName(name));
+        add(name, value);
+    }
+
+    size_t HeaderMap::remove(const HeaderName &name)
+    {
+        size_t before = m_fields.size();
+        auto it = std::remove_if(m_fields.begin(), m_fields.end(), [this, &name](const Entry &entry)
+                                 {
+                                     if (entry.hash != name.hash || !equalsIgnoreCase(std::string_view(m_buffer.data() + entry.offset, entry.nameLength), name.name))
+                                     {
+                                         return false;
+                                     }
+                                     m_unusedBytes += entry.nameLength + entry.valueLength + 2;
+                                     return true; });
+        m_fields.erase(it, m_fields.end());
+
+        // 使われなくなったバイトがバッファの半分を超えたら詰め直す
+        if (m_unusedBytes > m_buffer.size() / 2)
+        {
+            compact();
+        }
+        return before - m_fields.size();
+    }
+
+    std::string_view HeaderMap::get(const HeaderName &name) const
+    {
+        size_t index = indexOf(name, 0);
+        return index == m_fields.size() ? std::string_view() : field(index).value;
+    }
+
+    std::vector<std::string_view> HeaderMap::getAll(const HeaderName &name) const
+    {
+        std::vector<std::string_view> values;
+        for (size_t index = indexOf(name, 0); index < m_fields.size(); index = indexOf(name, index + 1))
+        {
+            values.push_back(field(index).value);
+        }
+        return values;
+    }
+
+    void HeaderMap::clear()
+    {
+        m_buffer.clear();
+        m_fields.clear();
+        m_unusedBytes = 0;
+    }
+
+    void HeaderMap::reserve(size_t fields, size_t bytes)
+    {
+        m_fields.reserve(fields);
+        m_buffer.reserve(bytes);
+    }
+
+    size_t HeaderMap::memoryUsage() const
+    {
+        // std::string の短い文字列はオブジェクト内に収まるためヒープを使わない
+        size_t bufferBytes = m_buffer.capacity() > Buffer().capacity() ? m_buffer.capacity() + 1 : 0;
+        return bufferBytes + m_fields.capacity() * sizeof(Entry);
+    }
+
+    bool HeaderMap::equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            char x = a[i];
+            char y = b[i];
+            if (x >= 'A' && x <= 'Z')
+            {
+                x += 'a' - 'A';
+            }
+            if (y >= 'A' && y <= 'Z')
+            {
+                y += 'a' - 'A';
+            }
+            if (x != y)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    HeaderMap::Field HeaderMap::field(size_t index) const
+    {
+        const Entry &entry = m_fields[index];
+        const char *name = m_buffer.data() + entry.offset;
+        return {std::string_view(name, entry.nameLength),
+                std::string_view(name + entry.nameLength + 1, entry.valueLength)};
+    }
+
+    size_t HeaderMap::indexOf(const HeaderName &name, size_t start) const
+    {
+        for (size_t i = start; i < m_fields.size(); ++i)
+        {
+            const Entry &entry = m_fields[i];
+            if (entry.hash == name.hash &&
+                equalsIgnoreCase(std::string_view(m_buffer.data() + entry.offset, entry.nameLength), name.name))
+            {
+                return i;
+            }
+        }
+        return m_fields.size();
+    }
+
+    void HeaderMap::compact()
+    {
+        Buffer buffer(m_buffer.get_allocator());
+        buffer.reserve(m_buffer.size() - m_unusedBytes);
+        for (auto &entry : m_fields)
+        {
+            size_t length = entry.nameLength + entry.valueLength + 2;
+            uint32_t offset = static_cast<uint32_t>(buffer.size());
+            buffer.append(m_buffer, entry.offset, length);
+            entry.offset = offset;
+        }
+        m_buffer.swap(buffer);
+        m_unusedBytes = 0;
+    }
+
+} // namespace canaspad
\ No newline at end of file
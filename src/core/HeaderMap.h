@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Arena.h"
+
+namespace canaspad
+{
+
+    // 大文字・小文字を区別しないヘッダー名のハッシュ (FNV-1a)
+    constexpr uint32_t headerNameHash(std::string_view name)
+    {
+        uint32_t hash = 2166136261u;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // ハッシュを計算済みのヘッダー名
+    struct HeaderName
+    {
+        std::string_view name;
+        uint32_t hash;
+
+        constexpr HeaderName(std::string_view n) : name(n), hash(headerNameHash(n)) {}
+        constexpr HeaderName(const char *n) : HeaderName(std::string_view(n)) {}
+        HeaderName(const std::string &n) : HeaderName(std::string_view(n)) {}
+    };
+
+    // よく使うヘッダー名 (ハッシュはコンパイル時に計算される)
+    namespace HeaderNames
+    {
+        inline constexpr HeaderName Authorization{"Authorization"};
+        inline constexpr HeaderName Connection{"Connection"};
+        inline constexpr HeaderName ContentLength{"Content-Length"};
+        inline constexpr HeaderName ContentType{"Content-Type"};
+        inline constexpr HeaderName Location{"Location"};
+        inline constexpr HeaderName SetCookie{"Set-Cookie"};
+        inline constexpr HeaderName TransferEncoding{"Transfer-Encoding"};
+    } // namespace HeaderNames
+
+    // リクエストとレスポンスで共通のヘッダー
+    // 名前と値は 1 つのバッファに "name\0value\0" の形で追記し、各フィールドはそのオフセットとハッシュだけを持つ
+    // 名前は大文字・小文字を区別せずに検索し、同じ名前のフィールド (Set-Cookie など) は追加した順にすべて保持する
+    // Arena を渡した場合はバッファをそこから確保する (コピーは通常のヒープに作られる)
+    class HeaderMap
+    {
+    public:
+        HeaderMap() = default;
+        explicit HeaderMap(Arena *arena) : m_buffer(ArenaAllocator<char>(arena)), m_fields(ArenaAllocator<Entry>(arena)) {}
+
+        struct Field
+        {
+            std::string_view name;
+            std::string_view value; // NUL 終端されている
+        };
+
+        class const_iterator
+        {
+        public:
+            const_iterator(const HeaderMap *map, size_t index) : m_map(map), m_index(index) {}
+
+            Field operator*() const { return m_map->field(m_index); }
+            const Field *operator->() const
+            {
+                m_field = m_map->field(m_index);
+                return &m_field;
+            }
+            const_iterator &operator++()
+            {
+                ++m_index;
+                return *this;
+            }
+            bool operator==(const const_iterator &other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator &other) const { return m_index != other.m_index; }
+
+        private:
+            const HeaderMap *m_map;
+            size_t m_index;
+            mutable Field m_field;
+        };
+
+        // 同じ名前があっても末尾に追加する
+        void add(std::string_view name, std::string_view value);
+        // 同じ名前のフィールドをすべて置き換える
+        void set(std::string_view name, std::string_view value);
+        // 同じ名前のフィールドをすべて削除する。削除した数を返す
+        size_t remove(const HeaderName &name);
+
+        const_iterator find(const HeaderName &name) const { return const_iterator(this, indexOf(name, 0)); }
+        bool contains(const HeaderName &name) const { return indexOf(name, 0) != m_fields.size(); }
+        // 最初に見つかった値。なければ空
+        std::string_view get(const HeaderName &name) const;
+        // 同じ名前の値を追加した順にすべて返す
+        std::vector<std::string_view> getAll(const HeaderName &name) const;
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_fields.size()); }
+        size_t size() const { return m_fields.size(); }
+        bool empty() const { return m_fields.empty(); }
+        void clear();
+        void reserve(size_t fields, size_t bytes);
+
+        // 確保しているヒープの量 (バイト)
+        size_t memoryUsage() const;
+
+        static bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+    private:
+        struct Entry
+        {
+            uint32_t hash;
+            uint32_t offset; // m_buffer 内の名前の位置 (値は名前の NUL の直後)
+            uint32_t valueLength;
+            uint16_t nameLength;
+        };
+
+        using Buffer = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+        Buffer m_buffer;
+        std::vector<Entry, ArenaAllocator<Entry>> m_fields;
+        size_t m_unusedBytes = 0; // 削除したフィールドが使っていたバイト数
+
+        Field field(size_t index) const;
+        size_t indexOf(const HeaderName &name, size_t start) const;
+        void compact();
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -1,40 +1,79 @@
 #include "HttpClient.h"
-#include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
 #include <thread>
+#include <cstring>
 #include "../utils/Utils.h"
-#include "WiFiSecureConnection.h"
 #include "mock/MockWiFiClientSecure.h"
 #include "RequestValidator.h"
-#include <Arduino.h>
+#include "ConnectionLease.h"
+#include "ResponseParser.h"
+#include "../utils/Log.h"
+#include "../utils/Platform.h"
+#include <sys/select.h>
 
 namespace canaspad
 {
 
+    namespace
+    {
+        // Content-Length から本文用に先に確保する上限 (不正に大きな値でヒープを使い切らないため)
+        constexpr size_t kMaxBodyReserve = 16 * 1024;
+
+        ErrorInfo cancelledError()
+        {
+            return ErrorInfo(ErrorCode::RequestCancelled, "Request was cancelled");
+        }
+
+        // 記述子が読み込み (forWrite の場合は書き込み) 可能になるか、deadline まで待つ
+        void waitForHandle(int handle, bool forWrite, std::chrono::steady_clock::time_point deadline)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+            {
+                return;
+            }
+            if (handle < 0 || handle >= FD_SETSIZE)
+            {
+                platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(remaining));
+                return;
+            }
+            fd_set handles;
+            FD_ZERO(&handles);
+            FD_SET(handle, &handles);
+            timeval timeout;
+            timeout.tv_sec = static_cast<long>(remaining.count() / 1000000);
+            timeout.tv_usec = static_cast<long>(remaining.count() % 1000000);
+            select(handle + 1, forWrite ? nullptr : &handles, forWrite ? &handles : nullptr, nullptr, &timeout);
+        }
+    } // namespace
+
     HttpClient::HttpClient(const ClientOptions &options, bool useMock)
-        : m_connectionPool(std::make_unique<ConnectionPool>(
-              options,
-              useMock ? std::shared_ptr<Connection>(new MockWiFiClientSecure(options))
-                      : std::shared_ptr<Connection>(new WiFiSecureConnection()))),
-          m_auth(std::make_unique<Auth>(options)),
+        : m_auth(std::make_unique<Auth>(options)),
           m_isInitialized(true),
           m_initializationError(ErrorCode::None, ""),
           m_useMock(useMock),
-          m_options(options)
+          m_options(options),
+          m_proxyUrl(options.proxyUrl)
     {
+        if (!m_proxyUrl.userinfo().empty())
+        {
+            m_proxyAuthorization = "Basic " + Utils::base64Encode(std::string(m_proxyUrl.userinfo()));
+        }
         if (useMock)
         {
+            // モック使用時はプールが常に同じモック接続を返す
             m_mockConnection = std::make_shared<MockWiFiClientSecure>(options);
+            auto mockConnection = m_mockConnection;
+            m_connectionPool = std::make_unique<ConnectionPool>(options, [mockConnection](const std::string &)
+                                                                { return mockConnection; });
         }
         else
         {
             m_connectionPool = std::make_unique<ConnectionPool>(options);
 
-            time_t now;
-            time(&now);
-            if (now < 3600 * 9)
+            if (!platform::isWallClockSet())
             {
                 m_isInitialized = false;
                 m_initializationError = (ErrorInfo(
@@ -44,7 +83,11 @@ namespace canaspad
         }
     }
 
-    HttpClient::~HttpClient() = default;
+    HttpClient::~HttpClient()
+    {
+        // 実行中の sendAsync が接続プールなどを使い終えるまで待つ
+        m_workers.reset();
+    }
 
     Connection *HttpClient::getConnection() const
     {
@@ -52,7 +95,58 @@ namespace canaspad
         {
             return m_mockConnection.get();
         }
-        return m_connectionPool->getDefaultConnection();
+        return m_connectionPool->getLastConnection();
+    }
+
+    ConnectionPool::Stats HttpClient::getConnectionPoolStats() const
+    {
+        return m_connectionPool->getStats();
+    }
+
+    TlsSessionCache::Stats HttpClient::getTlsSessionStats() const
+    {
+        return m_connectionPool->getTlsSessionCache()->getStats();
+    }
+
+    DnsCache::Stats HttpClient::getDnsCacheStats() const
+    {
+        return m_connectionPool->getDnsCache()->getStats();
+    }
+
+    MetricsSnapshot HttpClient::getMetrics() const
+    {
+        // プールと TLS セッションキャッシュの統計は resetMetrics() 以降の増分を取り込む
+        MetricsSnapshot snapshot = m_metrics.snapshot();
+        auto poolStats = m_connectionPool->getStats();
+        snapshot.poolHits = poolStats.hits - m_poolStatsAtReset.hits;
+        snapshot.poolMisses = poolStats.misses - m_poolStatsAtReset.misses;
+        auto tlsStats = getTlsSessionStats();
+        snapshot.fullHandshakes = tlsStats.fullHandshakes - m_tlsStatsAtReset.fullHandshakes;
+        snapshot.resumedHandshakes = tlsStats.resumedHandshakes - m_tlsStatsAtReset.resumedHandshakes;
+        return snapshot;
+    }
+
+    void HttpClient::resetMetrics()
+    {
+        m_metrics.reset();
+        m_poolStatsAtReset = m_connectionPool->getStats();
+        m_tlsStatsAtReset = getTlsSessionStats();
+    }
+
+    Result<void> HttpClient::saveWarmState(ByteSink &sink) const
+    {
+        return m_connectionPool->exportWarmState().writeTo(sink);
+    }
+
+    Result<void> HttpClient::loadWarmState(ByteSource &source)
+    {
+        auto state = WarmState::readFrom(source);
+        if (state.isError())
+        {
+            return Result<void>(state.error());
+        }
+        m_connectionPool->importWarmState(state.value());
+        return Result<void>();
     }
 
     bool HttpClient::checkTimeout(const std::chrono::steady_clock::time_point &start,
@@ -63,290 +157,992 @@ namespace canaspad
 
     Result<HttpResult> HttpClient::send(const Request &request)
     {
-        Serial.println("HttpClient::send called");
-        Serial.printf("Initial request URL: %s\n", request.getUrl().c_str());
+        CANASPAD_LOGD("HttpClient::send - %s", request.getUrl().c_str());
         if (!m_isInitialized)
         {
-            return Result<HttpResult>(std::move(m_initializationError));
+            return Result<HttpResult>(m_initializationError);
         }
 
+        if (m_responseBodyCallback)
+        {
+            // ボディコールバックが設定されている場合はストリーミングで受信する
+            return sendWithRetries(request, 0, m_responseBodyCallback);
+        }
         return sendWithRetries(request);
     }
 
-    Result<HttpResult> HttpClient::sendWithRetries(const Request &request, int retryCount)
+    Result<HttpResult> HttpClient::send(const Request &request, Arena &arena)
+    {
+        CANASPAD_LOGD("HttpClient::send - %s (arena)", request.getUrl().c_str());
+        if (!m_isInitialized)
+        {
+            return Result<HttpResult>(m_initializationError);
+        }
+        return sendWithRetries(request, 0, m_responseBodyCallback, nullptr, &arena);
+    }
+
+    Result<PreparedRequest> HttpClient::prepare(const Request &request)
+    {
+        if (!request.getMultipartFormData().empty() || request.getBodySource())
+        {
+            // 本文は送信ごとに渡すため、multipart/form-data や BodySource は事前に組み立てられない
+            return Result<PreparedRequest>(ErrorInfo(ErrorCode::UnsupportedOperation, "Prepared requests do not support multipart form data or body sources."));
+        }
+
+        auto validationResult = RequestValidator::validate(request, m_options);
+        if (validationResult.isError())
+        {
+            return Result<PreparedRequest>(validationResult.error());
+        }
+
+        Request templateRequest = request;
+        templateRequest.setBody("");
+        std::string head;
+        appendRequestHead(templateRequest, head);
+        appendHeaders(templateRequest, head);
+        return Result<PreparedRequest>(PreparedRequest(std::move(templateRequest), std::move(head)));
+    }
+
+    Result<HttpResult> HttpClient::send(const PreparedRequest &request, const std::string &body)
+    {
+        CANASPAD_LOGD("HttpClient::send - %s (prepared)", request.getRequest().getUrl().c_str());
+        if (!m_isInitialized)
+        {
+            return Result<HttpResult>(m_initializationError);
+        }
+
+        PreparedSend prepared{request, body};
+        return sendWithRetries(request.getRequest(), 0, m_responseBodyCallback, &prepared);
+    }
+
+    AsyncResult HttpClient::sendAsync(Request request, AsyncResult::Callback onComplete)
+    {
+        CANASPAD_LOGD("HttpClient::sendAsync - %s", request.getUrl().c_str());
+        {
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            if (!m_workers)
+            {
+                WorkerPool::Options options;
+                options.workers = std::max<size_t>(1, m_options.asyncWorkers);
+                options.queueSize = m_options.asyncQueueSize;
+                options.stackSize = m_options.asyncWorkerStackSize;
+                options.priority = m_options.asyncWorkerPriority;
+                options.core = m_options.asyncWorkerCore;
+                m_workers = std::make_unique<WorkerPool>(options);
+            }
+        }
+
+        AsyncResult asyncResult = AsyncResult::create();
+        if (onComplete)
+        {
+            asyncResult.then(std::move(onComplete));
+        }
+        // 実行待ちの間も ID で取り消せるよう、ここで登録する
+        auto registration = std::make_shared<CancellationRegistry::Registration>(registerSend(request));
+        bool queued = m_workers->submit([this, asyncResult, registration, request = std::move(request)](bool discarded) mutable
+                                        {
+                                            if (discarded)
+                                            {
+                                                asyncResult.complete(ErrorInfo(ErrorCode::RequestCancelled, "Client destroyed before the request was sent"));
+                                                return;
+                                            }
+                                            asyncResult.complete(send(request)); });
+        if (!queued)
+        {
+            CANASPAD_LOGW("HttpClient::sendAsync - Queue is full");
+            asyncResult.complete(ErrorInfo(ErrorCode::QueueFull, "Too many requests waiting for a worker"));
+        }
+        return asyncResult;
+    }
+
+#if CANASPAD_HAS_COROUTINES
+
+    Task<Result<HttpResult>> HttpClient::sendCo(Request request)
+    {
+        CANASPAD_LOGD("HttpClient::sendCo - %s", request.getUrl().c_str());
+        if (!m_isInitialized)
+        {
+            co_return m_initializationError;
+        }
+
+        // 途中で他のコルーチンに切り替わるため、ヒープ確保の計測 (AllocationScope) は行わない
+        auto registration = registerSend(request);
+        RequestTiming timing;
+        timing.start = std::chrono::steady_clock::now();
+        for (int retryCount = 0;; ++retryCount)
+        {
+            timing.retries = retryCount;
+            auto result = co_await exchangeCo(request, &timing);
+            const auto &source = request.getBodySource();
+            if (result.isError() && isRetryable(result.error(), retryCount) && (!source || source->restart()))
+            {
+                CANASPAD_LOGI("HttpClient::sendCo - Retrying request (%d/%d)", retryCount + 1, m_options.maxRetries);
+                // 待っている間は他のコルーチンを進める
+                if (co_await waitBeforeRetryCo(request))
+                {
+                    continue;
+                }
+                result = cancelledError();
+            }
+
+            timing.end = std::chrono::steady_clock::now();
+            if (result.isSuccess())
+            {
+                result.value().timing = timing;
+                m_metrics.record(request.getParsedUrl().host(), result.value().statusCode, ErrorCode::None, timing);
+            }
+            else
+            {
+                result.error().timing = timing;
+                m_metrics.record(request.getParsedUrl().host(), 0, result.error().code, timing);
+            }
+            co_return std::move(result);
+        }
+    }
+
+    Task<Result<ResponseStream>> HttpClient::openCo(Request request)
+    {
+        CANASPAD_LOGD("HttpClient::openCo - %s", request.getUrl().c_str());
+        if (!m_isInitialized)
+        {
+            co_return m_initializationError;
+        }
+
+        // 返したストリームを読み終えるまで ID で取り消せるよう、登録はストリームに持たせる
+        auto registration = std::make_shared<CancellationRegistry::Registration>(registerSend(request));
+        RequestTiming timing;
+        timing.start = std::chrono::steady_clock::now();
+        for (int retryCount = 0;; ++retryCount)
+        {
+            timing.retries = retryCount;
+            auto result = co_await openWithRedirectsCo(request, &timing, registration);
+            const auto &source = request.getBodySource();
+            if (result.isError() && isRetryable(result.error(), retryCount) && (!source || source->restart()))
+            {
+                CANASPAD_LOGI("HttpClient::openCo - Retrying request (%d/%d)", retryCount + 1, m_options.maxRetries);
+                if (co_await waitBeforeRetryCo(request))
+                {
+                    continue;
+                }
+                result = cancelledError();
+            }
+
+            // 本文はまだ受け取っていないため、ヘッダーを受け取るまでを記録する
+            timing.end = std::chrono::steady_clock::now();
+            if (result.isSuccess())
+            {
+                result.value().mutableResult().timing = timing;
+                m_metrics.record(request.getParsedUrl().host(), result.value().statusCode(), ErrorCode::None, timing);
+            }
+            else
+            {
+                result.error().timing = timing;
+                m_metrics.record(request.getParsedUrl().host(), 0, result.error().code, timing);
+            }
+            co_return std::move(result);
+        }
+    }
+
+    Task<Result<std::shared_ptr<BufferedConnection>>> HttpClient::establishConnectionCo(const Request &request, RequestTiming *timing)
+    {
+        IoProgress progress = IoProgress::Failed;
+        auto connectionResult = beginConnection(request, timing, progress);
+        if (connectionResult.isError())
+        {
+            co_return connectionResult.error();
+        }
+        auto connection = connectionResult.value();
+        if (!connection)
+        {
+            co_return ErrorInfo(ErrorCode::NetworkError, "Failed to get connection from pool");
+        }
+        if (progress == IoProgress::Done)
+        {
+            co_return connection;
+        }
+
+        const CancellationToken &token = request.getCancellationToken();
+        auto deadline = std::chrono::steady_clock::now() + m_timeouts.connect;
+        while (progress == IoProgress::WantRead || progress == IoProgress::WantWrite)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (token.cancelled() || now >= deadline)
+            {
+                progress = IoProgress::Failed;
+                break;
+            }
+            // 他のタスクからの取り消しに気付けるよう、待ち時間を区切る
+            auto wake = token.valid() ? std::min(deadline, now + CancellationToken::kCheckInterval) : deadline;
+            co_await Scheduler::connectProgress(connection->nativeHandle(), progress, wake);
+            progress = connection->continueConnect();
+        }
+
+        auto finished = finishConnection(connection.get(), request, progress, deadline, timing);
+        if (finished.isError())
+        {
+            m_connectionPool->releaseConnection(connection, false);
+            co_return finished.error();
+        }
+        co_return connection;
+    }
+
+    Task<Result<void>> HttpClient::writeRequestCo(Connection *connection, const Request &request)
+    {
+        const CancellationToken &token = request.getCancellationToken();
+        PendingWrite pending;
+        startWrite(request, pending);
+        auto deadline = std::chrono::steady_clock::now() + m_timeouts.write;
+        while (true)
+        {
+            auto step = writeStep(connection, request, pending, deadline);
+            if (step.isError())
+            {
+                co_return step.error();
+            }
+            if (step.value() == IoProgress::Done)
+            {
+                co_return Result<void>();
+            }
+            if (token.cancelled())
+            {
+                co_return cancelledError();
+            }
+            // 送信バッファが空くまで他のコルーチンを進める
+            auto now = std::chrono::steady_clock::now();
+            auto wake = token.valid() ? std::min(deadline, now + CancellationToken::kCheckInterval) : deadline;
+            co_await Scheduler::writable(connection->nativeHandle(), wake);
+        }
+    }
+
+    Task<bool> HttpClient::waitBeforeRetryCo(const Request &request) const
+    {
+        const CancellationToken &token = request.getCancellationToken();
+        if (!token.valid())
+        {
+            co_await Scheduler::sleep(m_options.retryDelay);
+            co_return true;
+        }
+        auto until = std::chrono::steady_clock::now() + m_options.retryDelay;
+        while (!token.cancelled())
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= until)
+            {
+                co_return true;
+            }
+            co_await Scheduler::sleepUntil(std::min<std::chrono::steady_clock::time_point>(until, now + CancellationToken::kCheckInterval));
+        }
+        co_return false;
+    }
+
+    Task<Result<HttpResult>> HttpClient::exchangeCo(const Request &request, RequestTiming *timing)
+    {
+        auto opened = co_await openWithRedirectsCo(request, timing);
+        if (opened.isError())
+        {
+            co_return opened.error();
+        }
+
+        ResponseStream stream = std::move(opened).value();
+        std::string body;
+        while (true)
+        {
+            auto chunk = co_await stream.next();
+            if (chunk.isError())
+            {
+                co_return chunk.error();
+            }
+            if (chunk.value().empty())
+            {
+                break;
+            }
+            body.append(chunk.value().data(), chunk.value().size());
+        }
+        if (timing)
+        {
+            timing->responseEnd = std::chrono::steady_clock::now();
+        }
+
+        HttpResult result = std::move(stream.mutableResult());
+        result.body = std::move(body);
+        co_return std::move(result);
+    }
+
+    Task<Result<ResponseStream>> HttpClient::openWithRedirectsCo(const Request &request, RequestTiming *timing,
+                                                                 std::shared_ptr<CancellationRegistry::Registration> registration)
     {
-        Serial.printf("HttpClient::sendWithRetries called. Retry count: %d\n", retryCount);
-        Serial.printf("Request URL: %s\n", request.getUrl().c_str());
-        auto result = sendWithRedirects(request);
+        const Request *current = &request;
+        Request redirectRequest;
+        for (int redirectCount = 0;; ++redirectCount)
+        {
+            CANASPAD_LOGD("HttpClient::openWithRedirectsCo - Redirect count: %d, URL: %s", redirectCount, current->getUrl().c_str());
+            if (current->getCancellationToken().cancelled())
+            {
+                co_return cancelledError();
+            }
+            auto validationResult = RequestValidator::validate(*current, m_options);
+            if (validationResult.isError())
+            {
+                co_return validationResult.error();
+            }
+            const auto &source = current->getBodySource();
+            if (source && !source->restart())
+            {
+                co_return ErrorInfo(ErrorCode::InvalidBody, "Request body source cannot be rewound to send it again");
+            }
+
+            if (timing)
+            {
+                timing->resetAttempt();
+                timing->redirects = redirectCount;
+            }
+            // 接続の確立と書き込みは他のコルーチンを進めながら行う (プールの接続を再利用する場合は確立を省く)
+            auto connectionResult = co_await establishConnectionCo(*current, timing);
+            if (connectionResult.isError())
+            {
+                co_return connectionResult.error();
+            }
+            auto connection = connectionResult.value();
+
+            std::function<void()> onFinished;
+            auto mockConnection = m_useMock ? static_cast<MockWiFiClientSecure *>(m_mockConnection.get()) : nullptr;
+            if (mockConnection || registration)
+            {
+                // 読み終えた時点で ID の登録を外す
+                onFinished = [mockConnection, registration]() mutable
+                {
+                    if (mockConnection)
+                    {
+                        mockConnection->moveToNextResponse();
+                    }
+                    registration.reset();
+                };
+            }
+            ResponseStream stream = ResponseStream::open(*m_connectionPool, m_metrics, connection, current->getMethod(), m_timeouts.read,
+                                                         current->getCancellationToken(), std::move(onFinished));
+
+            auto writeResult = co_await writeRequestCo(connection.get(), *current);
+            if (writeResult.isError())
+            {
+                co_return writeResult.error();
+            }
+            if (timing)
+            {
+                timing->requestSent = std::chrono::steady_clock::now();
+            }
+
+            // ヘッダーが届くまでは他のコルーチンを進める
+            auto headResult = co_await stream.readHead(timing);
+            if (headResult.isError())
+            {
+                co_return headResult.error();
+            }
+            HttpResult &head = stream.mutableResult();
+            storeCookies(*current, head);
+
+            if (head.statusCode >= 300 && head.statusCode < 400 && m_options.followRedirects)
+            {
+                auto location = Utils::extractHeaderValue(head.headers, HeaderNames::Location);
+                if (location.empty())
+                {
+                    co_return ErrorInfo(ErrorCode::InvalidResponse, "Redirect location not found");
+                }
+                if (redirectCount >= m_options.maxRedirects)
+                {
+                    co_return ErrorInfo(ErrorCode::TooManyRedirects, "Too many redirects");
+                }
+
+                // リダイレクトのボディは読み捨て、接続をプールへ返してから次へ進む
+                while (true)
+                {
+                    auto chunk = co_await stream.next();
+                    if (chunk.isError())
+                    {
+                        co_return chunk.error();
+                    }
+                    if (chunk.value().empty())
+                    {
+                        break;
+                    }
+                }
+                redirectRequest = makeRedirectRequest(*current, nullptr, std::move(location));
+                current = &redirectRequest;
+                continue;
+            }
+            co_return std::move(stream);
+        }
+    }
+
+#endif // CANASPAD_HAS_COROUTINES
+
+    Result<HttpResult> HttpClient::sendWithRetries(const Request &request, int retryCount, const ChunkCallback &bodyCallback, const PreparedSend *prepared, Arena *arena, RequestTiming *timing)
+    {
+        CANASPAD_LOGD("HttpClient::sendWithRetries - Retry count: %d", retryCount);
+
+        // 最初の呼び出しで、リトライとリダイレクトを含む送信全体のヒープ確保と時刻を計測する
+        std::optional<AllocationScope> allocations;
+        RequestTiming rootTiming;
+        CancellationRegistry::Registration registration;
+        std::optional<Request> sendRequest; // 送信ごとのトークンを持たせたコピー (ID を持つ場合のみ)
+        if (retryCount == 0)
+        {
+            allocations.emplace();
+            if (!request.getId().empty())
+            {
+                sendRequest.emplace(request);
+                registration = registerSend(*sendRequest);
+            }
+            rootTiming.start = std::chrono::steady_clock::now();
+            timing = &rootTiming;
+        }
+        const Request &current = sendRequest ? *sendRequest : request;
+        timing->retries = retryCount;
+
+        // 一度でもボディを渡した後はリトライすると重複して渡してしまうため記録する
+        bool bodyDelivered = false;
+        ChunkCallback trackedCallback;
+        if (bodyCallback)
+        {
+            trackedCallback = [&bodyDelivered, &bodyCallback](const char *data, size_t size)
+            {
+                bodyDelivered = true;
+                bodyCallback(data, size);
+            };
+        }
+        auto result = sendWithRedirects(current, 0, trackedCallback, prepared, arena, timing);
 
         if (result.isError())
         {
             const auto &error = result.error();
-            Serial.printf("Error encountered: Code %d, Message: %s\n", static_cast<int>(error.code), error.message.c_str());
+            CANASPAD_LOGW("HttpClient::sendWithRetries - Error %d: %s", static_cast<int>(error.code), error.message.c_str());
 
-            // Timeout の場合もリトライ対象に含める
-            if ((error.code == ErrorCode::NetworkError || error.code == ErrorCode::Timeout) &&
-                retryCount < m_options.maxRetries)
+            // 巻き戻せない BodySource を読み始めていた場合は送り直せない
+            const auto &source = current.getBodySource();
+            if (isRetryable(error, retryCount) && !bodyDelivered &&
+                (prepared || !source || source->restart()))
             {
-                Serial.println("Retrying request...");
+                CANASPAD_LOGI("HttpClient::sendWithRetries - Retrying request (%d/%d)", retryCount + 1, m_options.maxRetries);
                 // リトライ前に遅延を追加
-                std::this_thread::sleep_for(m_options.retryDelay);
+                result = waitBeforeRetry(current)
+                             ? sendWithRetries(current, retryCount + 1, bodyCallback, prepared, arena, timing)
+                             : Result<HttpResult>(cancelledError());
+            }
+        }
 
-                return sendWithRetries(request, retryCount + 1);
+        if (retryCount == 0)
+        {
+            rootTiming.end = std::chrono::steady_clock::now();
+            if (result.isSuccess())
+            {
+                result.value().allocations = allocations->stats();
+                result.value().timing = rootTiming;
+                m_metrics.record(current.getParsedUrl().host(), result.value().statusCode, ErrorCode::None, rootTiming);
+            }
+            else
+            {
+                result.error().timing = rootTiming;
+                m_metrics.record(current.getParsedUrl().host(), 0, result.error().code, rootTiming);
             }
         }
         return result;
     }
 
-    Result<HttpResult> HttpClient::sendWithRedirects(const Request &request, int redirectCount)
+    Result<HttpResult> HttpClient::sendWithRedirects(const Request &request, int redirectCount, const ChunkCallback &bodyCallback, const PreparedSend *prepared, Arena *arena, RequestTiming *timing)
     {
-        Serial.printf("HttpClient::sendWithRedirects called. Redirect count: %d\n", redirectCount);
-        Serial.printf("Current request URL: %s\n", request.getUrl().c_str());
-        auto modifiedRequest = request;
+        CANASPAD_LOGD("HttpClient::sendWithRedirects - Redirect count: %d, URL: %s", redirectCount, request.getUrl().c_str());
+        if (request.getCancellationToken().cancelled())
+        {
+            return Result<HttpResult>(cancelledError());
+        }
+
+        // 作成済みのリクエストは prepare() で検証を済ませている
+        // 認証情報はヘッダーの組み立て時に付け加えるため、リクエスト (と本文) はコピーしない
+        if (!prepared)
+        {
+            // 各種設定のバリデーション
+            auto validationResult = RequestValidator::validate(request, m_options);
+            if (validationResult.isError())
+            {
+                CANASPAD_LOGW("HttpClient::sendWithRedirects - Request validation failed: %s", validationResult.error().message.c_str());
+                return Result<HttpResult>(validationResult.error());
+            }
 
-        // 認証情報を適用
-        m_auth->applyAuthentication(modifiedRequest);
+            // 読み出し済みの本文は巻き戻せる場合のみ送り直す
+            const auto &source = request.getBodySource();
+            if (source && !source->restart())
+            {
+                return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidBody, "Request body source cannot be rewound to send it again"));
+            }
+        }
 
         // 接続の確立
-        auto connectionResult = establishConnection(modifiedRequest);
+        if (timing)
+        {
+            timing->resetAttempt();
+            timing->redirects = redirectCount;
+        }
+        auto connectionResult = establishConnection(request, timing);
         if (connectionResult.isError())
         {
-            Serial.println("HttpClient::sendWithRedirects - Connection establishment failed");
+            CANASPAD_LOGW("HttpClient::sendWithRedirects - Connection establishment failed: %s", connectionResult.error().message.c_str());
             return Result<HttpResult>(connectionResult.error());
         }
         auto connection = connectionResult.value();
+        ConnectionLease lease(*m_connectionPool, connection, m_metrics);
 
-        std::string requestStr = buildRequestString(modifiedRequest);
-        Serial.printf("HttpClient::sendWithRedirects - Request string built. Length: %zu\n", requestStr.length());
+        // ヘッダー部分と本文は別々の断片として書き込み、本文をヘッダーの文字列へコピーしない
+        std::string head = prepared ? buildRequestHead(*prepared) : buildRequestHead(request);
+        const std::string &body = prepared ? prepared->body : request.getBody();
+        CANASPAD_LOGV("HttpClient::sendWithRedirects - Request head built. Length: %zu, body: %zu", head.length(), body.length());
 
-        // 各種設定のバリデーション
-        auto validationResult = RequestValidator::validate(modifiedRequest, m_options);
-        if (validationResult.isError())
+        auto writeResult = writeRequest(connection.get(), head, body, prepared ? nullptr : request.getBodySource().get(), request.getCancellationToken());
+        if (writeResult.isError())
+        {
+            CANASPAD_LOGW("HttpClient::sendWithRedirects - Failed to send request: %s", writeResult.error().message.c_str());
+            return Result<HttpResult>(writeResult.error());
+        }
+        if (timing)
+        {
+            timing->requestSent = std::chrono::steady_clock::now();
+        }
+
+        bool reusable = false;
+        auto responseResult = readResponse(connection.get(), request, bodyCallback, &reusable, arena, timing);
+        if (responseResult.isError())
+        {
+            CANASPAD_LOGW("HttpClient::sendWithRedirects - Failed to read response: %s", responseResult.error().message.c_str());
+            return responseResult;
+        }
+
+        auto httpResult = std::move(responseResult).value();
+        CANASPAD_LOGD("HttpClient::sendWithRedirects - Status: %d %s, Body length: %zu",
+                      httpResult.statusCode, httpResult.statusMessage.c_str(), httpResult.body.length());
+
+        storeCookies(request, httpResult);
+
+        // リダイレクト処理#1
+        // リダイレクト回数が最大を超えているかを確認
+        // レスポンスを読み終えたので接続をプールへ返却する
+        lease.release(reusable);
+
+        if (redirectCount >= m_options.maxRedirects)
+        {
+            CANASPAD_LOGW("HttpClient::sendWithRedirects - Too many redirects");
+            return Result<HttpResult>(ErrorInfo(ErrorCode::TooManyRedirects, "Too many redirects"));
+        }
+
+        // 200 OKのレスポンスを正常に処理
+        if (httpResult.statusCode >= 200 && httpResult.statusCode < 300)
+        {
+            return Result<HttpResult>(std::move(httpResult));
+        }
+
+        if (httpResult.statusCode >= 300 && httpResult.statusCode < 400)
+        {
+            if (m_options.followRedirects)
+            {
+                auto location = Utils::extractHeaderValue(httpResult.headers, HeaderNames::Location);
+                if (!location.empty())
+                {
+                    CANASPAD_LOGD("HttpClient::sendWithRedirects - Redirecting to: %s", location.c_str());
+                    Request redirectRequest = makeRedirectRequest(request, prepared, std::move(location));
+
+                    // 元の接続はプールへ返却済み。リダイレクト先へ再帰的に送信する
+                    return sendWithRedirects(redirectRequest, redirectCount + 1, bodyCallback, nullptr, arena, timing);
+                }
+                else
+                {
+                    CANASPAD_LOGW("HttpClient::sendWithRedirects - Redirect location not found");
+                    return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidResponse, "Redirect location not found"));
+                }
+            }
+            else
+            {
+                CANASPAD_LOGD("HttpClient::sendWithRedirects - Redirect function is disabled");
+            }
+        }
+
+        CANASPAD_LOGD("HttpClient::sendWithRedirects - Unhandled status code: %d", httpResult.statusCode);
+        return Result<HttpResult>(std::move(httpResult));
+    }
+
+    bool HttpClient::isRetryable(const ErrorInfo &error, int retryCount) const
+    {
+        // Timeout の場合もリトライ対象に含める
+        return (error.code == ErrorCode::NetworkError || error.code == ErrorCode::Timeout) &&
+               retryCount < m_options.maxRetries;
+    }
+
+    bool HttpClient::waitBeforeRetry(const Request &request) const
+    {
+        const CancellationToken &token = request.getCancellationToken();
+        if (!token.valid())
+        {
+            platform::sleepFor(m_options.retryDelay);
+            return true;
+        }
+        auto until = std::chrono::steady_clock::now() + m_options.retryDelay;
+        while (!token.cancelled())
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= until)
+            {
+                return true;
+            }
+            platform::sleepFor(std::chrono::ceil<std::chrono::milliseconds>(std::min<std::chrono::steady_clock::duration>(until - now, CancellationToken::kCheckInterval)));
+        }
+        return false;
+    }
+
+    void HttpClient::storeCookies(const Request &request, HttpResult &result)
+    {
+        if (!m_cookiesEnabled)
+        {
+            return;
+        }
+        for (const auto &setCookieHeader : Utils::extractHeaders(result.headers, HeaderNames::SetCookie))
+        {
+            Cookie cookie;
+            Utils::parseCookie(setCookieHeader, cookie, request.getParsedUrl());
+            result.cookies.push_back(cookie);
+            m_connectionPool->getCookieJar()->setCookie(request.getParsedUrl(), setCookieHeader);
+        }
+    }
+
+    Request HttpClient::makeRedirectRequest(const Request &request, const PreparedSend *prepared, std::string location) const
+    {
+        if (location.find("://") == std::string::npos)
+        {
+            location.insert(0, request.getParsedUrl().origin());
+        }
+
+        Request redirectRequest;
+        redirectRequest.setUrl(location);
+        redirectRequest.setMethod(request.getMethod());
+        redirectRequest.setBody(prepared ? prepared->body : request.getBody());
+        // リダイレクト先も同じ ID とトークンで取り消せる
+        redirectRequest.setCancellationToken(request.getCancellationToken());
+        if (!request.getId().empty())
+        {
+            redirectRequest.setId(request.getId());
+        }
+        if (!prepared && request.getBodySource())
+        {
+            redirectRequest.setBodySource(request.getBodySource());
+            // multipart/form-data の境界文字列は Content-Type に含まれる
+            auto contentType = request.getHeaders().find(HeaderNames::ContentType);
+            if (contentType != request.getHeaders().end())
+            {
+                redirectRequest.addHeader(std::string(contentType->name), std::string(contentType->value));
+            }
+        }
+        return redirectRequest;
+    }
+
+    Result<std::shared_ptr<BufferedConnection>> HttpClient::establishConnection(const Request &request, RequestTiming *timing)
+    {
+        const Url &url = request.getParsedUrl();
+        std::string host(url.host());
+        int port = url.port();
+
+        // プロキシ経由ではプロキシまでの接続の scheme で接続を選ぶ
+        std::string scheme(m_options.proxyUrl.empty() ? url.scheme() : m_proxyUrl.scheme());
+        auto pooled = m_connectionPool->getConnection(scheme, host, port);
+        if (pooled.isError())
+        {
+            return pooled;
+        }
+        auto connection = pooled.value();
+        if (!connection)
+        {
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to get connection from pool"));
+        }
+
+        if (connection->isConnected())
+        {
+            // プールから再利用した接続はハンドシェイク (プロキシの場合はトンネル) 済み
+            if (timing)
+            {
+                timing->connectionReused = true;
+            }
+            return Result<std::shared_ptr<BufferedConnection>>(connection);
+        }
+
+        auto result = !m_options.proxyUrl.empty()
+                          ? establishProxyConnection(connection, request)
+                          : establishDirectConnection(connection, host, port, request.getCancellationToken());
+        if (timing)
+        {
+            // 失敗した場合も途中までの段階を記録する
+            connection->getConnectTiming(timing->connect);
+        }
+        if (result.isError())
+        {
+            m_connectionPool->releaseConnection(connection, false);
+        }
+        return result;
+    }
+
+    Result<std::shared_ptr<BufferedConnection>> HttpClient::beginConnection(const Request &request, RequestTiming *timing, IoProgress &progress)
+    {
+        progress = IoProgress::Done;
+        if (!m_options.proxyUrl.empty())
+        {
+            // プロキシ経由の接続 (CONNECT によるトンネルを含む) は確立するまで待つ
+            return establishConnection(request, timing);
+        }
+
+        const Url &url = request.getParsedUrl();
+        std::string host(url.host());
+        int port = url.port();
+        auto pooled = m_connectionPool->getConnection(std::string(url.scheme()), host, port);
+        if (pooled.isError() || !pooled.value())
         {
-            Serial.println("HttpClient::sendWithRedirects - Request validation failed");
-            return Result<HttpResult>(validationResult.error());
+            return pooled;
         }
-
-        auto writeStart = std::chrono::steady_clock::now();
-        if (connection->write(reinterpret_cast<const uint8_t *>(requestStr.c_str()), requestStr.length()) != requestStr.length())
+        auto connection = pooled.value();
+        if (connection->isConnected())
         {
-            auto writeDuration = std::chrono::steady_clock::now() - writeStart;
-            if (writeDuration > m_timeouts.write)
+            // プールから再利用した接続はハンドシェイク済み
+            if (timing)
             {
-                Serial.println("HttpClient::sendWithRedirects - Write operation timed out");
-                return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Write operation timed out"));
+                timing->connectionReused = true;
             }
-            Serial.println("HttpClient::sendWithRedirects - Failed to send request");
-            return Result<HttpResult>(ErrorInfo(ErrorCode::NetworkError, "Failed to send request"));
+            return pooled;
         }
-        Serial.println("HttpClient::sendWithRedirects - Request sent successfully");
 
-        auto responseResult = readResponse(connection.get(), modifiedRequest);
-        Serial.println("HttpClient::sendWithRedirects - Response Result:");
-        if (responseResult.isSuccess())
+        applyWarmState(connection.get(), host, port);
+        auto deadline = std::chrono::steady_clock::now() + m_timeouts.connect;
+        progress = connection->beginConnect(host, port);
+        if (progress == IoProgress::WantRead || progress == IoProgress::WantWrite)
         {
-            const auto &httpResult = responseResult.value();
-            Serial.printf("Status Code: %d\n", httpResult.statusCode);
-            Serial.printf("Status Message: %s\n", httpResult.statusMessage.c_str());
-            Serial.printf("Body length: %zu\n", httpResult.body.length());
+            return pooled;
         }
-        else
+        auto finished = finishConnection(connection.get(), request, progress, deadline, timing);
+        if (finished.isError())
         {
-            Serial.printf("Error: %s\n", responseResult.error().message.c_str());
+            m_connectionPool->releaseConnection(connection, false);
+            return Result<std::shared_ptr<BufferedConnection>>(finished.error());
         }
+        progress = IoProgress::Done;
+        return pooled;
+    }
 
-        if (responseResult.isError())
+    Result<void> HttpClient::finishConnection(Connection *connection, const Request &request, IoProgress progress,
+                                              std::chrono::steady_clock::time_point deadline, RequestTiming *timing)
+    {
+        if (timing)
         {
-            Serial.println("HttpClient::sendWithRedirects responseResult.isError() true");
-            return responseResult;
+            // 失敗した場合も途中までの段階を記録する
+            connection->getConnectTiming(timing->connect);
         }
-
-        auto httpResult = responseResult.value();
-
-        // クッキー処理
-        if (m_cookiesEnabled)
+        if (request.getCancellationToken().cancelled())
         {
-            Serial.println("HttpClient::sendWithRedirects - Processing cookies");
-            for (const auto &setCookieHeader : Utils::extractHeaders(httpResult.headers, "Set-Cookie"))
-            {
-                Cookie cookie;
-                Utils::parseCookie(setCookieHeader, cookie, modifiedRequest.getUrl());
-                httpResult.cookies.push_back(cookie);
-                m_connectionPool->getCookieJar()->setCookie(modifiedRequest.getUrl(), setCookieHeader);
-            }
+            // 接続先の問題ではないため、名前解決の結果と TLS セッションは残す
+            connection->disconnect();
+            return Result<void>(cancelledError());
         }
 
-        // リダイレクト処理#1
-        // リダイレクト回数が最大を超えているかを確認
-        if (redirectCount >= m_options.maxRedirects)
+        const Url &url = request.getParsedUrl();
+        std::string host(url.host());
+        bool connected = progress == IoProgress::Done;
+        storeWarmState(connection, host, url.port(), connected);
+        if (connected)
         {
-            Serial.println("HttpClient::sendWithRedirects - Too many redirects");
-            return Result<HttpResult>(ErrorInfo(ErrorCode::TooManyRedirects, "Too many redirects"));
+            return Result<void>();
         }
+        connection->disconnect();
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return Result<void>(ErrorInfo(ErrorCode::Timeout, "Connection timed out"));
+        }
+        return Result<void>(ErrorInfo(ErrorCode::NetworkError, "Failed to connect to " + host));
+    }
 
-        Serial.printf("HttpClient::sendWithRedirects - Received status code: %d\n", httpResult.statusCode);
-
-        // 200 OKのレスポンスを正常に処理
-        if (httpResult.statusCode >= 200 && httpResult.statusCode < 300)
+    void HttpClient::startWrite(const Request &request, PendingWrite &pending)
+    {
+        pending.head = buildRequestHead(request);
+        const std::string &body = request.getBody();
+        pending.bodyInHead = body.size() <= Connection::kWriteCoalesceSize;
+        if (pending.bodyInHead)
         {
-            Serial.println("HttpClient::sendWithRedirects - Successful response (200-299)");
-            return Result<HttpResult>(std::move(httpResult));
+            pending.head += body;
         }
+        pending.written = 0;
+    }
 
-        if (httpResult.statusCode >= 300 && httpResult.statusCode < 400)
+    Result<IoProgress> HttpClient::writeStep(Connection *connection, const Request &request, PendingWrite &pending,
+                                             std::chrono::steady_clock::time_point &deadline)
+    {
+        const std::string &head = pending.head;
+        const std::string &body = request.getBody();
+        size_t total = head.size() + (pending.bodyInHead ? 0 : body.size());
+        while (pending.written < total)
         {
-            if (m_options.followRedirects)
+            const bool inHead = pending.written < head.size();
+            const char *data = inHead ? head.data() + pending.written : body.data() + (pending.written - head.size());
+            size_t size = inHead ? head.size() - pending.written : total - pending.written;
+            size_t n = connection->writeSome(reinterpret_cast<const uint8_t *>(data), size);
+            auto now = std::chrono::steady_clock::now();
+            if (n == 0)
             {
-                Serial.println("HttpClient::sendWithRedirects - Redirect detected (300-399)");
-
-                auto location = Utils::extractHeaderValue(httpResult.headers, "Location");
-                if (!location.empty())
+                if (!connection->connected())
                 {
-                    if (location.find("://") == std::string::npos)
-                    {
-                        std::string baseUrl = Utils::extractBaseUrl(request.getUrl());
-                        location = baseUrl + location;
-                    }
-
-                    Serial.printf("HttpClient::sendWithRedirects - Redirecting to: %s\n", location.c_str());
-
-                    Request redirectRequest;
-                    redirectRequest.setUrl(location);
-                    redirectRequest.setMethod(request.getMethod());
-                    redirectRequest.setBody(request.getBody());
-
-                    // 新しい接続を確立
-                    auto redirectConnectionResult = establishConnection(redirectRequest);
-                    if (redirectConnectionResult.isError())
-                    {
-                        Serial.println("HttpClient::sendWithRedirects - Failed to establish connection for redirect");
-                        return Result<HttpResult>(redirectConnectionResult.error());
-                    }
-                    auto redirectConnection = redirectConnectionResult.value();
-
-                    // 新しいリクエストを書き込む
-                    std::string redirectRequestStr = buildRequestString(redirectRequest);
-                    Serial.printf("HttpClient::sendWithRedirects - Redirect request string built. Length: %zu\n", redirectRequestStr.length());
-                    Serial.printf("HttpClient::sendWithRedirects - Redirect request: %s\n", redirectRequestStr.c_str());
-                    auto writeStart = std::chrono::steady_clock::now();
-                    if (redirectConnection->write(reinterpret_cast<const uint8_t *>(redirectRequestStr.c_str()), redirectRequestStr.length()) != redirectRequestStr.length())
-                    {
-                        auto writeDuration = std::chrono::steady_clock::now() - writeStart;
-                        if (writeDuration > m_timeouts.write)
-                        {
-                            Serial.println("HttpClient::sendWithRedirects - Write operation timed out for redirect");
-                            return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Write operation timed out for redirect"));
-                        }
-                        Serial.println("HttpClient::sendWithRedirects - Failed to send redirect request");
-                        return Result<HttpResult>(ErrorInfo(ErrorCode::NetworkError, "Failed to send redirect request"));
-                    }
-
-                    Serial.println("HttpClient::sendWithRedirects - Redirect request sent successfully");
-
-                    // リダイレクト先からのレスポンスを読み取る
-                    auto redirectResponseResult = readResponse(redirectConnection.get(), redirectRequest);
-                    if (redirectResponseResult.isError())
-                    {
-                        Serial.println("HttpClient::sendWithRedirects - Failed to read redirect response");
-                        return redirectResponseResult;
-                    }
-
-                    // 成功レスポンス（200-299）の場合は、そのレスポンスを返す
-                    if (redirectResponseResult.value().statusCode >= 200 && redirectResponseResult.value().statusCode < 300)
-                    {
-                        Serial.println("HttpClient::sendWithRedirects - Successful response after redirect");
-                        return redirectResponseResult;
-                    }
-
-                    // リダイレクトの場合
-                    if (redirectResponseResult.value().statusCode >= 300 && redirectResponseResult.value().statusCode < 400)
-                    {
-                        Serial.println("HttpClient::sendWithRedirects - Redirect after redirect");
-                        // TODO redirectResponseResultの情報を使って再帰的に処理したい、しかしながら関数がうまく分割されていないのでリダイレクト処理#1に戻ることが出来ない。
-                    }
-
-                    // それ以外の場合は再帰的に処理
-                    return sendWithRedirects(redirectRequest, redirectCount + 1);
+                    return Result<IoProgress>(ErrorInfo(ErrorCode::NetworkError, "Failed to send request"));
                 }
-                else
+                if (now >= deadline)
                 {
-                    Serial.println("HttpClient::sendWithRedirects - Redirect location not found");
-                    return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidResponse, "Redirect location not found"));
+                    return Result<IoProgress>(ErrorInfo(ErrorCode::Timeout, "Write operation timed out"));
                 }
+                // 送信バッファが空くのを待つ
+                return Result<IoProgress>(IoProgress::WantWrite);
             }
-            else
+            pending.written += n;
+            deadline = now + m_timeouts.write;
+        }
+
+        if (!body.empty() && m_progressCallback)
+        {
+            m_progressCallback(body.size(), body.size());
+        }
+        if (const auto &source = request.getBodySource())
+        {
+            // BodySource の本文は読み出しながら送るため、書き終えるまで待つ
+            auto result = writeBodySource(connection, *source, request.getCancellationToken());
+            if (result.isError())
             {
-                Serial.println("HttpClient::sendWithRedirects - Redirect function is disabled");
+                return Result<IoProgress>(result.error());
             }
         }
+        return Result<IoProgress>(IoProgress::Done);
+    }
 
-        Serial.printf("HttpClient::sendWithRedirects - Unhandled status code: %d\n", httpResult.statusCode);
-        return Result<HttpResult>(std::move(httpResult));
+    bool HttpClient::connectWithWarmState(Connection *connection, const std::string &host, int port, const CancellationToken &token)
+    {
+        applyWarmState(connection, host, port);
+        bool connected = token.valid() ? connectUnlessCancelled(connection, host, port, token) : connection->connect(host, port);
+        if (token.cancelled())
+        {
+            // 接続先の問題ではないため、名前解決の結果と TLS セッションは残す
+            connection->disconnect();
+            return false;
+        }
+        storeWarmState(connection, host, port, connected);
+        return connected;
     }
 
-    Result<std::shared_ptr<Connection>> HttpClient::establishConnection(const Request &request)
+    bool HttpClient::connectUnlessCancelled(Connection *connection, const std::string &host, int port, const CancellationToken &token)
     {
-        std::string host = Utils::extractHost(request.getUrl());
-        int port = Utils::extractPort(request.getUrl());
+        auto deadline = std::chrono::steady_clock::now() + m_timeouts.connect;
+        // 試行ごとに戻る接続 (WiFiClientSecure) では、試行の間の待ち時間に確かめる
+        IoProgress progress = connection->beginConnect(host, port);
+        while (progress == IoProgress::WantRead || progress == IoProgress::WantWrite)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (token.cancelled() || now >= deadline)
+            {
+                progress = IoProgress::Failed;
+                break;
+            }
+            waitForHandle(connection->nativeHandle(), progress == IoProgress::WantWrite, std::min(deadline, now + CancellationToken::kCheckInterval));
+            progress = connection->continueConnect();
+        }
+        if (progress != IoProgress::Done)
+        {
+            connection->disconnect();
+            return false;
+        }
+        return true;
+    }
 
-        std::shared_ptr<Connection> connection;
-        if (m_useMock)
+    void HttpClient::applyWarmState(Connection *connection, const std::string &host, int port)
+    {
+        // 解決済みのアドレスがあれば名前解決を省略する
+        uint32_t address = 0;
+        if (m_connectionPool->getDnsCache()->lookup(host, address))
         {
-            connection = m_mockConnection;
+            connection->setResolvedAddress(address);
         }
-        else
+
+        // 前回のセッションを提示して簡略ハンドシェイクを試みる
+        std::vector<uint8_t> session;
+        if (m_connectionPool->getTlsSessionCache()->lookup(TlsSessionCache::makeKey(host, port), session))
         {
-            connection = m_connectionPool->getConnection(host, port);
+            connection->setTlsSession(session);
         }
+    }
 
-        if (!connection)
+    void HttpClient::storeWarmState(Connection *connection, const std::string &host, int port, bool connected)
+    {
+        auto sessionCache = m_connectionPool->getTlsSessionCache();
+        auto dnsCache = m_connectionPool->getDnsCache();
+        std::string key = TlsSessionCache::makeKey(host, port);
+
+        if (!connected)
         {
-            return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to get connection from pool"));
+            // 拒否された可能性のあるセッションと古い可能性のあるアドレスは次回使わない
+            sessionCache->remove(key);
+            dnsCache->remove(host);
+            return;
         }
 
-        if (!m_options.proxyUrl.empty())
+        uint32_t address = 0;
+        if (connection->getResolvedAddress(address))
         {
-            return establishProxyConnection(connection, request);
+            dnsCache->store(host, address);
         }
-        else
+
+        sessionCache->recordHandshake(connection->isTlsSessionResumed());
+        std::vector<uint8_t> session;
+        if (connection->getTlsSession(session))
         {
-            return establishDirectConnection(connection, host, port);
+            sessionCache->store(key, std::move(session));
         }
     }
 
-    Result<std::shared_ptr<Connection>> HttpClient::establishDirectConnection(std::shared_ptr<Connection> connection, const std::string &host, int port)
+    Result<std::shared_ptr<BufferedConnection>> HttpClient::establishDirectConnection(std::shared_ptr<BufferedConnection> connection, const std::string &host, int port, const CancellationToken &token)
     {
         auto connectStart = std::chrono::steady_clock::now();
-        if (!connection->connect(host, port))
+        if (!connectWithWarmState(connection.get(), host, port, token))
         {
+            if (token.cancelled())
+            {
+                return Result<std::shared_ptr<BufferedConnection>>(cancelledError());
+            }
             auto connectDuration = std::chrono::steady_clock::now() - connectStart;
             if (connectDuration > m_timeouts.connect)
             {
-                return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::Timeout, "Connection timed out"));
+                return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::Timeout, "Connection timed out"));
             }
-            return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to connect to " + host));
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to connect to " + host));
         }
-        return Result<std::shared_ptr<Connection>>(connection);
+        return Result<std::shared_ptr<BufferedConnection>>(connection);
     }
 
-    Result<std::shared_ptr<Connection>> HttpClient::establishProxyConnection(std::shared_ptr<Connection> connection, const Request &request)
+    Result<std::shared_ptr<BufferedConnection>> HttpClient::establishProxyConnection(std::shared_ptr<BufferedConnection> connection, const Request &request)
     {
-        std::string proxyHost = Utils::extractHost(m_options.proxyUrl);
-        int proxyPort = Utils::extractPort(m_options.proxyUrl);
-        m_options.verifySsl = Utils::extractScheme(m_options.proxyUrl) == "https";
+        std::string proxyHost(m_proxyUrl.host());
+        int proxyPort = m_proxyUrl.port();
+        // 複数のタスクから同時に送信できるよう、ここではオプションを書き換えない
+        bool tunnel = m_proxyUrl.scheme() == "https";
 
         auto connectStart = std::chrono::steady_clock::now();
-        if (!connection->connect(proxyHost, proxyPort))
+        const CancellationToken &token = request.getCancellationToken();
+        if (!connectWithWarmState(connection.get(), proxyHost, proxyPort, token))
         {
+            if (token.cancelled())
+            {
+                return Result<std::shared_ptr<BufferedConnection>>(cancelledError());
+            }
             auto connectDuration = std::chrono::steady_clock::now() - connectStart;
             if (connectDuration > m_timeouts.connect)
             {
-                return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::Timeout, "Proxy connection timed out"));
+                return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::Timeout, "Proxy connection timed out"));
             }
-            return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to proxy connect to " + proxyHost));
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to proxy connect to " + proxyHost));
         }
 
-        if (m_options.verifySsl)
+        if (tunnel)
         {
             // プロキシ経由でのSSL通信の場合、トンネルを確立する
             auto tunnelResult = establishProxyTunnel(connection, request, proxyHost, proxyPort);
@@ -355,10 +1151,10 @@ namespace canaspad
                 return tunnelResult;
             }
         }
-        return Result<std::shared_ptr<Connection>>(connection);
+        return Result<std::shared_ptr<BufferedConnection>>(connection);
     }
 
-    Result<std::shared_ptr<Connection>> HttpClient::establishProxyTunnel(std::shared_ptr<Connection> connection, const Request &request, const std::string &proxyHost, int proxyPort)
+    Result<std::shared_ptr<BufferedConnection>> HttpClient::establishProxyTunnel(std::shared_ptr<BufferedConnection> connection, const Request &request, const std::string &proxyHost, int proxyPort)
     {
         std::string connectRequestStr = "CONNECT " + proxyHost + ":" + std::to_string(proxyPort) + " HTTP/1.1\r\n";
         connectRequestStr += "Host: " + proxyHost + ":" + std::to_string(proxyPort) + "\r\n";
@@ -368,7 +1164,7 @@ namespace canaspad
         auto proxyValidationResult = RequestValidator::validate(request, m_options);
         if (proxyValidationResult.isError())
         {
-            return Result<std::shared_ptr<Connection>>(proxyValidationResult.error());
+            return Result<std::shared_ptr<BufferedConnection>>(proxyValidationResult.error());
         }
 
         auto writeStart = std::chrono::steady_clock::now();
@@ -377,220 +1173,151 @@ namespace canaspad
             auto writeDuration = std::chrono::steady_clock::now() - writeStart;
             if (writeDuration > m_timeouts.write)
             {
-                return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::Timeout, "Proxy write operation timed out"));
+                return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::Timeout, "Proxy write operation timed out"));
             }
-            return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to send proxy request"));
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to send proxy request"));
         }
 
-        auto responseResult = readResponse(connection.get(), request);
+        // CONNECT への 2xx 応答はボディを持たない
+        Request tunnelRequest = request;
+        tunnelRequest.setMethod(HttpMethod::CONNECT);
+        auto responseResult = readResponse(connection.get(), tunnelRequest);
         if (responseResult.isError() || responseResult.value().statusCode != 200)
         {
-            return Result<std::shared_ptr<Connection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to establish proxy tunnel"));
+            return Result<std::shared_ptr<BufferedConnection>>(ErrorInfo(ErrorCode::NetworkError, "Failed to establish proxy tunnel"));
         }
-        return Result<std::shared_ptr<Connection>>(connection);
+        return Result<std::shared_ptr<BufferedConnection>>(connection);
     }
 
-    Result<HttpResult> HttpClient::readResponse(Connection *connection, const Request &request)
+    Result<HttpResult> HttpClient::readResponse(BufferedConnection *connection, const Request &request, const ChunkCallback &bodyCallback, bool *reusable, Arena *arena, RequestTiming *timing)
     {
-        HttpResult httpResult;
+        HttpResult httpResult(arena);
+        if (arena)
+        {
+            // Arena では伸ばすたびに古い領域が残るため、一般的なレスポンスのヘッダー分を先に確保する
+            httpResult.headers.reserve(16, 512);
+        }
         auto readStart = std::chrono::steady_clock::now();
 
-        try
+        ResponseParser parser(arena);
+        parser.setRequestMethod(request.getMethod());
+        parser.onStatus([&httpResult](int code, std::string_view message)
+                        {
+                            httpResult.statusCode = code;
+                            httpResult.statusMessage.assign(message.data(), message.size()); });
+        parser.onHeader([&httpResult](std::string_view key, std::string_view value)
+                        { httpResult.headers.add(key, value); });
+        // チャンクのトレーラーは通常のヘッダーとして扱う
+        parser.onTrailer([&httpResult](std::string_view key, std::string_view value)
+                         { httpResult.headers.add(key, value); });
+        parser.onBody([&httpResult, &bodyCallback, &parser](const char *data, size_t size)
+                      {
+                          // 2xx のボディは受信バッファから直接呼び出し元へ渡し、蓄積しない
+                          // リダイレクトやエラー応答のボディは従来通り body に格納する
+                          if (bodyCallback && httpResult.statusCode >= 200 && httpResult.statusCode < 300)
+                          {
+                              bodyCallback(data, size);
+                          }
+                          else
+                          {
+                              if (httpResult.body.empty() && parser.hasContentLength())
+                              {
+                                  // 長さが分かっている場合は一度で確保し、伸ばすたびの再確保を避ける
+                                  httpResult.body.reserve(std::min(parser.contentLength(), kMaxBodyReserve));
+                              }
+                              httpResult.body.append(data, size);
+                          } });
+
+        size_t totalBytesRead = 0;
+        bool closedEarly = false;
+
+        // レスポンス全体を 1 つの期限で読み込む。データが一時的に途切れても終端まで待つ
+        auto deadline = readStart + m_timeouts.read;
+        const CancellationToken &token = request.getCancellationToken();
+        while (!parser.isComplete() && !parser.hasError())
         {
-            const size_t bufferSize = 4096;
-            uint8_t buffer[bufferSize];
-            size_t totalBytesRead = 0;
-            std::string responseStr;
-            bool headersCompleted = false;
-            size_t contentLength = 0;
-
-            while (connection->connected() && connection->available() > 0)
+            if (token.cancelled())
+            {
+                return Result<HttpResult>(cancelledError());
+            }
+            if (connection->buffered() == 0)
             {
-                // タイムアウトチェックを追加
-                if (std::chrono::steady_clock::now() - readStart >= m_timeouts.read)
+                // 取り消せるリクエストでは、取り消しを確かめられるよう短い間隔で区切って待つ
+                auto waitUntil = token.valid() ? std::min(deadline, std::chrono::steady_clock::now() + CancellationToken::kCheckInterval) : deadline;
+                auto readiness = connection->waitForData(waitUntil);
+                if (readiness == ReadReadiness::TimedOut && waitUntil < deadline)
                 {
-                    Serial.println("HttpClient::readResponse - Read timeout reached");
-                    return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading response"));
+                    continue;
                 }
-
-                if (m_useMock && headersCompleted && responseStr.length() >= contentLength)
+                if (readiness == ReadReadiness::TimedOut)
                 {
-                    break; // モックオブジェクトを使用している場合、ここでループを抜ける
+                    CANASPAD_LOGW("HttpClient::readResponse - Read timeout reached");
+                    return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading response"));
                 }
-
-                size_t bytesAvailable = connection->available();
-                Serial.printf("HttpClient::readResponse - Bytes available: %zu\n", bytesAvailable);
-
-                if (bytesAvailable > 0)
+                if (readiness == ReadReadiness::Closed)
                 {
-                    size_t bytesToRead = std::min(bytesAvailable, bufferSize);
-                    int bytesRead = connection->read(buffer, bytesToRead);
-                    Serial.printf("HttpClient::readResponse - Bytes read: %d\n", bytesRead);
-
-                    if (bytesRead > 0)
+                    if (parser.state() == ResponseParser::State::BodyUntilClose)
                     {
-                        responseStr.append(reinterpret_cast<char *>(buffer), bytesRead);
-                        totalBytesRead += bytesRead;
-                        Serial.printf("HttpClient::readResponse - Total bytes read: %zu\n", totalBytesRead);
-
-                        if (!headersCompleted)
-                        {
-                            size_t headerEnd = responseStr.find("\r\n\r\n");
-                            if (headerEnd != std::string::npos)
-                            {
-                                headersCompleted = true;
-                                std::string headers = responseStr.substr(0, headerEnd);
-                                Utils::parseStatusLine(headers, httpResult);
-                                Utils::parseHeaders(headers, httpResult);
-                                contentLength = Utils::extractContentLength(httpResult.headers);
-                                responseStr = responseStr.substr(headerEnd + 4);
-                            }
-                        }
-
-                        // レスポンスの終わりを検出する処理を追加
-                        if (headersCompleted && responseStr.length() >= contentLength)
-                        {
-                            Serial.println("HttpClient::readResponse - Complete response received");
-                            if (m_useMock)
-                            {
-                                auto mockConnection = static_cast<MockWiFiClientSecure *>(connection);
-                                mockConnection->moveToNextResponse();
-                            }
-                            break;
-                        }
+                        // 長さ指定のないボディは接続の終端で完了とする
+                        parser.finish();
                     }
+                    else
+                    {
+                        closedEarly = true;
+                    }
+                    break;
                 }
-                else
+                if (connection->fill() == 0)
                 {
-                    delay(10);
+                    continue;
                 }
             }
 
-            // loopから抜けたことをプリント
-            Serial.println("HttpClient::readResponse - Loop exited");
-            Serial.printf("HttpClient::readResponse - Parsed status line: %d %s\n", httpResult.statusCode, httpResult.statusMessage.c_str());
-
-            httpResult.body = std::move(responseStr);
-
-            // デバッグ出力（既存のコード）
-            Serial.println("HttpClient::readResponse - Parsed HttpResult:");
-            Serial.printf("Status Code: %d\n", httpResult.statusCode);
-            Serial.printf("Status Message: %s\n", httpResult.statusMessage.c_str());
-            Serial.println("Headers:");
-            for (const auto &header : httpResult.headers)
-            {
-                Serial.printf("%s: %s\n", header.first.c_str(), header.second.c_str());
-            }
-            Serial.printf("Body length: %zu\n", httpResult.body.length());
-
-            auto result = Result<HttpResult>(std::move(httpResult));
-
-            Serial.println("HttpClient::readResponse - Result<HttpResult>:");
-            if (result.isSuccess())
-            {
-                Serial.println("Result is success");
-            }
-            else
+            if (timing && timing->firstByte == RequestTiming::TimePoint())
             {
-                Serial.printf("Result is error: %s\n", result.error().message.c_str());
+                timing->firstByte = std::chrono::steady_clock::now();
             }
 
-            return result;
+            // 受信バッファ上のデータをそのままパーサへ渡し、消費した分だけ進める
+            // レスポンスの後ろに続くバイト (トンネル確立後のデータなど) はバッファに残す
+            size_t consumed = parser.feed(connection->bufferedData(), connection->buffered());
+            connection->consume(consumed);
+            totalBytesRead += consumed;
         }
-        catch (const std::exception &e)
+
+        if (timing)
         {
-            Serial.printf("HttpClient::readResponse - Exception caught: %s\n", e.what());
-            return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidResponse, e.what()));
+            timing->responseEnd = std::chrono::steady_clock::now();
         }
-    }
-
-    Result<HttpResult> HttpClient::handleChunkedResponse(Connection *connection, HttpResult &result, size_t startingPos)
-    {
-        auto readStart = std::chrono::steady_clock::now();
-        const size_t bufferSize = 4096;
-        uint8_t buffer[bufferSize];
-        size_t totalRead = 0;
 
-        // startingPos から読み込みを開始
-        std::string chunkedData = result.body; // 既存のデータ
-        size_t currentPos = startingPos;
-
-        while (true)
+        if (m_useMock && parser.headersComplete())
         {
-            if (std::chrono::steady_clock::now() - readStart > m_timeouts.read)
-            {
-                return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading chunked response"));
-            }
-
-            // チャンクサイズ行を見つける
-            size_t chunkSizeLineEnd = chunkedData.find("\r\n", currentPos);
-            if (chunkSizeLineEnd == std::string::npos)
-            {
-                // データが足りない場合は、さらに読み込む
-                size_t bytesToRead = std::min(bufferSize, chunkedData.capacity() - chunkedData.size());
-                int bytesRead = connection->read(buffer, bytesToRead);
-                if (bytesRead > 0)
-                {
-                    chunkedData.append(reinterpret_cast<char *>(buffer), bytesRead);
-                    chunkSizeLineEnd = chunkedData.find("\r\n", currentPos);
-                }
-                else
-                {
-                    return Result<HttpResult>(ErrorInfo(ErrorCode::NetworkError, "Connection closed unexpectedly"));
-                }
-            }
-            std::string chunkSizeLine = chunkedData.substr(currentPos, chunkSizeLineEnd - currentPos);
-            currentPos = chunkSizeLineEnd + 2; // 次のチャンクの開始位置に更新
-
-            char *endptr;
-            size_t chunkSize = std::strtoul(chunkSizeLine.c_str(), &endptr, 16);
-            if (*endptr != '\0' || chunkSizeLine.empty())
-            {
-                return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidResponse, "Invalid chunk size: " + chunkSizeLine));
-            }
+            auto mockConnection = static_cast<MockWiFiClientSecure *>(m_mockConnection.get());
+            mockConnection->moveToNextResponse();
+        }
 
-            if (chunkSize == 0)
-            {
-                // チャンクの終わり
-                break;
-            }
+        CANASPAD_LOGD("HttpClient::readResponse - Total bytes read: %zu", totalBytesRead);
 
-            // チャンクデータを見つける
-            size_t chunkDataEnd = chunkedData.find("\r\n", currentPos);
-            while (chunkDataEnd == std::string::npos)
-            {
-                // データが足りない場合は、さらに読み込む
-                size_t bytesToRead = std::min(bufferSize, chunkedData.capacity() - chunkedData.size());
-                int bytesRead = connection->read(buffer, bytesToRead);
-                if (bytesRead > 0)
-                {
-                    chunkedData.append(reinterpret_cast<char *>(buffer), bytesRead);
-                    chunkDataEnd = chunkedData.find("\r\n", currentPos);
-                }
-                else
-                {
-                    return Result<HttpResult>(ErrorInfo(ErrorCode::NetworkError, "Connection closed unexpectedly"));
-                }
-            }
+        if (closedEarly)
+        {
+            // 途中で切断された場合はネットワークエラーとして扱い、リトライの対象にする
+            return Result<HttpResult>(ErrorInfo(ErrorCode::NetworkError,
+                                                totalBytesRead == 0 ? "Connection closed before the response was received"
+                                                                    : "Connection closed before the response was complete"));
+        }
 
-            // チャンクデータを追加
-            result.body.append(chunkedData.substr(currentPos, chunkSize));
-            totalRead += chunkSize;
-            currentPos = chunkDataEnd + 2; // 次のチャンクの開始位置に更新
+        if (parser.hasError())
+        {
+            return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidResponse, parser.errorMessage()));
         }
 
-        // トレーラーヘッダーを読み込む
-        std::string trailerLine;
-        while ((trailerLine = connection->readLine()) != "\r\n")
+        if (reusable)
         {
-            if (std::chrono::steady_clock::now() - readStart > m_timeouts.read)
-            {
-                return Result<HttpResult>(ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading trailer headers"));
-            }
-            Utils::parseHeader(trailerLine, result);
+            // 最後まで読み切り、サーバーが接続を維持する場合のみ再利用できる
+            *reusable = parser.isComplete() && parser.keepAlive();
         }
 
-        return Result<HttpResult>(std::move(result));
+        return Result<HttpResult>(std::move(httpResult));
     }
 
     void HttpClient::setTimeouts(const Timeouts &timeouts)
@@ -613,11 +1340,20 @@ namespace canaspad
         m_timeouts.write = timeout;
     }
 
-    void HttpClient::cancel(const std::string &requestId)
+    bool HttpClient::cancel(const std::string &requestId)
+    {
+        // 送信中のリクエストは次の確認で RequestCancelled を返し、使っていた接続だけを閉じる
+        return m_cancellations.cancel(requestId);
+    }
+
+    CancellationRegistry::Registration HttpClient::registerSend(Request &request)
     {
-        // 実装は基盤となるネットワーク層に依存します
-        // 現在は、単に切断します
-        m_connectionPool->disconnectAll();
+        if (request.getId().empty())
+        {
+            return CancellationRegistry::Registration();
+        }
+        request.setCancellationToken(CancellationToken::create(request.getCancellationToken()));
+        return m_cancellations.add(request.getId(), request.getCancellationToken());
     }
 
     void HttpClient::enableCookies(bool enable)
@@ -637,79 +1373,258 @@ namespace canaspad
 
     Result<HttpResult> HttpClient::sendStreaming(const Request &request, ChunkCallback chunkCallback)
     {
-        // ストリーミング送信は未実装
-        return Result<HttpResult>(ErrorInfo(ErrorCode::UnsupportedOperation, "Streaming is not yet supported."));
-    }
+        if (!m_isInitialized)
+        {
+            return Result<HttpResult>(m_initializationError);
+        }
 
-    std::string HttpClient::buildRequestString(const Request &request)
-    {
-        std::ostringstream oss;
-        if (!m_options.proxyUrl.empty())
+        if (!chunkCallback)
         {
-            // プロキシ使用時はリクエストラインに完全なURLを含める
-            oss << canaspad::httpMethodToString(request.getMethod()) << " " << Utils::extractScheme(request.getUrl()) << "://" << Utils::extractHost(request.getUrl()) << ":" << Utils::extractPort(request.getUrl()) << Utils::extractPath(request.getUrl()) << " HTTP/1.1\r\n";
+            chunkCallback = m_responseBodyCallback;
         }
-        else
+        if (!chunkCallback)
         {
-            // プロキシ未使用時はリクエストラインにパスのみを含める
-            oss << canaspad::httpMethodToString(request.getMethod()) << " " << Utils::extractPath(request.getUrl()) << " HTTP/1.1\r\n";
+            return Result<HttpResult>(ErrorInfo(ErrorCode::InvalidOption, "Streaming requires a chunk callback."));
         }
-        // Host: ヘッダーを追加 ホストとポートを含める
-        oss << "Host: " << Utils::extractHost(request.getUrl()) << ":" << Utils::extractPort(request.getUrl()) << "\r\n";
-        const auto &multipartFormData = request.getMultipartFormData();
 
-        // プロキシ認証
-        if (!m_options.proxyUrl.empty())
+        // ステータスとヘッダーのみ HttpResult に格納し、ボディは chunkCallback へ渡す
+        return sendWithRetries(request, 0, chunkCallback);
+    }
+
+    Result<void> HttpClient::writeRequest(Connection *connection, const std::string &head, const std::string &body, BodySource *source, const CancellationToken &token)
+    {
+        const WriteSegment segments[] = {
+            {reinterpret_cast<const uint8_t *>(head.data()), head.size()},
+            {reinterpret_cast<const uint8_t *>(body.data()), body.size()}};
+        size_t written = connection->writev(segments, 2);
+
+        // 書ききれなかった分は続きから書く
+        if (written < head.size())
+        {
+            auto result = writeFully(connection, segments[0].data + written, head.size() - written, token);
+            if (result.isError())
+            {
+                return result;
+            }
+            written = head.size();
+        }
+        size_t bodyWritten = written - head.size();
+        if (bodyWritten < body.size())
         {
-            std::string encodedAuth = Utils::extractProxyAuth(m_options.proxyUrl);
-            if (!encodedAuth.empty())
+            auto result = writeFully(connection, segments[1].data + bodyWritten, body.size() - bodyWritten, token);
+            if (result.isError())
             {
-                oss << "Proxy-Authorization: Basic " << encodedAuth << "\r\n";
+                return result;
             }
         }
+        if (!body.empty() && m_progressCallback)
+        {
+            m_progressCallback(body.size(), body.size());
+        }
+
+        if (source)
+        {
+            return writeBodySource(connection, *source, token);
+        }
+        return Result<void>();
+    }
 
-        if (!multipartFormData.empty())
+    Result<void> HttpClient::writeBodySource(Connection *connection, BodySource &source, const CancellationToken &token)
+    {
+        // チャンクの先頭 ("<16 進数の長さ>\r\n") と末尾 ("\r\n") を同じバッファに置き、1 回の書き込みで送る
+        constexpr size_t kChunkPrefixSize = sizeof(size_t) * 2 + 2;
+        const size_t chunkSize = std::max<size_t>(1, m_options.uploadChunkSize);
+        std::unique_ptr<uint8_t[]> buffer(new uint8_t[kChunkPrefixSize + chunkSize + 2]);
+
+        size_t total = 0;
+        bool knownLength = source.contentLength(total);
+        size_t sent = 0;
+        while (!knownLength || sent < total)
         {
-            std::string boundary = Utils::generateBoundary();
-            oss << "Content-Type: multipart/form-data; boundary=" << boundary << "\r\n";
+            if (token.cancelled())
+            {
+                return Result<void>(cancelledError());
+            }
+            uint8_t *data = buffer.get() + kChunkPrefixSize;
+            size_t n = source.pull(data, chunkSize);
+            if (n == 0)
+            {
+                break;
+            }
+
+            Result<void> result;
+            if (knownLength)
+            {
+                result = writeFully(connection, data, n, token);
+            }
+            else
+            {
+                char prefix[kChunkPrefixSize + 1];
+                int prefixLength = snprintf(prefix, sizeof(prefix), "%zx\r\n", n);
+                std::memcpy(data - prefixLength, prefix, prefixLength);
+                data[n] = '\r';
+                data[n + 1] = '\n';
+                result = writeFully(connection, data - prefixLength, prefixLength + n + 2, token);
+            }
+            if (result.isError())
+            {
+                return result;
+            }
 
-            std::string body;
-            for (const auto &[key, value] : multipartFormData)
+            sent += n;
+            if (m_progressCallback)
             {
-                body += "--" + boundary + "\r\n";
-                body += "Content-Disposition: form-data; name=\"" + key + "\"\r\n\r\n";
-                body += value + "\r\n";
+                m_progressCallback(sent, knownLength ? total : 0);
             }
-            body += "--" + boundary + "--\r\n";
+        }
 
-            oss << "Content-Length: " << body.length() << "\r\n\r\n";
-            oss << body;
+        if (knownLength)
+        {
+            if (sent < total)
+            {
+                return Result<void>(ErrorInfo(ErrorCode::InvalidBody, "Request body source ended before Content-Length bytes were sent"));
+            }
+            return Result<void>();
         }
-        else
+
+        static const char kLastChunk[] = "0\r\n\r\n";
+        return writeFully(connection, reinterpret_cast<const uint8_t *>(kLastChunk), sizeof(kLastChunk) - 1, token);
+    }
+
+    Result<void> HttpClient::writeFully(Connection *connection, const uint8_t *data, size_t size, const CancellationToken &token)
+    {
+        // 短い書き込みは送信バッファが空くのを待って続きを書く
+        // 書き込みが進まない状態が write タイムアウトを超えた場合は失敗とする
+        auto deadline = std::chrono::steady_clock::now() + m_timeouts.write;
+        // 記述子を持たない接続は 1ms 間隔で確かめる
+        int handle = connection->nativeHandle();
+        auto slice = handle >= 0 ? CancellationToken::kCheckInterval : std::chrono::milliseconds(1);
+        while (size > 0)
         {
-            for (const auto &header : request.getHeaders())
+            size_t n = connection->write(data, size);
+            if (n > 0)
+            {
+                data += n;
+                size -= n;
+                deadline = std::chrono::steady_clock::now() + m_timeouts.write;
+                continue;
+            }
+            if (!connection->connected())
+            {
+                return Result<void>(ErrorInfo(ErrorCode::NetworkError, "Failed to send request"));
+            }
+            if (token.cancelled())
+            {
+                return Result<void>(cancelledError());
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
             {
-                oss << header.first << ": " << header.second << "\r\n";
+                return Result<void>(ErrorInfo(ErrorCode::Timeout, "Write operation timed out"));
             }
+            // 取り消しを確かめられるよう、待つ時間を区切る
+            waitForHandle(handle, true, std::min(deadline, now + slice));
+        }
+        return Result<void>();
+    }
+
+    void HttpClient::appendRequestHead(const Request &request, std::string &out) const
+    {
+        const Url &url = request.getParsedUrl();
+        std::string port = std::to_string(url.port());
+
+        out += canaspad::httpMethodToString(request.getMethod());
+        out += ' ';
+        if (!m_options.proxyUrl.empty())
+        {
+            // プロキシ使用時はリクエストラインに完全なURLを含める
+            out.append(url.scheme()).append("://").append(url.authorityHost()).append(":").append(port);
+        }
+        // プロキシ未使用時はリクエストラインにパスのみを含める (フラグメントは送らない)
+        out += url.path();
+        if (!url.query().empty())
+        {
+            out.append("?").append(url.query());
+        }
+        out += " HTTP/1.1\r\n";
+        // Host: ヘッダーを追加 ホストとポートを含める
+        out.append("Host: ").append(url.authorityHost()).append(":").append(port).append("\r\n");
+
+        // プロキシ認証
+        if (!m_proxyAuthorization.empty())
+        {
+            out.append("Proxy-Authorization: ").append(m_proxyAuthorization).append("\r\n");
+        }
+    }
 
-            if (m_cookiesEnabled)
+    void HttpClient::appendHeaders(const Request &request, std::string &out) const
+    {
+        // 設定された認証情報はリクエストの Authorization ヘッダーより優先する
+        const std::string &authorization = m_auth->authorizationHeader();
+        for (const auto &header : request.getHeaders())
+        {
+            if (!authorization.empty() && HeaderMap::equalsIgnoreCase(header.name, HeaderNames::Authorization.name))
             {
-                auto cookies = m_connectionPool->getCookieJar()->getCookiesForUrl(request.getUrl());
-                if (!cookies.empty())
-                {
-                    oss << "Cookie: " << Utils::joinStrings(cookies, "; ") << "\r\n";
-                }
+                continue;
             }
+            out.append(header.name).append(": ").append(header.value).append("\r\n");
+        }
+        if (!authorization.empty())
+        {
+            out.append("Authorization: ").append(authorization).append("\r\n");
+        }
+    }
 
-            if (!request.getBody().empty())
+    void HttpClient::appendCookieHeader(const Url &url, std::string &out) const
+    {
+        if (m_cookiesEnabled)
+        {
+            auto cookies = m_connectionPool->getCookieJar()->getCookiesForUrl(url);
+            if (!cookies.empty())
             {
-                oss << "Content-Length: " << request.getBody().length() << "\r\n";
+                out.append("Cookie: ").append(Utils::joinStrings(cookies, "; ")).append("\r\n");
             }
-            oss << "\r\n";
-            oss << request.getBody();
         }
+    }
+
+    void HttpClient::appendContentLength(size_t length, std::string &out) const
+    {
+        if (length > 0)
+        {
+            out.append("Content-Length: ").append(std::to_string(length)).append("\r\n");
+        }
+        out += "\r\n";
+    }
+
+    std::string HttpClient::buildRequestHead(const Request &request)
+    {
+        std::string out;
+        appendRequestHead(request, out);
+        appendHeaders(request, out);
+        appendCookieHeader(request.getParsedUrl(), out);
+        size_t length = request.getBody().length();
+        const auto &source = request.getBodySource();
+        if (source && !source->contentLength(length))
+        {
+            // 長さが分からない本文はチャンクに分けて送る
+            out += "Transfer-Encoding: chunked\r\n\r\n";
+        }
+        else
+        {
+            appendContentLength(length, out);
+        }
+        return out;
+    }
 
-        return oss.str();
+    std::string HttpClient::buildRequestHead(const PreparedSend &prepared)
+    {
+        const std::string &head = prepared.request.getHead();
+        std::string out;
+        out.reserve(head.size() + 32);
+        out += head;
+        appendCookieHeader(prepared.request.getRequest().getParsedUrl(), out);
+        appendContentLength(prepared.body.length(), out);
+        return out;
     }
 
 } // namespace canaspad
\ No newline at end of file
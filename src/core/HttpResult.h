@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include "../cookie/Cookie.h"
+#include "HeaderMap.h"
+#include "../utils/AllocationTracker.h"
+#include "RequestTiming.h"
 
 namespace canaspad
 {
@@ -12,11 +14,17 @@ namespace canaspad
     {
         int statusCode;
         std::string statusMessage;
-        std::unordered_map<std::string, std::string> headers;
+        HeaderMap headers;
         std::string body;
         std::vector<Cookie> cookies;
+        // この送信 (リトライ・リダイレクトを含む) で発生したヒープ確保 (CANASPAD_ALLOC_TRACKING が無効なビルドでは 0)
+        AllocationStats allocations;
+        // 名前解決から読み終えるまでの各段階の時刻
+        RequestTiming timing;
 
         HttpResult(int code = 0) : statusCode(code) {}
+        // ヘッダーを arena から確保する (arena を reset() するまで有効)
+        explicit HttpResult(Arena *arena) : statusCode(0), headers(arena) {}
     };
 
 } // namespace canaspad
\ No newline at end of file
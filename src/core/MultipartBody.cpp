@@ -0,0 +1,205 @@
+#include "MultipartBody.h"
+
+#include <algorithm>
+#include <cstring>
+#include "../utils/Utils.h"
+
+namespace canaspad
+{
+
+    namespace
+    {
+        const char kCrlf[] = "\r\n";
+
+        // name や filename の引用符と改行はエスケープする
+        void appendQuoted(std::string &out, const std::string &value)
+        {
+            out += '"';
+            for (char c : value)
+            {
+                switch (c)
+                {
+                case '"':
+                    out += "%22";
+                    break;
+                case '\r':
+                    out += "%0D";
+                    break;
+                case '\n':
+                    out += "%0A";
+                    break;
+                default:
+                    out += c;
+                    break;
+                }
+            }
+            out += '"';
+        }
+    } // namespace
+
+    MultipartBody::MultipartBody() : MultipartBody(Utils::generateBoundary()) {}
+
+    MultipartBody::MultipartBody(std::string boundary)
+        : m_boundary(std::move(boundary)), m_closing("--" + m_boundary + "--\r\n") {}
+
+    MultipartBody &MultipartBody::addField(const std::string &name, const std::string &value)
+    {
+        addPart(name, nullptr, nullptr, value, nullptr);
+        return *this;
+    }
+
+    MultipartBody &MultipartBody::addFile(const std::string &name, const std::string &filename,
+                                          const std::string &contentType, std::string data)
+    {
+        addPart(name, &filename, &contentType, std::move(data), nullptr);
+        return *this;
+    }
+
+    MultipartBody &MultipartBody::addFile(const std::string &name, const std::string &filename,
+                                          const std::string &contentType, std::shared_ptr<BodySource> source)
+    {
+        addPart(name, &filename, &contentType, std::string(), std::move(source));
+        return *this;
+    }
+
+    std::string MultipartBody::contentType() const
+    {
+        return "multipart/form-data; boundary=" + m_boundary;
+    }
+
+    bool MultipartBody::contentLength(size_t &length) const
+    {
+        size_t total = 0;
+        for (const auto &part : m_parts)
+        {
+            size_t dataLength = part.data.size();
+            if (part.source && !part.source->contentLength(dataLength))
+            {
+                return false;
+            }
+            total += part.header.size() + dataLength + 2;
+        }
+        length = total + m_closing.size();
+        return true;
+    }
+
+    size_t MultipartBody::read(uint8_t *buf, size_t size)
+    {
+        size_t total = 0;
+        while (total < size)
+        {
+            if (m_textOffset < m_textSize)
+            {
+                size_t n = std::min(size - total, m_textSize - m_textOffset);
+                std::memcpy(buf + total, m_text + m_textOffset, n);
+                m_textOffset += n;
+                total += n;
+                continue;
+            }
+
+            switch (m_stage)
+            {
+            case Stage::NextPart:
+                if (m_partIndex >= m_parts.size())
+                {
+                    setText(m_closing.data(), m_closing.size());
+                    m_stage = Stage::Closing;
+                }
+                else
+                {
+                    const auto &header = m_parts[m_partIndex].header;
+                    setText(header.data(), header.size());
+                    m_stage = Stage::Header;
+                }
+                break;
+
+            case Stage::Header:
+                m_stage = Stage::Data;
+                m_dataOffset = 0;
+                break;
+
+            case Stage::Data:
+            {
+                auto &part = m_parts[m_partIndex];
+                size_t n;
+                if (part.source)
+                {
+                    n = part.source->pull(buf + total, size - total);
+                }
+                else
+                {
+                    n = std::min(size - total, part.data.size() - m_dataOffset);
+                    std::memcpy(buf + total, part.data.data() + m_dataOffset, n);
+                    m_dataOffset += n;
+                }
+                if (n == 0)
+                {
+                    setText(kCrlf, 2);
+                    m_stage = Stage::Trailer;
+                }
+                total += n;
+                break;
+            }
+
+            case Stage::Trailer:
+                m_partIndex++;
+                m_stage = Stage::NextPart;
+                break;
+
+            case Stage::Closing:
+                return total;
+            }
+        }
+        return total;
+    }
+
+    bool MultipartBody::rewind()
+    {
+        for (auto &part : m_parts)
+        {
+            if (part.source && !part.source->restart())
+            {
+                return false;
+            }
+        }
+        m_stage = Stage::NextPart;
+        m_partIndex = 0;
+        m_text = nullptr;
+        m_textSize = 0;
+        m_textOffset = 0;
+        m_dataOffset = 0;
+        return true;
+    }
+
+    void MultipartBody::addPart(const std::string &name, const std::string *filename, const std::string *contentType,
+                                std::string data, std::shared_ptr<BodySource> source)
+    {
+        Part part;
+        part.header.reserve(m_boundary.size() + name.size() + 64);
+        part.header.append("--").append(m_boundary).append(kCrlf);
+        part.header += "Content-Disposition: form-data; name=";
+        appendQuoted(part.header, name);
+        if (filename)
+        {
+            part.header += "; filename=";
+            appendQuoted(part.header, *filename);
+        }
+        part.header += kCrlf;
+        if (contentType && !contentType->empty())
+        {
+            part.header.append("Content-Type: ").append(*contentType).append(kCrlf);
+        }
+        part.header += kCrlf;
+        part.data = std::move(data);
+        part.source = std::move(source);
+        m_parts.push_back(std::move(part));
+    }
+
+    void MultipartBody::setText(const char *text, size_t size)
+    {
+        m_text = text;
+        m_textSize = size;
+        m_textOffset = 0;
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "BodySource.h"
+
+namespace canaspad
+{
+
+    // multipart/form-data の本文を組み立てながら送る BodySource
+    // 各パートの区切りとヘッダーだけを保持し、本文全体は作らない
+    // すべてのパートの長さが分かっていれば Content-Length を事前に計算する (分からないパートがあれば chunked)
+    class MultipartBody : public BodySource
+    {
+    public:
+        MultipartBody();
+        explicit MultipartBody(std::string boundary);
+
+        MultipartBody &addField(const std::string &name, const std::string &value);
+        // メモリ上のデータをファイルとして送る
+        MultipartBody &addFile(const std::string &name, const std::string &filename,
+                               const std::string &contentType, std::string data);
+        // 送信時に source から読み出す
+        MultipartBody &addFile(const std::string &name, const std::string &filename,
+                               const std::string &contentType, std::shared_ptr<BodySource> source);
+
+        const std::string &boundary() const { return m_boundary; }
+        // Content-Type ヘッダーの値
+        std::string contentType() const;
+        size_t partCount() const { return m_parts.size(); }
+
+        bool contentLength(size_t &length) const override;
+
+    protected:
+        size_t read(uint8_t *buf, size_t size) override;
+        bool rewind() override;
+
+    private:
+        struct Part
+        {
+            std::string header; // 区切り行とパートのヘッダー
+            std::string data;
+            std::shared_ptr<BodySource> source;
+        };
+
+        enum class Stage
+        {
+            NextPart,
+            Header,
+            Data,
+            Trailer,
+            Closing
+        };
+
+        std::string m_boundary;
+        std::string m_closing; // --boundary--
+        std::vector<Part> m_parts;
+
+        Stage m_stage = Stage::NextPart;
+        size_t m_partIndex = 0;
+        const char *m_text = nullptr; // 送信中の区切り・ヘッダー
+        size_t m_textSize = 0;
+        size_t m_textOffset = 0;
+        size_t m_dataOffset = 0;
+
+        void addPart(const std::string &name, const std::string *filename, const std::string *contentType,
+                     std::string data, std::shared_ptr<BodySource> source);
+        void setText(const char *text, size_t size);
+    };
+
+} // namespace canaspad
\ No newline at end of file
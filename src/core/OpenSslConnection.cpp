@@ -0,0 +1,371 @@
+#include "OpenSslConnection.h"
+
+#if CANASPAD_PLATFORM_POSIX && defined(CANASPAD_USE_OPENSSL)
+
+#include <arpa/inet.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        // 設定は接続ごとに SSL へ適用するため、コンテキストはプロセスで 1 つを共有する
+        SSL_CTX *sharedContext()
+        {
+            static SSL_CTX *context = []()
+            {
+                SSL_CTX *ctx = SSL_CTX_new(TLS_client_method());
+                SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+                SSL_CTX_set_default_verify_paths(ctx);
+                // セッションは TlsSessionCache で管理する
+                SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+                return ctx;
+            }();
+            return context;
+        }
+
+        X509_STORE *loadCertificates(const std::string &pem)
+        {
+            BIO *bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+            X509_STORE *store = X509_STORE_new();
+            while (X509 *certificate = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr))
+            {
+                X509_STORE_add_cert(store, certificate);
+                X509_free(certificate);
+            }
+            ERR_clear_error(); // 末尾まで読んだことによるエラーを消す
+            BIO_free(bio);
+            return store;
+        }
+
+        bool isIpAddress(const std::string &host)
+        {
+            in_addr address;
+            return inet_pton(AF_INET, host.c_str(), &address) == 1;
+        }
+    } // namespace
+
+    OpenSslConnection::OpenSslConnection() {}
+
+    OpenSslConnection::~OpenSslConnection() { freeSsl(); }
+
+    IoProgress OpenSslConnection::beginConnect(const std::string &host, int port)
+    {
+        m_host = host;
+        return PosixConnection::beginConnect(host, port);
+    }
+
+    IoProgress OpenSslConnection::continueConnect()
+    {
+        // ハンドシェイクを始めていれば続きを進める
+        return m_ssl ? stepHandshake() : PosixConnection::continueConnect();
+    }
+
+    IoProgress OpenSslConnection::tcpConnected()
+    {
+        PosixConnection::tcpConnected();
+        startHandshake();
+        return stepHandshake();
+    }
+
+    void OpenSslConnection::startHandshake()
+    {
+        m_ssl = SSL_new(sharedContext());
+        m_peerClosed = false;
+        SSL_set_fd(m_ssl, m_socket);
+
+        bool ipAddress = isIpAddress(m_host);
+        if (!ipAddress)
+        {
+            SSL_set_tlsext_host_name(m_ssl, m_host.c_str());
+        }
+        if (m_verifySsl)
+        {
+            SSL_set_verify(m_ssl, SSL_VERIFY_PEER, nullptr);
+            X509_VERIFY_PARAM *param = SSL_get0_param(m_ssl);
+            if (ipAddress)
+            {
+                X509_VERIFY_PARAM_set1_ip_asc(param, m_host.c_str());
+            }
+            else
+            {
+                X509_VERIFY_PARAM_set1_host(param, m_host.c_str(), m_host.size());
+            }
+            if (!m_caCert.empty())
+            {
+                SSL_set0_verify_cert_store(m_ssl, loadCertificates(m_caCert));
+            }
+        }
+        else
+        {
+            SSL_set_verify(m_ssl, SSL_VERIFY_NONE, nullptr);
+        }
+
+        if (!m_clientCert.empty() && !m_privateKey.empty())
+        {
+            BIO *certBio = BIO_new_mem_buf(m_clientCert.data(), static_cast<int>(m_clientCert.size()));
+            BIO *keyBio = BIO_new_mem_buf(m_privateKey.data(), static_cast<int>(m_privateKey.size()));
+            X509 *certificate = PEM_read_bio_X509(certBio, nullptr, nullptr, nullptr);
+            EVP_PKEY *key = PEM_read_bio_PrivateKey(keyBio, nullptr, nullptr, nullptr);
+            if (certificate && key)
+            {
+                SSL_use_certificate(m_ssl, certificate);
+                SSL_use_PrivateKey(m_ssl, key);
+            }
+            X509_free(certificate);
+            EVP_PKEY_free(key);
+            BIO_free(certBio);
+            BIO_free(keyBio);
+        }
+
+        // 前回のセッションを提示して簡略ハンドシェイクを試みる
+        if (!m_tlsSession.empty())
+        {
+            const unsigned char *data = m_tlsSession.data();
+            SSL_SESSION *session = d2i_SSL_SESSION(nullptr, &data, static_cast<long>(m_tlsSession.size()));
+            if (session)
+            {
+                SSL_set_session(m_ssl, session);
+                SSL_SESSION_free(session);
+            }
+            m_tlsSession.clear();
+        }
+
+    }
+
+    IoProgress OpenSslConnection::stepHandshake()
+    {
+        ERR_clear_error();
+        int result = SSL_connect(m_ssl);
+        if (result == 1)
+        {
+            m_connectTiming.tlsEnd = std::chrono::steady_clock::now();
+            return IoProgress::Done;
+        }
+        switch (SSL_get_error(m_ssl, result))
+        {
+        case SSL_ERROR_WANT_READ:
+            return IoProgress::WantRead;
+        case SSL_ERROR_WANT_WRITE:
+            return IoProgress::WantWrite;
+        default:
+            return IoProgress::Failed;
+        }
+    }
+
+    void OpenSslConnection::freeSsl()
+    {
+        if (m_ssl)
+        {
+            // 相手の close_notify は待たない
+            SSL_shutdown(m_ssl);
+            SSL_free(m_ssl);
+            m_ssl = nullptr;
+        }
+    }
+
+    void OpenSslConnection::disconnect()
+    {
+        freeSsl();
+        PosixConnection::disconnect();
+    }
+
+    bool OpenSslConnection::connected() const
+    {
+        return m_ssl != nullptr && !m_peerClosed && PosixConnection::connected();
+    }
+
+    size_t OpenSslConnection::write(const uint8_t *buf, size_t size)
+    {
+        if (!m_ssl)
+        {
+            return 0;
+        }
+        auto deadline = std::chrono::steady_clock::now() + m_writeTimeout;
+        size_t written = 0;
+        while (written < size)
+        {
+            ERR_clear_error();
+            // 再試行では同じ引数で呼び出す必要がある
+            int n = SSL_write(m_ssl, buf + written, static_cast<int>(size - written));
+            if (n > 0)
+            {
+                written += n;
+                continue;
+            }
+            int error = SSL_get_error(m_ssl, n);
+            bool ready = false;
+            if (error == SSL_ERROR_WANT_WRITE)
+            {
+                ready = waitWritable(deadline);
+            }
+            else if (error == SSL_ERROR_WANT_READ)
+            {
+                ready = waitReadable(deadline);
+            }
+            if (!ready)
+            {
+                break;
+            }
+        }
+        return written;
+    }
+
+    size_t OpenSslConnection::writeSome(const uint8_t *buf, size_t size)
+    {
+        if (!m_ssl)
+        {
+            return 0;
+        }
+        ERR_clear_error();
+        int n = SSL_write(m_ssl, buf, static_cast<int>(size));
+        if (n > 0)
+        {
+            return static_cast<size_t>(n);
+        }
+        int error = SSL_get_error(m_ssl, n);
+        if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE)
+        {
+            m_peerClosed = true;
+        }
+        return 0;
+    }
+
+    size_t OpenSslConnection::writev(const WriteSegment *segments, size_t count)
+    {
+        return Connection::writev(segments, count);
+    }
+
+    int OpenSslConnection::read(uint8_t *buf, size_t size)
+    {
+        if (!m_ssl)
+        {
+            return -1;
+        }
+        ERR_clear_error();
+        int n = SSL_read(m_ssl, buf, static_cast<int>(size));
+        if (n > 0)
+        {
+            return n;
+        }
+        int error = SSL_get_error(m_ssl, n);
+        if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE)
+        {
+            m_peerClosed = true;
+        }
+        return -1;
+    }
+
+    int OpenSslConnection::available()
+    {
+        if (!m_ssl)
+        {
+            return 0;
+        }
+        int pending = SSL_pending(m_ssl);
+        if (pending > 0)
+        {
+            return pending;
+        }
+        if (PosixConnection::available() <= 0)
+        {
+            return 0;
+        }
+
+        // 受信済みのレコードを復号し、平文として読めるバイト数を返す
+        uint8_t byte;
+        ERR_clear_error();
+        int n = SSL_peek(m_ssl, &byte, 1);
+        if (n > 0)
+        {
+            return SSL_pending(m_ssl);
+        }
+        int error = SSL_get_error(m_ssl, n);
+        if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE)
+        {
+            m_peerClosed = true;
+        }
+        return 0;
+    }
+
+    ReadReadiness OpenSslConnection::waitForData(std::chrono::steady_clock::time_point deadline)
+    {
+        while (true)
+        {
+            if (available() > 0)
+            {
+                return ReadReadiness::Ready;
+            }
+            if (!m_ssl || m_peerClosed)
+            {
+                return ReadReadiness::Closed;
+            }
+            if (!waitReadable(deadline))
+            {
+                return std::chrono::steady_clock::now() >= deadline ? ReadReadiness::TimedOut : ReadReadiness::Closed;
+            }
+            // 読み込み可能で受信データがない場合は相手が閉じている
+            // データがあればレコードの途中でも available() で受信を進める
+            if (PosixConnection::available() <= 0)
+            {
+                return ReadReadiness::Closed;
+            }
+        }
+    }
+
+    void OpenSslConnection::setCACert(const char *rootCA)
+    {
+        m_caCert = rootCA ? rootCA : "";
+    }
+
+    void OpenSslConnection::setClientCert(const char *cert)
+    {
+        m_clientCert = cert ? cert : "";
+    }
+
+    void OpenSslConnection::setClientPrivateKey(const char *privateKey)
+    {
+        m_privateKey = privateKey ? privateKey : "";
+    }
+
+    bool OpenSslConnection::setTlsSession(const std::vector<uint8_t> &session)
+    {
+        m_tlsSession = session;
+        return true;
+    }
+
+    bool OpenSslConnection::getTlsSession(std::vector<uint8_t> &session) const
+    {
+        if (!m_ssl)
+        {
+            return false;
+        }
+        SSL_SESSION *current = SSL_get1_session(m_ssl);
+        if (!current)
+        {
+            return false;
+        }
+        bool exported = false;
+        int length = SSL_SESSION_is_resumable(current) ? i2d_SSL_SESSION(current, nullptr) : 0;
+        if (length > 0)
+        {
+            session.resize(length);
+            unsigned char *data = session.data();
+            exported = i2d_SSL_SESSION(current, &data) == length;
+        }
+        SSL_SESSION_free(current);
+        return exported;
+    }
+
+    bool OpenSslConnection::isTlsSessionResumed() const
+    {
+        return m_ssl != nullptr && SSL_session_reused(m_ssl) == 1;
+    }
+
+} // namespace canaspad
+
+#endif // CANASPAD_PLATFORM_POSIX && CANASPAD_USE_OPENSSL
\ No newline at end of file
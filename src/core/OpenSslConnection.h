@@ -0,0 +1,67 @@
+#pragma once
+
+#include "PosixConnection.h"
+
+// OpenSSL を使う TLS 接続はホストのビルドで CANASPAD_USE_OPENSSL を定義した場合のみ使える
+// (platformio.ini の native 環境では -lssl -lcrypto とともに定義している)
+#if CANASPAD_PLATFORM_POSIX && defined(CANASPAD_USE_OPENSSL)
+
+#include <string>
+#include <vector>
+
+typedef struct ssl_st SSL;
+
+namespace canaspad
+{
+
+    // PosixConnection の TCP 接続の上で OpenSSL による TLS を行う
+    // 実機の mbedTLS と揃えるため TLS 1.2 までに制限し、セッション ID / チケットによる再開に対応する
+    // CANASPAD_USE_OPENSSL を定義したビルドでは https の既定の接続になる
+    class OpenSslConnection : public PosixConnection
+    {
+    public:
+        OpenSslConnection();
+        ~OpenSslConnection() override;
+
+        // TCP の接続に続けてハンドシェイクを進める (connect は PosixConnection の手順で待つ)
+        IoProgress beginConnect(const std::string &host, int port) override;
+        IoProgress continueConnect() override;
+        void disconnect() override;
+        bool connected() const override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        size_t writeSome(const uint8_t *buf, size_t size) override;
+        // 平文の断片をまとめて TLS レコードにする (既定の Connection::writev)
+        size_t writev(const WriteSegment *segments, size_t count) override;
+        int read(uint8_t *buf, size_t size) override;
+        int available() override;
+        void setVerifySsl(bool verify) override { m_verifySsl = verify; }
+        void setCACert(const char *rootCA) override;
+        void setClientCert(const char *cert) override;
+        void setClientPrivateKey(const char *privateKey) override;
+
+        bool setTlsSession(const std::vector<uint8_t> &session) override;
+        bool getTlsSession(std::vector<uint8_t> &session) const override;
+        bool isTlsSessionResumed() const override;
+        ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline) override;
+
+    protected:
+        IoProgress tcpConnected() override;
+
+    private:
+        SSL *m_ssl = nullptr;
+        std::string m_host; // 証明書の検証と SNI に使うホスト名
+        bool m_verifySsl = true;
+        std::string m_caCert;
+        std::string m_clientCert;
+        std::string m_privateKey;
+        std::vector<uint8_t> m_tlsSession; // 次回の接続で提示するセッション
+        bool m_peerClosed = false;
+
+        void startHandshake();
+        IoProgress stepHandshake();
+        void freeSsl();
+    };
+
+} // namespace canaspad
+
+#endif // CANASPAD_PLATFORM_POSIX && CANASPAD_USE_OPENSSL
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include "PosixConnection.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        // poll に渡す残り時間 (ミリ秒、切り上げ)
+        int remainingMs(std::chrono::steady_clock::time_point deadline)
+        {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero())
+            {
+                return 0;
+            }
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining + std::chrono::microseconds(999)).count();
+            return static_cast<int>(std::min<long long>(ms, INT_MAX));
+        }
+
+        bool resolve(const std::string &host, uint32_t &address)
+        {
+            addrinfo hints{};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo *result = nullptr;
+            if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr)
+            {
+                return false;
+            }
+            address = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr.s_addr;
+            freeaddrinfo(result);
+            return true;
+        }
+
+        bool waitFor(int socket, short events, std::chrono::steady_clock::time_point deadline)
+        {
+            while (true)
+            {
+                pollfd fd{socket, events, 0};
+                int ready = ::poll(&fd, 1, remainingMs(deadline));
+                if (ready > 0)
+                {
+                    return (fd.revents & events) != 0 || (fd.revents & (POLLERR | POLLHUP)) == 0;
+                }
+                if (ready == 0 || errno != EINTR)
+                {
+                    return false;
+                }
+            }
+        }
+    } // namespace
+
+    PosixConnection::PosixConnection() {}
+
+    PosixConnection::~PosixConnection() { disconnect(); }
+
+    bool PosixConnection::connect(const std::string &host, int port)
+    {
+        // 止まらない接続の手順を、記述子の準備を待ちながら最後まで進める
+        IoProgress progress = beginConnect(host, port);
+        auto deadline = m_connectTiming.connectStart + m_connectTimeout;
+        while (progress == IoProgress::WantRead || progress == IoProgress::WantWrite)
+        {
+            bool ready = progress == IoProgress::WantRead ? waitReadable(deadline) : waitWritable(deadline);
+            progress = ready ? continueConnect() : IoProgress::Failed;
+        }
+        if (progress != IoProgress::Done)
+        {
+            disconnect();
+            // 古いアドレスの可能性があるため次の試行では名前解決し直す
+            m_resolvedAddress = 0;
+            return false;
+        }
+        return true;
+    }
+
+    IoProgress PosixConnection::beginConnect(const std::string &host, int port)
+    {
+        disconnect();
+        m_connectTiming = ConnectTiming();
+
+        if (m_resolvedAddress == 0)
+        {
+            m_connectTiming.dnsStart = std::chrono::steady_clock::now();
+            bool resolved = resolve(host, m_resolvedAddress);
+            m_connectTiming.dnsEnd = std::chrono::steady_clock::now();
+            if (!resolved)
+            {
+                return IoProgress::Failed;
+            }
+        }
+
+        m_socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (m_socket < 0)
+        {
+            return IoProgress::Failed;
+        }
+        // 送信はアプリケーション側でまとめているため Nagle アルゴリズムで遅らせない
+        int noDelay = 1;
+        setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = m_resolvedAddress;
+
+        m_connectTiming.connectStart = std::chrono::steady_clock::now();
+        if (::connect(m_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+        {
+            return tcpConnected();
+        }
+        return errno == EINPROGRESS ? IoProgress::WantWrite : IoProgress::Failed;
+    }
+
+    IoProgress PosixConnection::continueConnect()
+    {
+        if (m_socket < 0)
+        {
+            return IoProgress::Failed;
+        }
+        // 書き込み可能 (またはエラー) になるまでは接続中
+        pollfd fd{m_socket, POLLOUT, 0};
+        if (::poll(&fd, 1, 0) == 0)
+        {
+            return IoProgress::WantWrite;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0)
+        {
+            return IoProgress::Failed;
+        }
+        return tcpConnected();
+    }
+
+    IoProgress PosixConnection::tcpConnected()
+    {
+        // TLS を行わないためハンドシェイクは TCP 接続と同時に完了する
+        m_connectTiming.connectEnd = std::chrono::steady_clock::now();
+        m_connectTiming.tlsEnd = m_connectTiming.connectEnd;
+        return IoProgress::Done;
+    }
+
+    void PosixConnection::disconnect()
+    {
+        if (m_socket >= 0)
+        {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+
+    bool PosixConnection::isConnected() const { return connected(); }
+
+    bool PosixConnection::connected() const
+    {
+        if (m_socket < 0)
+        {
+            return false;
+        }
+        // 相手が閉じた接続は読み込み可能かつ 0 バイトになる
+        uint8_t byte;
+        ssize_t n = ::recv(m_socket, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n > 0)
+        {
+            return true;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+
+    bool PosixConnection::waitReadable(std::chrono::steady_clock::time_point deadline) const
+    {
+        return waitFor(m_socket, POLLIN, deadline);
+    }
+
+    bool PosixConnection::waitWritable(std::chrono::steady_clock::time_point deadline) const
+    {
+        return waitFor(m_socket, POLLOUT, deadline);
+    }
+
+    size_t PosixConnection::write(const uint8_t *buf, size_t size)
+    {
+        WriteSegment segment{buf, size};
+        return writev(&segment, 1);
+    }
+
+    size_t PosixConnection::writeSome(const uint8_t *buf, size_t size)
+    {
+        if (m_socket < 0)
+        {
+            return 0;
+        }
+        while (true)
+        {
+            ssize_t n = ::send(m_socket, buf, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n >= 0)
+            {
+                return static_cast<size_t>(n);
+            }
+            if (errno != EINTR)
+            {
+                return 0;
+            }
+        }
+    }
+
+    size_t PosixConnection::writev(const WriteSegment *segments, size_t count)
+    {
+        if (m_socket < 0)
+        {
+            return 0;
+        }
+
+        constexpr size_t kMaxSegments = 16;
+        auto deadline = std::chrono::steady_clock::now() + m_writeTimeout;
+        size_t written = 0;
+        size_t index = 0;
+        size_t offset = 0; // segments[index] のうち書き込み済みのバイト数
+        while (index < count)
+        {
+            iovec iov[kMaxSegments];
+            size_t iovCount = 0;
+            for (size_t i = index; i < count && iovCount < kMaxSegments; ++i)
+            {
+                size_t skip = i == index ? offset : 0;
+                if (segments[i].size > skip)
+                {
+                    iov[iovCount].iov_base = const_cast<uint8_t *>(segments[i].data + skip);
+                    iov[iovCount].iov_len = segments[i].size - skip;
+                    ++iovCount;
+                }
+            }
+            if (iovCount == 0)
+            {
+                break;
+            }
+
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = iovCount;
+            ssize_t n = ::sendmsg(m_socket, &message, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitWritable(deadline))
+                {
+                    continue;
+                }
+                break;
+            }
+
+            // 書き込めた分だけ断片を進める
+            written += n;
+            size_t remaining = static_cast<size_t>(n);
+            while (index < count && remaining >= segments[index].size - offset)
+            {
+                remaining -= segments[index].size - offset;
+                offset = 0;
+                ++index;
+            }
+            offset += remaining;
+        }
+        return written;
+    }
+
+    int PosixConnection::read(uint8_t *buf, size_t size)
+    {
+        if (m_socket < 0)
+        {
+            return -1;
+        }
+        ssize_t n = ::recv(m_socket, buf, size, MSG_DONTWAIT);
+        if (n <= 0)
+        {
+            return -1;
+        }
+        return static_cast<int>(n);
+    }
+
+    int PosixConnection::read()
+    {
+        uint8_t byte;
+        return read(&byte, 1) == 1 ? byte : -1;
+    }
+
+    std::string PosixConnection::read(size_t size)
+    {
+        // 受信済みの分だけを返す
+        std::string result(size, '\0');
+        int count = read(reinterpret_cast<uint8_t *>(&result[0]), size);
+        result.resize(count > 0 ? count : 0);
+        return result;
+    }
+
+    std::string PosixConnection::readLine()
+    {
+        std::string line;
+        auto deadline = std::chrono::steady_clock::now() + m_readTimeout;
+        while (true)
+        {
+            int c = read();
+            if (c < 0)
+            {
+                if (waitForData(deadline) != ReadReadiness::Ready)
+                {
+                    break;
+                }
+                continue;
+            }
+            if (c == '\n')
+            {
+                break;
+            }
+            line += static_cast<char>(c);
+        }
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        return line;
+    }
+
+    int PosixConnection::available()
+    {
+        int count = 0;
+        if (m_socket < 0 || ::ioctl(m_socket, FIONREAD, &count) < 0)
+        {
+            return 0;
+        }
+        return count;
+    }
+
+    void PosixConnection::setTimeouts(const std::chrono::milliseconds &connectTimeout,
+                                      const std::chrono::milliseconds &readTimeout,
+                                      const std::chrono::milliseconds &writeTimeout)
+    {
+        m_connectTimeout = connectTimeout;
+        m_readTimeout = readTimeout;
+        m_writeTimeout = writeTimeout;
+    }
+
+    int PosixConnection::setTimeout(uint32_t seconds)
+    {
+        m_readTimeout = m_writeTimeout = std::chrono::seconds(seconds);
+        return 0;
+    }
+
+    bool PosixConnection::setResolvedAddress(uint32_t address)
+    {
+        m_resolvedAddress = address;
+        return true;
+    }
+
+    bool PosixConnection::getResolvedAddress(uint32_t &address) const
+    {
+        if (m_resolvedAddress == 0)
+        {
+            return false;
+        }
+        address = m_resolvedAddress;
+        return true;
+    }
+
+    bool PosixConnection::getConnectTiming(ConnectTiming &timing) const
+    {
+        if (m_connectTiming.dnsStart == std::chrono::steady_clock::time_point() &&
+            m_connectTiming.connectStart == std::chrono::steady_clock::time_point())
+        {
+            return false;
+        }
+        timing = m_connectTiming;
+        return true;
+    }
+
+    ReadReadiness PosixConnection::waitForData(std::chrono::steady_clock::time_point deadline)
+    {
+        if (m_socket < 0)
+        {
+            return ReadReadiness::Closed;
+        }
+        if (!waitReadable(deadline))
+        {
+            return std::chrono::steady_clock::now() >= deadline ? ReadReadiness::TimedOut : ReadReadiness::Closed;
+        }
+        // 読み込み可能で受信データがない場合は相手が閉じている
+        return available() > 0 ? ReadReadiness::Ready : ReadReadiness::Closed;
+    }
+
+} // namespace canaspad
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../utils/Platform.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include "Connection.h"
+
+#include <chrono>
+#include <string>
+
+namespace canaspad
+{
+
+    // POSIX ソケットによる TCP 接続 (ホストの Linux ビルドで使う)
+    // TLS は行わないため、https の URL でも平文で接続する。ループバックのサーバーに対する計測用
+    class PosixConnection : public Connection
+    {
+    public:
+        PosixConnection();
+        ~PosixConnection() override;
+
+        // beginConnect / continueConnect の手順を完了するまで待ちながら進める
+        bool connect(const std::string &host, int port) override;
+        int nativeHandle() const override { return m_socket; }
+        IoProgress beginConnect(const std::string &host, int port) override;
+        IoProgress continueConnect() override;
+        void disconnect() override;
+        bool isConnected() const override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        size_t writeSome(const uint8_t *buf, size_t size) override;
+        // 断片を sendmsg で 1 回のシステムコールにまとめて送る
+        size_t writev(const WriteSegment *segments, size_t count) override;
+        int read(uint8_t *buf, size_t size) override;
+        void setTimeouts(const std::chrono::milliseconds &connectTimeout,
+                         const std::chrono::milliseconds &readTimeout,
+                         const std::chrono::milliseconds &writeTimeout) override;
+        std::string readLine() override;
+        std::string read(size_t size) override;
+        void setVerifySsl(bool verify) override {}
+        void setCACert(const char *rootCA) override {}
+        void setClientCert(const char *cert) override {}
+        void setClientPrivateKey(const char *privateKey) override {}
+        bool connected() const override;
+        int available() override;
+        int read() override;
+        int setTimeout(uint32_t seconds) override;
+
+        bool setResolvedAddress(uint32_t address) override;
+        bool getResolvedAddress(uint32_t &address) const override;
+        bool getConnectTiming(ConnectTiming &timing) const override;
+        ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline) override;
+
+    protected:
+        int m_socket = -1;
+        std::chrono::milliseconds m_connectTimeout{30000};
+        std::chrono::milliseconds m_readTimeout{30000};
+        std::chrono::milliseconds m_writeTimeout{30000};
+        uint32_t m_resolvedAddress = 0; // ネットワークバイトオーダーの IPv4 アドレス
+        ConnectTiming m_connectTiming;
+
+        // 読み込める / 書き込めるようになるまで待つ。期限を過ぎた場合や切断された場合は false
+        bool waitReadable(std::chrono::steady_clock::time_point deadline) const;
+        bool waitWritable(std::chrono::steady_clock::time_point deadline) const;
+        // TCP の接続が完了したときの処理 (TLS を行う派生クラスはハンドシェイクを始める)
+        virtual IoProgress tcpConnected();
+    };
+
+} // namespace canaspad
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
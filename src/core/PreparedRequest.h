@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include "Request.h"
+
+namespace canaspad
+{
+
+    class HttpClient;
+
+    // 同じエンドポイントへ本文だけを変えて繰り返し送るためのリクエスト
+    // リクエストライン、Host、認証、固定ヘッダーを作成時に一度だけ組み立てておき、
+    // 送信時は Cookie と Content-Length、本文だけを付け加える
+    // HttpClient::prepare() で作成し、作成したクライアントでのみ使う
+    class PreparedRequest
+    {
+    public:
+        // URL、メソッド、ヘッダーの元になったリクエスト (本文は持たない)
+        const Request &getRequest() const { return m_request; }
+        // 組み立て済みのリクエストラインとヘッダー (末尾の空行は含まない)
+        const std::string &getHead() const { return m_head; }
+
+    private:
+        friend class HttpClient;
+
+        PreparedRequest(Request request, std::string head)
+            : m_request(std::move(request)), m_head(std::move(head)) {}
+
+        Request m_request;
+        std::string m_head;
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace canaspad
 
     Request &Request::setUrl(const std::string &url)
     {
-        m_url = url;
+        m_url = Url(url);
         return *this;
     }
 
@@ -19,23 +19,72 @@ namespace canaspad
 
     Request &Request::addHeader(const std::string &key, const std::string &value)
     {
-        m_headers[key] = value;
+        m_headers.set(key, value);
         return *this;
     }
 
     Request &Request::setBody(const std::string &body)
     {
         m_body = body;
+        m_bodySource.reset();
+        m_multipartFormData.clear();
         return *this;
     }
 
+    Request &Request::setBodySource(std::shared_ptr<BodySource> source)
+    {
+        m_bodySource = std::move(source);
+        m_body.clear();
+        m_multipartFormData.clear();
+        return *this;
+    }
+
+    Request &Request::setBodyReader(CallbackBodySource::Reader reader)
+    {
+        return setBodySource(std::make_shared<CallbackBodySource>(std::move(reader)));
+    }
+
+    Request &Request::setBodyReader(CallbackBodySource::Reader reader, size_t contentLength)
+    {
+        return setBodySource(std::make_shared<CallbackBodySource>(std::move(reader), contentLength));
+    }
+
+    Request &Request::setMultipartBody(std::shared_ptr<MultipartBody> body)
+    {
+        m_headers.set(HeaderNames::ContentType.name, body->contentType());
+        return setBodySource(std::move(body));
+    }
+
     Request &Request::setMultipartFormData(const std::vector<std::pair<std::string, std::string>> &formData)
     {
+        auto body = std::make_shared<MultipartBody>();
+        for (const auto &[key, value] : formData)
+        {
+            body->addField(key, value);
+        }
+        setMultipartBody(std::move(body));
         m_multipartFormData = formData;
         return *this;
     }
 
+    Request &Request::setId(const std::string &id)
+    {
+        m_id = id;
+        return *this;
+    }
+
+    Request &Request::setCancellationToken(CancellationToken token)
+    {
+        m_cancellationToken = std::move(token);
+        return *this;
+    }
+
     const std::string &Request::getUrl() const
+    {
+        return m_url.str();
+    }
+
+    const Url &Request::getParsedUrl() const
     {
         return m_url;
     }
@@ -45,7 +94,7 @@ namespace canaspad
         return m_method;
     }
 
-    const std::unordered_map<std::string, std::string> &Request::getHeaders() const
+    const HeaderMap &Request::getHeaders() const
     {
         return m_headers;
     }
@@ -55,9 +104,24 @@ namespace canaspad
         return m_body;
     }
 
+    const std::shared_ptr<BodySource> &Request::getBodySource() const
+    {
+        return m_bodySource;
+    }
+
     const std::vector<std::pair<std::string, std::string>> &Request::getMultipartFormData() const
     {
         return m_multipartFormData;
     }
 
+    const std::string &Request::getId() const
+    {
+        return m_id;
+    }
+
+    const CancellationToken &Request::getCancellationToken() const
+    {
+        return m_cancellationToken;
+    }
+
 } // namespace canaspad
\ No newline at end of file
@@ -2,9 +2,15 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <memory>
 #include "../core/CommonTypes.h"
 #include "../utils/Utils.h"
 #include "../utils/HttpMethod.h"
+#include "../utils/Url.h"
+#include "BodySource.h"
+#include "CancellationToken.h"
+#include "HeaderMap.h"
+#include "MultipartBody.h"
 
 namespace canaspad
 {
@@ -18,21 +24,40 @@ namespace canaspad
 
         Request &setUrl(const std::string &url);
         Request &setMethod(canaspad::HttpMethod method);
+        // 同じ名前のヘッダーは置き換える (大文字・小文字は区別しない)
         Request &addHeader(const std::string &key, const std::string &value);
         Request &setBody(const std::string &body);
+        // 本文を送信時に少しずつ読み出す (setBody() の本文とは排他)
+        Request &setBodySource(std::shared_ptr<BodySource> source);
+        Request &setBodyReader(CallbackBodySource::Reader reader);                       // chunked で送る
+        Request &setBodyReader(CallbackBodySource::Reader reader, size_t contentLength); // Content-Length で送る
+        // multipart/form-data として送る (Content-Type ヘッダーも設定する)
+        Request &setMultipartBody(std::shared_ptr<MultipartBody> body);
         Request &setMultipartFormData(const std::vector<std::pair<std::string, std::string>> &formData);
+        // HttpClient::cancel(id) で取り消すための ID。取り消しは送信ごとに行い、後の送信には残らない
+        Request &setId(const std::string &id);
+        // token.cancel() で送信を取り消す。コピーしたリクエストやリダイレクト先とトークンを共有する
+        Request &setCancellationToken(CancellationToken token);
 
         const std::string &getUrl() const;
+        // setUrl() で一度だけ解析した URL
+        const Url &getParsedUrl() const;
         canaspad::HttpMethod getMethod() const;
-        const std::unordered_map<std::string, std::string> &getHeaders() const;
+        const HeaderMap &getHeaders() const;
         const std::string &getBody() const;
+        const std::shared_ptr<BodySource> &getBodySource() const;
         const std::vector<std::pair<std::string, std::string>> &getMultipartFormData() const;
+        const std::string &getId() const;
+        const CancellationToken &getCancellationToken() const;
 
     private:
-        std::string m_url;
-        std::unordered_map<std::string, std::string> m_headers;
+        Url m_url;
+        HeaderMap m_headers;
         std::string m_body;
+        std::shared_ptr<BodySource> m_bodySource;
         std::vector<std::pair<std::string, std::string>> m_multipartFormData;
+        std::string m_id;
+        CancellationToken m_cancellationToken;
     };
 
 } // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+
+namespace canaspad
+{
+
+    // 接続の確立にかかった各段階の時刻 (steady_clock)。行わなかった段階は time_point{} のまま
+    struct ConnectTiming
+    {
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        TimePoint dnsStart; // 名前解決 (キャッシュを使った場合は行わない)
+        TimePoint dnsEnd;
+        TimePoint connectStart; // TCP 接続の開始
+        TimePoint connectEnd;   // TCP 接続の完了 (TLS と分けて計測できない接続では time_point{})
+        TimePoint tlsEnd;       // TLS ハンドシェイクの完了
+    };
+
+    // 送信 1 回 (リトライ・リダイレクトを含む) の時刻の内訳
+    // 接続以降の各段階は最後の試行のもの。再利用した接続では接続の段階は time_point{} のまま
+    struct RequestTiming
+    {
+        using TimePoint = std::chrono::steady_clock::time_point;
+        using Duration = std::chrono::microseconds;
+
+        TimePoint start; // send() を呼び出した時刻
+        ConnectTiming connect;
+        TimePoint requestSent; // リクエストを書き終えた時刻
+        TimePoint firstByte;   // レスポンスの最初のバイトが届いた時刻
+        TimePoint responseEnd; // レスポンスを読み終えた時刻
+        TimePoint end;         // send() から戻る時刻 (エラーの場合も記録する)
+
+        int retries = 0;   // 消費したリトライ回数
+        int redirects = 0; // 追跡したリダイレクト回数
+        bool connectionReused = false;
+
+        Duration dns() const { return between(connect.dnsStart, connect.dnsEnd); }
+        Duration tcpConnect() const { return between(connect.connectStart, connect.connectEnd); }
+        // TCP と分けて計測できない接続では TCP 接続を含む
+        Duration tlsHandshake() const
+        {
+            return between(connect.connectEnd != TimePoint() ? connect.connectEnd : connect.connectStart, connect.tlsEnd);
+        }
+        // リクエストを書き終えてから最初のバイトが届くまで
+        Duration timeToFirstByte() const { return between(requestSent, firstByte); }
+        Duration transfer() const { return between(firstByte, responseEnd); }
+        Duration total() const { return between(start, end); }
+
+        // リトライ・リダイレクトで次の試行を始める前に、試行ごとの時刻を消す
+        void resetAttempt()
+        {
+            connect = ConnectTiming();
+            requestSent = firstByte = responseEnd = TimePoint();
+            connectionReused = false;
+        }
+
+    private:
+        static Duration between(TimePoint from, TimePoint to)
+        {
+            if (from == TimePoint() || to == TimePoint() || to < from)
+            {
+                return Duration::zero();
+            }
+            return std::chrono::duration_cast<Duration>(to - from);
+        }
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -10,7 +10,7 @@ namespace canaspad
     Result<void> RequestValidator::validate(const Request &request,
                                             const ClientOptions &options)
     {
-        auto result = validateUrl(request.getUrl());
+        auto result = validateUrl(request.getParsedUrl());
         if (result.isError())
         {
             return result;
@@ -31,7 +31,7 @@ namespace canaspad
         return Result<void>();
     }
 
-    Result<void> RequestValidator::validateUrl(const std::string &url)
+    Result<void> RequestValidator::validateUrl(const Url &url)
     {
         // URL が空文字列かどうか
         if (url.empty())
@@ -40,7 +40,7 @@ namespace canaspad
         }
 
         // スキーマのチェック
-        auto scheme = Utils::extractScheme(url);
+        auto scheme = url.scheme();
         if (scheme.empty())
         {
             return Result<void>(
@@ -53,19 +53,21 @@ namespace canaspad
         }
 
         // ホスト名とポート番号のチェック
-        auto host = Utils::extractHost(url);
-        if (host.empty())
+        if (url.host().empty())
         {
             return Result<void>(ErrorInfo(ErrorCode::InvalidURL, "URL does not contain a host."));
         }
-        int port = Utils::extractPort(url);
-        if (port < 0 || port > 65535)
+        if (url.port() < 0 || url.port() > 65535)
         {
             return Result<void>(ErrorInfo(ErrorCode::InvalidURL, "Invalid port number."));
         }
+        if (!url.isValid())
+        {
+            return Result<void>(ErrorInfo(ErrorCode::InvalidURL, "URL contains a malformed authority."));
+        }
 
         // URL エンコードのチェック (簡易的なチェック)
-        for (char c : url)
+        for (char c : url.str())
         {
             if (!std::isalnum(c) && !std::strchr(".-_~:/?#[]@!$&'()*+,;=", c))
             {
@@ -90,21 +92,20 @@ namespace canaspad
         if (!options.proxyUrl.empty())
         {
             // スキーマのチェック
-            auto scheme = Utils::extractScheme(options.proxyUrl);
+            Url proxyUrl(options.proxyUrl);
+            auto scheme = proxyUrl.scheme();
             if (scheme != "http" && scheme != "https")
             {
                 return Result<void>(
                     ErrorInfo(ErrorCode::InvalidProxyURL, "Proxy URL must use the http/https scheme."));
             }
             // ホスト名のチェック
-            auto host = Utils::extractHost(options.proxyUrl);
-            if (host.empty())
+            if (proxyUrl.host().empty())
             {
                 return Result<void>(ErrorInfo(ErrorCode::InvalidProxyURL, "Proxy URL does not contain a host."));
             }
             // ポート番号のチェック
-            int port = Utils::extractPort(options.proxyUrl);
-            if (port < 0 || port > 65535)
+            if (!proxyUrl.isValid() || proxyUrl.port() < 0 || proxyUrl.port() > 65535)
             {
                 return Result<void>(ErrorInfo(ErrorCode::InvalidProxyURL,
                                               "Proxy URL contains an invalid port number."));
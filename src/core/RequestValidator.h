@@ -12,7 +12,7 @@ namespace canaspad
         static Result<void> validate(const Request &request, const ClientOptions &options);
 
     private:
-        static Result<void> validateUrl(const std::string &url);
+        static Result<void> validateUrl(const Url &url);
         static Result<void> validateMethod(HttpMethod method);
         static Result<void> validateClientOptions(const ClientOptions &options);
     };
@@ -10,7 +10,7 @@ namespace canaspad
         return m_statusCode;
     }
 
-    const std::unordered_map<std::string, std::string> &Response::getHeaders() const
+    const HeaderMap &Response::getHeaders() const
     {
         return m_headers;
     }
@@ -27,7 +27,7 @@ namespace canaspad
 
     void Response::addHeader(const std::string &key, const std::string &value)
     {
-        m_headers[key] = value;
+        m_headers.add(key, value);
     }
 
     void Response::setBody(const std::string &body)
@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
-#include <unordered_map>
 #include <vector>
+#include "HeaderMap.h"
 
 namespace canaspad
 {
@@ -12,7 +12,7 @@ namespace canaspad
         Response();
 
         int getStatusCode() const;
-        const std::unordered_map<std::string, std::string> &getHeaders() const;
+        const HeaderMap &getHeaders() const;
         const std::string &getBody() const;
 
         void setStatusCode(int code);
@@ -22,7 +22,7 @@ namespace canaspad
 
     private:
         int m_statusCode;
-        std::unordered_map<std::string, std::string> m_headers;
+        HeaderMap m_headers;
         std::string m_body;
     };
 
@@ -0,0 +1,454 @@
+#include "ResponseParser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        bool equalsIgnoreCase(std::string_view a, std::string_view b)
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // token は小文字で渡す。値を複製せずに走査する
+        bool containsTokenIgnoreCase(std::string_view value, std::string_view token)
+        {
+            for (size_t i = 0; i + token.size() <= value.size(); ++i)
+            {
+                if (equalsIgnoreCase(value.substr(i, token.size()), token))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace
+
+    ResponseParser::ResponseParser(Arena *arena) : m_requestMethod(HttpMethod::GET), m_line(ArenaAllocator<char>(arena))
+    {
+        if (arena)
+        {
+            // Arena では伸ばすたびに古い領域が残るため、一般的な行の長さを先に確保する
+            m_line.reserve(256);
+        }
+        reset();
+    }
+
+    void ResponseParser::reset()
+    {
+        m_state = State::StatusLine;
+        m_line.clear();
+        m_errorMessage.clear();
+        m_statusCode = 0;
+        m_chunked = false;
+        m_hasContentLength = false;
+        m_keepAlive = true;
+        m_headersComplete = false;
+        m_contentLength = 0;
+        m_remaining = 0;
+        m_bodyBytesRead = 0;
+    }
+
+    void ResponseParser::setRequestMethod(HttpMethod method)
+    {
+        m_requestMethod = method;
+    }
+
+    void ResponseParser::onStatus(StatusCallback callback)
+    {
+        m_statusCallback = std::move(callback);
+    }
+
+    void ResponseParser::onHeader(HeaderCallback callback)
+    {
+        m_headerCallback = std::move(callback);
+    }
+
+    void ResponseParser::onBody(BodyCallback callback)
+    {
+        m_bodyCallback = std::move(callback);
+    }
+
+    void ResponseParser::onTrailer(HeaderCallback callback)
+    {
+        m_trailerCallback = std::move(callback);
+    }
+
+    size_t ResponseParser::feed(const uint8_t *data, size_t size)
+    {
+        const uint8_t *p = data;
+        const uint8_t *end = data + size;
+
+        while (p < end && m_state != State::Complete && m_state != State::Error)
+        {
+            switch (m_state)
+            {
+            case State::StatusLine:
+                if (takeLine(p, end))
+                {
+                    handleStatusLine();
+                }
+                break;
+
+            case State::Headers:
+                if (takeLine(p, end))
+                {
+                    handleHeaderLine();
+                }
+                break;
+
+            case State::Body:
+            case State::ChunkData:
+            {
+                size_t count = std::min(m_remaining, static_cast<size_t>(end - p));
+                emitBody(p, count);
+                p += count;
+                m_remaining -= count;
+                if (m_remaining == 0)
+                {
+                    m_state = (m_state == State::Body) ? State::Complete : State::ChunkDataEnd;
+                }
+                break;
+            }
+
+            case State::BodyUntilClose:
+                emitBody(p, end - p);
+                p = end;
+                break;
+
+            case State::ChunkSize:
+                if (takeLine(p, end))
+                {
+                    handleChunkSizeLine();
+                }
+                break;
+
+            case State::ChunkDataEnd:
+                if (takeLine(p, end))
+                {
+                    if (!m_line.empty())
+                    {
+                        fail("Missing CRLF after chunk data");
+                        break;
+                    }
+                    m_state = State::ChunkSize;
+                }
+                break;
+
+            case State::Trailers:
+                if (takeLine(p, end))
+                {
+                    handleTrailerLine();
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        return p - data;
+    }
+
+    void ResponseParser::finish()
+    {
+        if (m_state == State::BodyUntilClose)
+        {
+            m_state = State::Complete;
+        }
+        else if (m_state != State::Complete && m_state != State::Error)
+        {
+            fail("Connection closed before the response was complete");
+        }
+    }
+
+    // 改行までを m_line に蓄積する。新しいバイトのみを走査する
+    bool ResponseParser::takeLine(const uint8_t *&p, const uint8_t *end)
+    {
+        const uint8_t *newline = static_cast<const uint8_t *>(std::memchr(p, '\n', end - p));
+        const uint8_t *stop = newline ? newline : end;
+
+        if (m_line.size() + (stop - p) > kMaxLineLength)
+        {
+            fail("Header line too long");
+            p = end;
+            return false;
+        }
+
+        m_line.append(reinterpret_cast<const char *>(p), stop - p);
+        if (!newline)
+        {
+            p = end;
+            return false;
+        }
+
+        p = newline + 1;
+        if (!m_line.empty() && m_line.back() == '\r')
+        {
+            m_line.pop_back();
+        }
+        return true;
+    }
+
+    void ResponseParser::handleStatusLine()
+    {
+        // ステータスライン前の空行は無視する
+        if (m_line.empty())
+        {
+            return;
+        }
+
+        if (m_line.compare(0, 5, "HTTP/") != 0)
+        {
+            fail("Invalid status line");
+            return;
+        }
+
+        size_t codeStart = m_line.find(' ');
+        if (codeStart == std::string::npos || m_line.size() < codeStart + 4)
+        {
+            fail("Invalid status line");
+            return;
+        }
+
+        int code = 0;
+        for (size_t i = codeStart + 1; i < codeStart + 4; ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(m_line[i])))
+            {
+                fail("Invalid status code");
+                return;
+            }
+            code = code * 10 + (m_line[i] - '0');
+        }
+
+        // HTTP/1.0 は既定で接続を閉じる
+        m_keepAlive = m_line.compare(0, codeStart, "HTTP/1.0") != 0;
+        m_statusCode = code;
+
+        std::string_view message;
+        if (m_line.size() > codeStart + 5)
+        {
+            message = std::string_view(m_line).substr(codeStart + 5);
+        }
+
+        // 中間レスポンスは最終レスポンスの結果に含めない
+        if (m_statusCallback && !isInterimResponse())
+        {
+            m_statusCallback(m_statusCode, message);
+        }
+
+        m_line.clear();
+        m_state = State::Headers;
+    }
+
+    void ResponseParser::handleHeaderLine()
+    {
+        if (m_line.empty())
+        {
+            handleHeadersComplete();
+            return;
+        }
+
+        std::string_view key;
+        std::string_view value;
+        // 中間レスポンスのヘッダー (103 Early Hints の Link など) は、最終レスポンスのヘッダーや keep-alive に影響させない
+        if (!splitHeaderLine(key, value) || isInterimResponse())
+        {
+            m_line.clear();
+            return;
+        }
+
+        if (equalsIgnoreCase(key, "Content-Length"))
+        {
+            size_t length = 0;
+            for (char c : value)
+            {
+                if (c < '0' || c > '9' || length > (SIZE_MAX - 9) / 10)
+                {
+                    value = std::string_view();
+                    break;
+                }
+                length = length * 10 + (c - '0');
+            }
+            if (value.empty())
+            {
+                fail("Invalid Content-Length");
+                return;
+            }
+            m_hasContentLength = true;
+            m_contentLength = length;
+        }
+        else if (equalsIgnoreCase(key, "Transfer-Encoding"))
+        {
+            m_chunked = containsTokenIgnoreCase(value, "chunked");
+        }
+        else if (equalsIgnoreCase(key, "Connection"))
+        {
+            if (containsTokenIgnoreCase(value, "close"))
+            {
+                m_keepAlive = false;
+            }
+            else if (containsTokenIgnoreCase(value, "keep-alive"))
+            {
+                m_keepAlive = true;
+            }
+        }
+
+        if (m_headerCallback)
+        {
+            m_headerCallback(key, value);
+        }
+        m_line.clear();
+    }
+
+    void ResponseParser::handleHeadersComplete()
+    {
+        // 1xx の中間レスポンスは読み捨てて最終レスポンスを待つ
+        if (isInterimResponse())
+        {
+            m_state = State::StatusLine;
+            return;
+        }
+
+        m_headersComplete = true;
+
+        bool noBody = m_requestMethod == HttpMethod::HEAD ||
+                      m_statusCode == 101 || m_statusCode == 204 || m_statusCode == 304 ||
+                      (m_requestMethod == HttpMethod::CONNECT && m_statusCode >= 200 && m_statusCode < 300);
+
+        if (noBody)
+        {
+            m_state = State::Complete;
+        }
+        else if (m_chunked)
+        {
+            m_state = State::ChunkSize;
+        }
+        else if (m_hasContentLength)
+        {
+            m_remaining = m_contentLength;
+            m_state = m_contentLength == 0 ? State::Complete : State::Body;
+        }
+        else
+        {
+            // 長さ指定がない場合は接続が閉じられるまでがボディ
+            m_keepAlive = false;
+            m_state = State::BodyUntilClose;
+        }
+    }
+
+    void ResponseParser::handleChunkSizeLine()
+    {
+        size_t chunkSize = 0;
+        size_t digits = 0;
+        for (char c : m_line)
+        {
+            int value;
+            if (c >= '0' && c <= '9')
+                value = c - '0';
+            else if (c >= 'a' && c <= 'f')
+                value = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                value = c - 'A' + 10;
+            else
+                break; // チャンク拡張 (;name=value) は無視する
+
+            if (chunkSize > (SIZE_MAX >> 4))
+            {
+                fail("Chunk size overflow");
+                return;
+            }
+            chunkSize = (chunkSize << 4) | value;
+            ++digits;
+        }
+
+        if (digits == 0)
+        {
+            fail("Invalid chunk size");
+            return;
+        }
+        m_line.clear();
+
+        if (chunkSize == 0)
+        {
+            m_state = State::Trailers;
+        }
+        else
+        {
+            m_remaining = chunkSize;
+            m_state = State::ChunkData;
+        }
+    }
+
+    void ResponseParser::handleTrailerLine()
+    {
+        if (m_line.empty())
+        {
+            m_state = State::Complete;
+            return;
+        }
+
+        std::string_view key;
+        std::string_view value;
+        if (splitHeaderLine(key, value) && m_trailerCallback)
+        {
+            m_trailerCallback(key, value);
+        }
+        m_line.clear();
+    }
+
+    bool ResponseParser::splitHeaderLine(std::string_view &key, std::string_view &value) const
+    {
+        size_t colonPos = m_line.find(':');
+        if (colonPos == std::string::npos || colonPos == 0)
+        {
+            return false;
+        }
+
+        size_t valueStart = m_line.find_first_not_of(" \t", colonPos + 1);
+        size_t valueEnd = m_line.find_last_not_of(" \t");
+        key = std::string_view(m_line).substr(0, colonPos);
+        if (valueStart != std::string::npos && valueEnd >= valueStart)
+        {
+            value = std::string_view(m_line).substr(valueStart, valueEnd - valueStart + 1);
+        }
+        return true;
+    }
+
+    void ResponseParser::emitBody(const uint8_t *data, size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        m_bodyBytesRead += size;
+        if (m_bodyCallback)
+        {
+            m_bodyCallback(reinterpret_cast<const char *>(data), size);
+        }
+    }
+
+    void ResponseParser::fail(const char *message)
+    {
+        m_errorMessage = message;
+        m_state = State::Error;
+    }
+
+} // namespace canaspad
\ No newline at end of file
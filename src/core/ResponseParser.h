@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+#include "../utils/HttpMethod.h"
+#include "Arena.h"
+
+namespace canaspad
+{
+
+    // HTTP/1.1 レスポンスの逐次パーサ
+    // 任意の断片境界で feed() でき、一度見たバイトを再走査しない
+    // コールバックへ渡す文字列は行バッファを指すため、呼び出し中のみ有効
+    class ResponseParser
+    {
+    public:
+        enum class State
+        {
+            StatusLine,
+            Headers,
+            Body,
+            BodyUntilClose,
+            ChunkSize,
+            ChunkData,
+            ChunkDataEnd,
+            Trailers,
+            Complete,
+            Error
+        };
+
+        using StatusCallback = std::function<void(int, std::string_view)>;
+        using HeaderCallback = std::function<void(std::string_view, std::string_view)>;
+        using BodyCallback = std::function<void(const char *, size_t)>;
+
+        // arena を渡した場合は行バッファをそこから確保する
+        explicit ResponseParser(Arena *arena = nullptr);
+
+        void reset();
+        void setRequestMethod(HttpMethod method);
+
+        void onStatus(StatusCallback callback);
+        void onHeader(HeaderCallback callback);
+        void onBody(BodyCallback callback);
+        void onTrailer(HeaderCallback callback);
+
+        // 消費したバイト数を返す (完了後の余剰バイトは消費しない)
+        size_t feed(const uint8_t *data, size_t size);
+        // 接続が閉じられたことを通知する
+        void finish();
+
+        State state() const { return m_state; }
+        bool isComplete() const { return m_state == State::Complete; }
+        bool hasError() const { return m_state == State::Error; }
+        bool headersComplete() const { return m_headersComplete; }
+        const std::string &errorMessage() const { return m_errorMessage; }
+
+        int statusCode() const { return m_statusCode; }
+        bool isChunked() const { return m_chunked; }
+        bool hasContentLength() const { return m_hasContentLength; }
+        size_t contentLength() const { return m_contentLength; }
+        size_t bodyBytesRead() const { return m_bodyBytesRead; }
+        bool keepAlive() const { return m_keepAlive; }
+
+        static constexpr size_t kMaxLineLength = 8192;
+
+    private:
+        State m_state;
+        HttpMethod m_requestMethod;
+        std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> m_line;
+        std::string m_errorMessage;
+
+        int m_statusCode;
+        bool m_chunked;
+        bool m_hasContentLength;
+        bool m_keepAlive;
+        bool m_headersComplete;
+        size_t m_contentLength;
+        size_t m_remaining;
+        size_t m_bodyBytesRead;
+
+        StatusCallback m_statusCallback;
+        HeaderCallback m_headerCallback;
+        BodyCallback m_bodyCallback;
+        HeaderCallback m_trailerCallback;
+
+        bool takeLine(const uint8_t *&p, const uint8_t *end);
+        void handleStatusLine();
+        void handleHeaderLine();
+        void handleHeadersComplete();
+        // 読み捨てる 1xx の中間レスポンス (101 Switching Protocols は最終レスポンスとして扱う)
+        bool isInterimResponse() const { return m_statusCode >= 100 && m_statusCode < 200 && m_statusCode != 101; }
+        void handleChunkSizeLine();
+        void handleTrailerLine();
+        bool splitHeaderLine(std::string_view &key, std::string_view &value) const;
+        void emitBody(const uint8_t *data, size_t size);
+        void fail(const char *message);
+    };
+
+} // namespace canaspad
\ No newline at end of file
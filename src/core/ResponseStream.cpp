@@ -0,0 +1,242 @@
+#include "ResponseStream.h"
+
+#if CANASPAD_HAS_COROUTINES
+
+#include <algorithm>
+#include <string>
+
+#include "ConnectionLease.h"
+#include "ResponseParser.h"
+#include "../utils/Log.h"
+
+namespace canaspad
+{
+
+    struct ResponseStream::State
+    {
+        std::shared_ptr<BufferedConnection> connection;
+        ConnectionLease lease;
+        ResponseParser parser;
+        HttpResult result;
+        std::string chunk;          // next() で返す本文の断片
+        bool chunkReturned = false; // chunk を返し終えた (次の next() で捨てる)
+        std::chrono::milliseconds readTimeout;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point pausedAt; // next() から戻った時刻
+        RequestTiming *timing = nullptr;                // readHead の間だけ設定する
+        size_t totalBytesRead = 0;
+        CancellationToken token;
+        std::function<void()> onFinished;
+        bool finished = false;
+
+        State(ConnectionPool &pool, ClientMetrics &metrics, std::shared_ptr<BufferedConnection> connection)
+            : connection(connection), lease(pool, std::move(connection), metrics) {}
+    };
+
+    ResponseStream::ResponseStream() = default;
+
+    ResponseStream::~ResponseStream()
+    {
+        if (m_state)
+        {
+            finish();
+        }
+    }
+
+    ResponseStream::ResponseStream(ResponseStream &&other) noexcept = default;
+
+    ResponseStream &ResponseStream::operator=(ResponseStream &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_state)
+            {
+                finish();
+            }
+            m_state = std::move(other.m_state);
+        }
+        return *this;
+    }
+
+    ResponseStream ResponseStream::open(ConnectionPool &pool, ClientMetrics &metrics, std::shared_ptr<BufferedConnection> connection,
+                                        HttpMethod method, std::chrono::milliseconds readTimeout, CancellationToken token,
+                                        std::function<void()> onFinished)
+    {
+        ResponseStream stream;
+        stream.m_state = std::make_unique<State>(pool, metrics, std::move(connection));
+        State *state = stream.m_state.get();
+        state->readTimeout = readTimeout;
+        state->token = std::move(token);
+        state->onFinished = std::move(onFinished);
+
+        ResponseParser &parser = state->parser;
+        parser.setRequestMethod(method);
+        parser.onStatus([state](int code, std::string_view message)
+                        {
+                            state->result.statusCode = code;
+                            state->result.statusMessage.assign(message.data(), message.size()); });
+        parser.onHeader([state](std::string_view key, std::string_view value)
+                        { state->result.headers.add(key, value); });
+        // チャンクのトレーラーは通常のヘッダーとして扱う
+        parser.onTrailer([state](std::string_view key, std::string_view value)
+                         { state->result.headers.add(key, value); });
+        parser.onBody([state](const char *data, size_t size)
+                      { state->chunk.append(data, size); });
+        return stream;
+    }
+
+    const HttpResult &ResponseStream::result() const { return m_state->result; }
+
+    HttpResult &ResponseStream::mutableResult() { return m_state->result; }
+
+    bool ResponseStream::done() const
+    {
+        return !m_state || m_state->finished;
+    }
+
+    Task<Result<void>> ResponseStream::readHead(RequestTiming *timing)
+    {
+        State *state = m_state.get();
+        // レスポンス全体を 1 つの期限で読み込む (next() の呼び出し側で止まっていた時間は含めない)
+        state->deadline = std::chrono::steady_clock::now() + state->readTimeout;
+        state->timing = timing;
+        while (!state->parser.headersComplete() && !state->parser.hasError())
+        {
+            auto received = co_await receive();
+            if (received.isError())
+            {
+                state->timing = nullptr;
+                finish();
+                co_return received;
+            }
+        }
+        state->timing = nullptr;
+        if (state->parser.hasError())
+        {
+            finish();
+            co_return ErrorInfo(ErrorCode::InvalidResponse, state->parser.errorMessage());
+        }
+        state->pausedAt = std::chrono::steady_clock::now();
+        if (state->parser.isComplete())
+        {
+            // 本文のないレスポンスはここで接続を返す
+            finish();
+        }
+        co_return Result<void>();
+    }
+
+    Task<Result<std::string_view>> ResponseStream::next()
+    {
+        State *state = m_state.get();
+        if (!state)
+        {
+            co_return std::string_view();
+        }
+        if (state->chunkReturned)
+        {
+            state->chunk.clear();
+            state->chunkReturned = false;
+        }
+        if (state->finished && !state->parser.isComplete())
+        {
+            // エラーで読み込みを打ち切った後は接続を返却済み
+            co_return ErrorInfo(ErrorCode::NetworkError, "Response stream is already closed");
+        }
+        state->deadline += std::chrono::steady_clock::now() - state->pausedAt;
+
+        while (state->chunk.empty() && !state->parser.isComplete() && !state->parser.hasError())
+        {
+            auto received = co_await receive();
+            if (received.isError())
+            {
+                finish();
+                co_return received.error();
+            }
+        }
+        if (state->parser.hasError())
+        {
+            finish();
+            co_return ErrorInfo(ErrorCode::InvalidResponse, state->parser.errorMessage());
+        }
+        if (state->parser.isComplete())
+        {
+            finish();
+        }
+
+        state->chunkReturned = true;
+        state->pausedAt = std::chrono::steady_clock::now();
+        co_return std::string_view(state->chunk);
+    }
+
+    Task<Result<void>> ResponseStream::receive()
+    {
+        State *state = m_state.get();
+        BufferedConnection *connection = state->connection.get();
+        if (state->token.cancelled())
+        {
+            co_return ErrorInfo(ErrorCode::RequestCancelled, "Request was cancelled");
+        }
+        if (connection->buffered() == 0)
+        {
+            auto waitUntil = state->token.valid() ? std::min(state->deadline, std::chrono::steady_clock::now() + CancellationToken::kCheckInterval)
+                                                  : state->deadline;
+            auto readiness = co_await Scheduler::readable(*connection, waitUntil);
+            if (readiness == ReadReadiness::TimedOut && waitUntil < state->deadline)
+            {
+                co_return Result<void>();
+            }
+            if (readiness == ReadReadiness::TimedOut)
+            {
+                CANASPAD_LOGW("ResponseStream::receive - Read timeout reached");
+                co_return ErrorInfo(ErrorCode::Timeout, "Read operation timed out while reading response");
+            }
+            if (readiness == ReadReadiness::Closed)
+            {
+                if (state->parser.state() == ResponseParser::State::BodyUntilClose)
+                {
+                    // 長さ指定のないボディは接続の終端で完了とする
+                    state->parser.finish();
+                    co_return Result<void>();
+                }
+                // 途中で切断された場合はネットワークエラーとして扱い、リトライの対象にする
+                co_return ErrorInfo(ErrorCode::NetworkError,
+                                    state->totalBytesRead == 0 ? "Connection closed before the response was received"
+                                                               : "Connection closed before the response was complete");
+            }
+            if (connection->fill() == 0)
+            {
+                co_return Result<void>();
+            }
+        }
+
+        if (state->timing && state->timing->firstByte == RequestTiming::TimePoint())
+        {
+            state->timing->firstByte = std::chrono::steady_clock::now();
+        }
+
+        // 受信バッファ上のデータをそのままパーサへ渡し、消費した分だけ進める
+        size_t consumed = state->parser.feed(connection->bufferedData(), connection->buffered());
+        connection->consume(consumed);
+        state->totalBytesRead += consumed;
+        co_return Result<void>();
+    }
+
+    void ResponseStream::finish()
+    {
+        State *state = m_state.get();
+        if (state->finished)
+        {
+            return;
+        }
+        state->finished = true;
+        if (state->parser.headersComplete() && state->onFinished)
+        {
+            state->onFinished();
+        }
+        // 最後まで読み切り、サーバーが接続を維持する場合のみ再利用できる
+        state->lease.release(state->parser.isComplete() && state->parser.keepAlive());
+    }
+
+} // namespace canaspad
+
+#endif // CANASPAD_HAS_COROUTINES
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../utils/Platform.h"
+
+#if CANASPAD_HAS_COROUTINES
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include "BufferedConnection.h"
+#include "CancellationToken.h"
+#include "ClientMetrics.h"
+#include "ConnectionPool.h"
+#include "Coroutine.h"
+#include "HttpResult.h"
+#include "RequestTiming.h"
+#include "../Result.h"
+#include "../utils/HttpMethod.h"
+
+namespace canaspad
+{
+
+    // HttpClient::openCo で受け取ったレスポンス。ステータスとヘッダーを受け取った状態から本文を少しずつ読み進める
+    // 本文を読み終えるか破棄すると接続をプールへ返す。作成した HttpClient より長く保持しない
+    class ResponseStream
+    {
+    public:
+        ResponseStream();
+        ~ResponseStream();
+        ResponseStream(ResponseStream &&other) noexcept;
+        ResponseStream &operator=(ResponseStream &&other) noexcept;
+
+        // ステータスとヘッダー (body は空。チャンクのトレーラーは読み終えた後に headers へ加わる)
+        const HttpResult &result() const;
+        int statusCode() const { return result().statusCode; }
+
+        // 本文の続きを受け取る。空の断片は終端を表す
+        // 受信を待つ間は Scheduler に制御を返す。返す文字列は次に next() を呼ぶまで有効
+        Task<Result<std::string_view>> next();
+        // 本文を最後まで受け取ったか
+        bool done() const;
+
+    private:
+        friend class HttpClient;
+        struct State;
+
+        std::unique_ptr<State> m_state;
+
+        // onFinished は読み終えたとき (または途中で破棄したとき) に接続を返却する前に呼ばれる
+        static ResponseStream open(ConnectionPool &pool, ClientMetrics &metrics, std::shared_ptr<BufferedConnection> connection,
+                                   HttpMethod method, std::chrono::milliseconds readTimeout, CancellationToken token,
+                                   std::function<void()> onFinished);
+        HttpResult &mutableResult();
+        // ステータスとヘッダーを受け取るまで読み進める
+        Task<Result<void>> readHead(RequestTiming *timing);
+        // 受信データを 1 回分パーサへ渡す (受信バッファが空の場合はデータの到着まで止まる)
+        // 取り消せるリクエストでは kCheckInterval ごとに戻り、何も渡さずに終わる場合がある
+        Task<Result<void>> receive();
+        void finish();
+    };
+
+} // namespace canaspad
+
+#endif // CANASPAD_HAS_COROUTINES
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "TlsSessionCache.h"
+
+#include <algorithm>
+
+namespace canaspad
+{
+
+    TlsSessionCache::TlsSessionCache(size_t capacity, std::chrono::milliseconds lifetime)
+        : m_capacity(capacity), m_lifetime(lifetime)
+    {
+    }
+
+    void TlsSessionCache::store(const std::string &key, std::vector<uint8_t> session)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insert(key, std::move(session), std::chrono::steady_clock::now());
+    }
+
+    bool TlsSessionCache::lookup(const std::string &key, std::vector<uint8_t> &session)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - it->second.storedAt > m_lifetime)
+        {
+            // 期限切れのセッションはサーバー側でも無効になっているため破棄する
+            m_entries.erase(it);
+            m_stats.evictions++;
+            return false;
+        }
+
+        it->second.lastUsed = now;
+        session = it->second.session;
+        return true;
+    }
+
+    void TlsSessionCache::remove(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.erase(key);
+    }
+
+    void TlsSessionCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    void TlsSessionCache::recordHandshake(bool resumed)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (resumed)
+        {
+            m_stats.resumedHandshakes++;
+        }
+        else
+        {
+            m_stats.fullHandshakes++;
+        }
+    }
+
+    TlsSessionCache::Stats TlsSessionCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.entries = m_entries.size();
+        return stats;
+    }
+
+    std::vector<TlsSessionCache::Snapshot> TlsSessionCache::snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        time_t wallNow = time(nullptr);
+        std::vector<Snapshot> entries;
+        for (const auto &[key, entry] : m_entries)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::seconds>(entry.storedAt + m_lifetime - now);
+            if (remaining.count() <= 0)
+            {
+                continue;
+            }
+            entries.push_back({key, entry.session, wallNow + static_cast<time_t>(remaining.count())});
+        }
+        return entries;
+    }
+
+    void TlsSessionCache::restore(const std::vector<Snapshot> &entries)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        time_t wallNow = time(nullptr);
+        for (const auto &entry : entries)
+        {
+            if (entry.expiresAt <= wallNow)
+            {
+                continue;
+            }
+            // 残り時間から保存時刻を逆算する
+            auto remaining = std::min<std::chrono::milliseconds>(std::chrono::seconds(entry.expiresAt - wallNow), m_lifetime);
+            insert(entry.key, entry.session, now - (m_lifetime - remaining));
+        }
+    }
+
+    std::string TlsSessionCache::makeKey(const std::string &host, int port)
+    {
+        return host + ":" + std::to_string(port);
+    }
+
+    void TlsSessionCache::insert(const std::string &key, std::vector<uint8_t> session, std::chrono::steady_clock::time_point storedAt)
+    {
+        if (m_capacity == 0 || session.empty())
+        {
+            return;
+        }
+
+        if (m_entries.find(key) == m_entries.end() && m_entries.size() >= m_capacity)
+        {
+            evictLeastRecentlyUsed();
+        }
+        m_entries[key] = {std::move(session), storedAt, std::chrono::steady_clock::now()};
+    }
+
+    void TlsSessionCache::evictLeastRecentlyUsed()
+    {
+        auto oldest = std::min_element(
+            m_entries.begin(), m_entries.end(),
+            [](const auto &a, const auto &b)
+            { return a.second.lastUsed < b.second.lastUsed; });
+        if (oldest != m_entries.end())
+        {
+            m_entries.erase(oldest);
+            m_stats.evictions++;
+        }
+    }
+
+} // namespace canaspad
\ No newline at end of file
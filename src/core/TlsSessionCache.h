@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+
+namespace canaspad
+{
+
+    // host:port ごとに TLS セッション (セッションチケット / セッションID) を保持し
+    // 次回の接続で簡略ハンドシェイクを行えるようにする
+    class TlsSessionCache
+    {
+    public:
+        struct Stats
+        {
+            size_t resumedHandshakes = 0; // セッション再開で完了したハンドシェイク
+            size_t fullHandshakes = 0;    // フルハンドシェイク
+            size_t evictions = 0;         // 容量超過または期限切れで破棄したセッション
+            size_t entries = 0;           // 現在保持しているセッション数
+        };
+
+        // スナップショット用のエントリ (有効期限はエポック秒)
+        struct Snapshot
+        {
+            std::string key;
+            std::vector<uint8_t> session;
+            time_t expiresAt;
+        };
+
+        TlsSessionCache(size_t capacity, std::chrono::milliseconds lifetime);
+
+        void store(const std::string &key, std::vector<uint8_t> session);
+        bool lookup(const std::string &key, std::vector<uint8_t> &session);
+        void remove(const std::string &key);
+        void clear();
+
+        void recordHandshake(bool resumed);
+        Stats getStats() const;
+
+        std::vector<Snapshot> snapshot() const;
+        void restore(const std::vector<Snapshot> &entries);
+
+        static std::string makeKey(const std::string &host, int port);
+
+    private:
+        struct Entry
+        {
+            std::vector<uint8_t> session;
+            std::chrono::steady_clock::time_point storedAt;
+            std::chrono::steady_clock::time_point lastUsed;
+        };
+
+        std::unordered_map<std::string, Entry> m_entries;
+        size_t m_capacity;
+        std::chrono::milliseconds m_lifetime;
+        mutable std::mutex m_mutex;
+        Stats m_stats;
+
+        void insert(const std::string &key, std::vector<uint8_t> session, std::chrono::steady_clock::time_point storedAt);
+        void evictLeastRecentlyUsed();
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "WarmState.h"
+
+#include <algorithm>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        // 形式: "HCWS" | version(1) | payload 長(4) | payload | FNV-1a(4)
+        // 数値はすべてリトルエンディアン、文字列は長さ(2) + バイト列
+        constexpr uint8_t kMagic[4] = {'H', 'C', 'W', 'S'};
+        constexpr size_t kHeaderSize = 9;
+        constexpr size_t kMaxPayloadSize = 64 * 1024;
+
+        uint32_t fnv1a(const uint8_t *data, size_t size)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ data[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        class Writer
+        {
+        public:
+            std::vector<uint8_t> buffer;
+
+            void u8(uint8_t value) { buffer.push_back(value); }
+            void u16(uint16_t value) { integer(value, 2); }
+            void u32(uint32_t value) { integer(value, 4); }
+            void i64(int64_t value) { integer(static_cast<uint64_t>(value), 8); }
+            void bytes(const uint8_t *data, size_t size)
+            {
+                u16(static_cast<uint16_t>(size));
+                buffer.insert(buffer.end(), data, data + size);
+            }
+            void string(const std::string &value)
+            {
+                bytes(reinterpret_cast<const uint8_t *>(value.data()), value.size());
+            }
+
+        private:
+            void integer(uint64_t value, size_t width)
+            {
+                for (size_t i = 0; i < width; ++i)
+                {
+                    buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+                }
+            }
+        };
+
+        class Reader
+        {
+        public:
+            Reader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+            bool ok() const { return m_ok; }
+            bool atEnd() const { return m_position == m_size; }
+
+            uint8_t u8() { return static_cast<uint8_t>(integer(1)); }
+            uint16_t u16() { return static_cast<uint16_t>(integer(2)); }
+            uint32_t u32() { return static_cast<uint32_t>(integer(4)); }
+            int64_t i64() { return static_cast<int64_t>(integer(8)); }
+            std::vector<uint8_t> bytes()
+            {
+                size_t size = u16();
+                if (!require(size))
+                {
+                    return {};
+                }
+                std::vector<uint8_t> value(m_data + m_position, m_data + m_position + size);
+                m_position += size;
+                return value;
+            }
+            std::string string()
+            {
+                auto value = bytes();
+                return std::string(value.begin(), value.end());
+            }
+
+        private:
+            const uint8_t *m_data;
+            size_t m_size;
+            size_t m_position = 0;
+            bool m_ok = true;
+
+            bool require(size_t size)
+            {
+                if (!m_ok || m_size - m_position < size)
+                {
+                    m_ok = false;
+                    return false;
+                }
+                return true;
+            }
+
+            uint64_t integer(size_t width)
+            {
+                if (!require(width))
+                {
+                    return 0;
+                }
+                uint64_t value = 0;
+                for (size_t i = 0; i < width; ++i)
+                {
+                    value |= static_cast<uint64_t>(m_data[m_position + i]) << (8 * i);
+                }
+                m_position += width;
+                return value;
+            }
+        };
+
+        bool readExactly(ByteSource &source, uint8_t *data, size_t size)
+        {
+            while (size > 0)
+            {
+                size_t count = source.read(data, size);
+                if (count == 0)
+                {
+                    return false;
+                }
+                data += count;
+                size -= count;
+            }
+            return true;
+        }
+
+        ErrorInfo invalidSnapshot(const char *message)
+        {
+            return ErrorInfo(ErrorCode::InvalidSnapshot, message);
+        }
+    } // namespace
+
+    BufferByteSink::BufferByteSink(uint8_t *buffer, size_t capacity)
+        : m_buffer(buffer), m_capacity(capacity)
+    {
+    }
+
+    bool BufferByteSink::write(const uint8_t *data, size_t size)
+    {
+        if (m_capacity - m_size < size)
+        {
+            return false;
+        }
+        std::copy(data, data + size, m_buffer + m_size);
+        m_size += size;
+        return true;
+    }
+
+    BufferByteSource::BufferByteSource(const uint8_t *buffer, size_t size)
+        : m_buffer(buffer), m_size(size)
+    {
+    }
+
+    size_t BufferByteSource::read(uint8_t *data, size_t size)
+    {
+        size_t count = std::min(size, m_size - m_position);
+        std::copy(m_buffer + m_position, m_buffer + m_position + count, data);
+        m_position += count;
+        return count;
+    }
+
+    FileByteSink::FileByteSink(const std::string &path) : m_file(fopen(path.c_str(), "wb")) {}
+
+    FileByteSink::~FileByteSink()
+    {
+        if (m_file)
+        {
+            fclose(m_file);
+        }
+    }
+
+    bool FileByteSink::write(const uint8_t *data, size_t size)
+    {
+        return m_file && fwrite(data, 1, size, m_file) == size;
+    }
+
+    FileByteSource::FileByteSource(const std::string &path) : m_file(fopen(path.c_str(), "rb")) {}
+
+    FileByteSource::~FileByteSource()
+    {
+        if (m_file)
+        {
+            fclose(m_file);
+        }
+    }
+
+    size_t FileByteSource::read(uint8_t *data, size_t size)
+    {
+        return m_file ? fread(data, 1, size, m_file) : 0;
+    }
+
+    Result<void> WarmState::writeTo(ByteSink &sink) const
+    {
+        Writer payload;
+        payload.u16(static_cast<uint16_t>(tlsSessions.size()));
+        for (const auto &entry : tlsSessions)
+        {
+            payload.string(entry.key);
+            payload.bytes(entry.session.data(), entry.session.size());
+            payload.i64(entry.expiresAt);
+        }
+        payload.u16(static_cast<uint16_t>(dnsEntries.size()));
+        for (const auto &entry : dnsEntries)
+        {
+            payload.string(entry.host);
+            payload.u32(entry.address);
+            payload.i64(entry.expiresAt);
+        }
+        payload.u16(static_cast<uint16_t>(cookies.size()));
+        for (const auto &cookie : cookies)
+        {
+            payload.string(cookie.name);
+            payload.string(cookie.value);
+            payload.string(cookie.domain);
+            payload.string(cookie.path);
+            payload.u8((cookie.secure ? 0x01 : 0) | (cookie.httpOnly ? 0x02 : 0));
+            payload.i64(cookie.expires);
+        }
+
+        if (payload.buffer.size() > kMaxPayloadSize)
+        {
+            return Result<void>(invalidSnapshot("Snapshot is too large"));
+        }
+
+        Writer header;
+        header.buffer.assign(kMagic, kMagic + sizeof(kMagic));
+        header.u8(kVersion);
+        header.u32(static_cast<uint32_t>(payload.buffer.size()));
+        Writer trailer;
+        trailer.u32(fnv1a(payload.buffer.data(), payload.buffer.size()));
+
+        if (!sink.write(header.buffer.data(), header.buffer.size()) ||
+            !sink.write(payload.buffer.data(), payload.buffer.size()) ||
+            !sink.write(trailer.buffer.data(), trailer.buffer.size()))
+        {
+            return Result<void>(invalidSnapshot("Failed to write snapshot"));
+        }
+        return Result<void>();
+    }
+
+    Result<WarmState> WarmState::readFrom(ByteSource &source)
+    {
+        uint8_t header[kHeaderSize];
+        if (!readExactly(source, header, sizeof(header)))
+        {
+            return Result<WarmState>(invalidSnapshot("Snapshot is empty or truncated"));
+        }
+        // 電源投入直後の RTC メモリなど、未初期化の領域を読んだ場合はここで弾く
+        if (!std::equal(kMagic, kMagic + sizeof(kMagic), header))
+        {
+            return Result<WarmState>(invalidSnapshot("Invalid snapshot header"));
+        }
+        if (header[4] != kVersion)
+        {
+            return Result<WarmState>(invalidSnapshot("Unsupported snapshot version"));
+        }
+
+        Reader headerReader(header + 5, 4);
+        size_t payloadSize = headerReader.u32();
+        if (payloadSize > kMaxPayloadSize)
+        {
+            return Result<WarmState>(invalidSnapshot("Invalid snapshot size"));
+        }
+
+        std::vector<uint8_t> payload(payloadSize + 4);
+        if (!readExactly(source, payload.data(), payload.size()))
+        {
+            return Result<WarmState>(invalidSnapshot("Snapshot is empty or truncated"));
+        }
+        Reader checksumReader(payload.data() + payloadSize, 4);
+        if (checksumReader.u32() != fnv1a(payload.data(), payloadSize))
+        {
+            return Result<WarmState>(invalidSnapshot("Snapshot checksum mismatch"));
+        }
+
+        WarmState state;
+        Reader reader(payload.data(), payloadSize);
+        for (size_t count = reader.u16(); count > 0 && reader.ok(); --count)
+        {
+            TlsSessionCache::Snapshot entry;
+            entry.key = reader.string();
+            entry.session = reader.bytes();
+            entry.expiresAt = static_cast<time_t>(reader.i64());
+            state.tlsSessions.push_back(std::move(entry));
+        }
+        for (size_t count = reader.u16(); count > 0 && reader.ok(); --count)
+        {
+            DnsCache::Snapshot entry;
+            entry.host = reader.string();
+            entry.address = reader.u32();
+            entry.expiresAt = static_cast<time_t>(reader.i64());
+            state.dnsEntries.push_back(std::move(entry));
+        }
+        for (size_t count = reader.u16(); count > 0 && reader.ok(); --count)
+        {
+            Cookie cookie;
+            cookie.name = reader.string();
+            cookie.value = reader.string();
+            cookie.domain = reader.string();
+            cookie.path = reader.string();
+            uint8_t flags = reader.u8();
+            cookie.secure = (flags & 0x01) != 0;
+            cookie.httpOnly = (flags & 0x02) != 0;
+            cookie.expires = static_cast<time_t>(reader.i64());
+            state.cookies.push_back(std::move(cookie));
+        }
+
+        if (!reader.ok() || !reader.atEnd())
+        {
+            return Result<WarmState>(invalidSnapshot("Malformed snapshot payload"));
+        }
+        return Result<WarmState>(std::move(state));
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../Result.h"
+#include "../cookie/Cookie.h"
+#include "TlsSessionCache.h"
+#include "DnsCache.h"
+
+namespace canaspad
+{
+
+    // スナップショットの書き込み先
+    class ByteSink
+    {
+    public:
+        virtual ~ByteSink() = default;
+        virtual bool write(const uint8_t *data, size_t size) = 0;
+    };
+
+    // スナップショットの読み込み元
+    class ByteSource
+    {
+    public:
+        virtual ~ByteSource() = default;
+        // 読み込んだバイト数を返す (終端では 0)
+        virtual size_t read(uint8_t *data, size_t size) = 0;
+    };
+
+    // 固定長バッファへの書き込み (RTC_DATA_ATTR の配列などに使用する)
+    class BufferByteSink : public ByteSink
+    {
+    public:
+        BufferByteSink(uint8_t *buffer, size_t capacity);
+        bool write(const uint8_t *data, size_t size) override;
+        size_t size() const { return m_size; }
+
+    private:
+        uint8_t *m_buffer;
+        size_t m_capacity;
+        size_t m_size = 0;
+    };
+
+    class BufferByteSource : public ByteSource
+    {
+    public:
+        BufferByteSource(const uint8_t *buffer, size_t size);
+        size_t read(uint8_t *data, size_t size) override;
+
+    private:
+        const uint8_t *m_buffer;
+        size_t m_size;
+        size_t m_position = 0;
+    };
+
+    // stdio のファイルへの書き込み (Linux のファイルや ESP32 の SPIFFS/LittleFS に使用する)
+    class FileByteSink : public ByteSink
+    {
+    public:
+        explicit FileByteSink(const std::string &path);
+        ~FileByteSink() override;
+        bool write(const uint8_t *data, size_t size) override;
+
+    private:
+        FILE *m_file;
+    };
+
+    class FileByteSource : public ByteSource
+    {
+    public:
+        explicit FileByteSource(const std::string &path);
+        ~FileByteSource() override;
+        size_t read(uint8_t *data, size_t size) override;
+
+    private:
+        FILE *m_file;
+    };
+
+    // ディープスリープを挟んで引き継ぐクライアントの状態
+    // TLS セッション、名前解決の結果、有効期限内のクッキーを保持する
+    struct WarmState
+    {
+        static constexpr uint8_t kVersion = 1;
+
+        std::vector<TlsSessionCache::Snapshot> tlsSessions;
+        std::vector<DnsCache::Snapshot> dnsEntries;
+        std::vector<Cookie> cookies;
+
+        Result<void> writeTo(ByteSink &sink) const;
+        static Result<WarmState> readFrom(ByteSource &source);
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "WiFiSecureConnection.h"
+#include <WiFi.h>
+#include <sys/select.h>
+#include <sys/time.h>
 
 namespace canaspad
 {
@@ -22,15 +25,32 @@ namespace canaspad
     }
 
     bool WiFiSecureConnection::connect(const std::string &host, int port)
+    {
+        IoProgress progress = beginConnect(host, port);
+        while (progress == IoProgress::WantWrite)
+        {
+            // 短い遅延を入れて再試行
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(m_nextAttempt - std::chrono::steady_clock::now());
+            if (remaining.count() > 0)
+            {
+                delay(remaining.count());
+            }
+            progress = continueConnect();
+        }
+        return progress == IoProgress::Done;
+    }
+
+    IoProgress WiFiSecureConnection::beginConnect(const std::string &host, int port)
     {
         // Keep-Alive接続のチェック
         if (isConnected() && isConnectionValid(host, port))
         {
-            return true;
+            return IoProgress::Done;
         }
 
         // 新しい接続を確立
-        auto connectStart = std::chrono::steady_clock::now();
+        m_connectStart = std::chrono::steady_clock::now();
+        m_connectTiming = ConnectTiming();
 
         if (m_verifySsl)
         {
@@ -55,37 +75,89 @@ namespace canaspad
         }
 
         setTimeout(m_connectTimeout.count());
-        bool result = false;
+        m_pendingHost = host;
+        m_pendingPort = port;
+        m_connecting = true;
+        return attemptConnect();
+    }
 
-        while (!result)
+    IoProgress WiFiSecureConnection::continueConnect()
+    {
+        if (!m_connecting)
         {
-            if (checkTimeout(connectStart, m_connectTimeout))
-            {
-                return false;
-            }
+            return IoProgress::Failed;
+        }
+        if (std::chrono::steady_clock::now() < m_nextAttempt)
+        {
+            // 再試行の間隔が過ぎるまで待つ
+            return IoProgress::WantWrite;
+        }
+        return attemptConnect();
+    }
+
+    IoProgress WiFiSecureConnection::attemptConnect()
+    {
+        if (checkTimeout(m_connectStart, m_connectTimeout))
+        {
+            m_connecting = false;
+            return IoProgress::Failed;
+        }
 
-            result =
-                WiFiClientSecure::connect(host.c_str(), port); // WiFiClientSecure::connect を呼び出す
-            if (!result)
+        // 名前解決を自前で行い、結果を再利用できるようにする
+        if (m_resolvedAddress == 0)
+        {
+            IPAddress address;
+            m_connectTiming.dnsStart = std::chrono::steady_clock::now();
+            if (WiFi.hostByName(m_pendingHost.c_str(), address) == 1)
             {
-                _lastError = getLastError();
-                // 短い遅延を入れて再試行
-                delay(100);
+                m_resolvedAddress = static_cast<uint32_t>(address);
             }
+            m_connectTiming.dnsEnd = std::chrono::steady_clock::now();
         }
 
-        if (result)
+        bool result = false;
+        if (m_resolvedAddress != 0)
         {
-            // 接続成功時に最終使用時刻と接続情報を更新
-            m_lastUsed = std::chrono::steady_clock::now();
-            m_connectedHost = host;
-            m_connectedPort = port;
+            // TCP 接続とハンドシェイクは一度に行われるため connectEnd は記録しない
+            m_connectTiming.connectStart = std::chrono::steady_clock::now();
+            // SNI と証明書の検証にはホスト名を渡す
+            result = WiFiClientSecure::connect(IPAddress(m_resolvedAddress), m_pendingPort, m_pendingHost.c_str(),
+                                               _CA_cert, _cert, _private_key);
+        }
+        if (!result)
+        {
+            // 古いアドレスの可能性があるため次の試行では名前解決し直す
+            m_resolvedAddress = 0;
+            _lastError = getLastError();
+            m_nextAttempt = std::chrono::steady_clock::now() + kRetryInterval;
+            return IoProgress::WantWrite;
         }
 
-        return result;
+        // 接続成功時に最終使用時刻と接続情報を更新
+        m_connecting = false;
+        m_lastUsed = std::chrono::steady_clock::now();
+        m_connectTiming.tlsEnd = m_lastUsed;
+        m_connectedHost = m_pendingHost;
+        m_connectedPort = m_pendingPort;
+        return IoProgress::Done;
     }
 
-    void WiFiSecureConnection::disconnect() { stop(); }
+    int WiFiSecureConnection::nativeHandle() const
+    {
+        // ハンドシェイクは WiFiClientSecure::connect の中で完了するため、記述子は受信待ちに使う
+        // 再試行を待っている間は失敗した試行の記述子が残っているため返さない
+        if (m_connecting)
+        {
+            return -1;
+        }
+        return sslclient != nullptr ? sslclient->socket : -1;
+    }
+
+    void WiFiSecureConnection::disconnect()
+    {
+        m_connecting = false;
+        stop();
+    }
 
     bool WiFiSecureConnection::isConnected() const
     {
@@ -111,13 +183,20 @@ namespace canaspad
     {
         setTimeout(m_readTimeout.count() /
                    1000); // WiFiSecureConnection::setTimeout() を呼び出す
+        // 1 バイトずつではなく、受信済みの分をまとめて読み込む
         std::string result;
-        result.reserve(size);
-        while (result.length() < size && available())
+        result.resize(size);
+        size_t total = 0;
+        while (total < size && available())
         {
-            char c = WiFiClientSecure::read();
-            result += c;
+            int count = WiFiClientSecure::read(reinterpret_cast<uint8_t *>(&result[total]), size - total);
+            if (count <= 0)
+            {
+                break;
+            }
+            total += count;
         }
+        result.resize(total);
         return result;
     }
 
@@ -206,4 +285,83 @@ namespace canaspad
 
     int WiFiSecureConnection::read() { return WiFiClientSecure::read(); }
 
+    bool WiFiSecureConnection::setTlsSession(const std::vector<uint8_t> &)
+    {
+        // WiFiClientSecure::connect はコンテキストの初期化からハンドシェイクまでを
+        // 一度に行うため、ハンドシェイク前にセッションを設定する手段がない
+        // セッションは受け取らず、常にフルハンドシェイクとなる
+        return false;
+    }
+
+    bool WiFiSecureConnection::getTlsSession(std::vector<uint8_t> &session) const
+    {
+        // 再開に使えないセッションを書き出しても、ヒープとスナップショットの領域を使うだけになる
+        // setTlsSession でセッションを適用できるようになるまでは書き出さない
+        return false;
+    }
+
+    bool WiFiSecureConnection::setResolvedAddress(uint32_t address)
+    {
+        m_resolvedAddress = address;
+        return true;
+    }
+
+    bool WiFiSecureConnection::getResolvedAddress(uint32_t &address) const
+    {
+        if (m_resolvedAddress == 0)
+        {
+            return false;
+        }
+        address = m_resolvedAddress;
+        return true;
+    }
+
+    bool WiFiSecureConnection::getConnectTiming(ConnectTiming &timing) const
+    {
+        if (m_connectTiming.dnsStart == std::chrono::steady_clock::time_point() &&
+            m_connectTiming.connectStart == std::chrono::steady_clock::time_point())
+        {
+            return false;
+        }
+        timing = m_connectTiming;
+        return true;
+    }
+
+    ReadReadiness WiFiSecureConnection::waitForData(std::chrono::steady_clock::time_point deadline)
+    {
+        while (true)
+        {
+            // mbedTLS が復号済みのデータを保持している場合はソケットを待たない
+            if (available() > 0)
+            {
+                return ReadReadiness::Ready;
+            }
+            if (sslclient == nullptr || sslclient->socket < 0 || !connected())
+            {
+                return ReadReadiness::Closed;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                return ReadReadiness::TimedOut;
+            }
+
+            // 期限までソケットが読み込み可能になるのを待つ
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+            struct timeval timeout;
+            timeout.tv_sec = static_cast<long>(remaining.count() / 1000000);
+            timeout.tv_usec = static_cast<long>(remaining.count() % 1000000);
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(sslclient->socket, &readSet);
+            int result = select(sslclient->socket + 1, &readSet, nullptr, nullptr, &timeout);
+            if (result < 0)
+            {
+                return ReadReadiness::Closed;
+            }
+            // 読み込み可能になっても TLS レコードが揃うまでは available() が 0 のことがあるため再確認する
+        }
+    }
+
 } // namespace canaspad
\ No newline at end of file
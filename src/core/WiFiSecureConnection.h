@@ -13,6 +13,10 @@ namespace canaspad
         ~WiFiSecureConnection() override;
 
         bool connect(const std::string &host, int port) override;
+        // 1 回の接続の試行ごとに戻る。失敗した場合は WantWrite を返し、再試行の間隔が過ぎた後の continueConnect で次を試す
+        IoProgress beginConnect(const std::string &host, int port) override;
+        IoProgress continueConnect() override;
+        int nativeHandle() const override;
         void disconnect() override;
         bool isConnected() const override;
         size_t write(const uint8_t *buf, size_t size) override;
@@ -33,6 +37,13 @@ namespace canaspad
         int available() override;
         int read() override;
 
+        bool setTlsSession(const std::vector<uint8_t> &session) override;
+        bool getTlsSession(std::vector<uint8_t> &session) const override;
+        bool setResolvedAddress(uint32_t address) override;
+        bool getResolvedAddress(uint32_t &address) const override;
+        bool getConnectTiming(ConnectTiming &timing) const override;
+        ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline) override;
+
     private:
         std::chrono::milliseconds m_connectTimeout{30000};
         std::chrono::milliseconds m_readTimeout{30000};
@@ -41,6 +52,15 @@ namespace canaspad
         std::string m_caCert = "";
         std::string m_clientCert = "";
         std::string m_privateKey = "";
+        uint32_t m_resolvedAddress = 0; // 名前解決済みのアドレス
+        ConnectTiming m_connectTiming;  // 直近の connect の各段階の時刻
+
+        // 進行中の beginConnect
+        bool m_connecting = false;
+        std::string m_pendingHost;
+        int m_pendingPort = 0;
+        std::chrono::steady_clock::time_point m_connectStart;
+        std::chrono::steady_clock::time_point m_nextAttempt; // 次の試行を始める時刻
 
         std::chrono::steady_clock::time_point m_lastUsed;
         std::chrono::milliseconds m_keepAliveTimeout{30000}; // デフォルト値を設定
@@ -48,7 +68,10 @@ namespace canaspad
         int m_connectedPort;
         int _lastError;
 
+        static constexpr std::chrono::milliseconds kRetryInterval{100}; // 接続の試行の間隔
+
         bool isConnectionValid(const std::string &host, int port) const;
+        IoProgress attemptConnect();
         bool checkTimeout(const std::chrono::steady_clock::time_point &start,
                           const std::chrono::milliseconds &timeout) const;
     };
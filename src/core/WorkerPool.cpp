@@ -0,0 +1,118 @@
+#include "WorkerPool.h"
+
+#if CANASPAD_PLATFORM_ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace canaspad
+{
+
+    WorkerPool::WorkerPool(const Options &options) : m_options(options)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < options.workers; ++i)
+        {
+#if CANASPAD_PLATFORM_ARDUINO
+            BaseType_t core = options.core < 0 ? tskNO_AFFINITY : options.core;
+            if (xTaskCreatePinnedToCore(&WorkerPool::taskEntry, "canaspad-http", options.stackSize, this,
+                                        options.priority, nullptr, core) != pdPASS)
+            {
+                // ヒープが足りない場合は起動できた分だけで動かす
+                break;
+            }
+#else
+            m_threads.emplace_back(&WorkerPool::taskEntry, this);
+#endif
+            ++m_running;
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        std::deque<Job> discarded;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_wake.notify_all();
+#if CANASPAD_PLATFORM_ARDUINO
+            // FreeRTOS のタスクは join できないため、終了の通知を待つ
+            m_exited.wait(lock, [this]()
+                          { return m_running == 0; });
+#endif
+        }
+#if CANASPAD_PLATFORM_POSIX
+        for (auto &thread : m_threads)
+        {
+            thread.join();
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            discarded.swap(m_queue);
+        }
+        for (auto &job : discarded)
+        {
+            job(true);
+        }
+    }
+
+    bool WorkerPool::submit(Job job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || m_running == 0 || m_queue.size() >= m_options.queueSize)
+            {
+                return false;
+            }
+            m_queue.push_back(std::move(job));
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    size_t WorkerPool::workers() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_running;
+    }
+
+    size_t WorkerPool::pending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+
+    void WorkerPool::workerLoop()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this]()
+                            { return m_stopping || !m_queue.empty(); });
+                if (m_stopping)
+                {
+                    break;
+                }
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            job(false);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_running;
+        m_exited.notify_all();
+    }
+
+    void WorkerPool::taskEntry(void *pool)
+    {
+        static_cast<WorkerPool *>(pool)->workerLoop();
+#if CANASPAD_PLATFORM_ARDUINO
+        vTaskDelete(nullptr);
+#endif
+    }
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../utils/Platform.h"
+
+namespace canaspad
+{
+
+    // キューに積まれたジョブを決まった数のワーカーで順に実行する
+    // 実機では指定したコアに固定した FreeRTOS タスク、ホストでは std::thread で動かす
+    class WorkerPool
+    {
+    public:
+        struct Options
+        {
+            size_t workers = 1;
+            size_t queueSize = 8;     // 実行待ちにできるジョブの数
+            size_t stackSize = 8192;  // タスクのスタックサイズ (バイト、実機のみ)
+            int priority = 1;         // タスクの優先度 (実機のみ)
+            int core = -1;            // タスクを固定するコア (-1 で固定しない、実機のみ)
+        };
+
+        // 引数は、実行せずに破棄する場合 (プールの破棄時にまだ始まっていなかった場合) に true
+        using Job = std::function<void(bool discarded)>;
+
+        explicit WorkerPool(const Options &options);
+        // 実行中のジョブの完了を待つ。実行待ちのジョブは discarded = true で呼び出して破棄する
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        // キューが一杯の場合やワーカーを起動できなかった場合は false (ジョブは呼び出されない)
+        bool submit(Job job);
+        // 起動しているワーカーの数
+        size_t workers() const;
+        // 実行待ちのジョブの数
+        size_t pending() const;
+
+    private:
+        Options m_options;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;   // ジョブの追加または停止を知らせる
+        std::condition_variable m_exited; // ワーカーの終了を知らせる
+        std::deque<Job> m_queue;
+        size_t m_running = 0; // 起動中のワーカー数
+        bool m_stopping = false;
+#if CANASPAD_PLATFORM_POSIX
+        std::vector<std::thread> m_threads;
+#endif
+
+        void workerLoop();
+        static void taskEntry(void *pool);
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "MockWiFiClientSecure.h"
+#include "../../utils/Log.h"
 #include <thread>
 #include <algorithm>
 
@@ -27,10 +28,12 @@ namespace canaspad
 
     bool MockWiFiClientSecure::connect(const std::string &host, int port)
     {
+        m_connectTiming = ConnectTiming();
         switch (m_connectBehavior)
         {
         case ConnectBehavior::AlwaysSuccess:
             m_connected = true;
+            completeHandshake();
             return true;
 
         case ConnectBehavior::AlwaysFail:
@@ -45,11 +48,13 @@ namespace canaspad
             else
             {
                 m_connected = true;
+                completeHandshake();
                 return true;
             }
 
         default:
             m_connected = true;
+            completeHandshake();
             return true;
         }
     }
@@ -66,7 +71,7 @@ namespace canaspad
 
     size_t MockWiFiClientSecure::write(const uint8_t *buf, size_t size)
     {
-        Serial.printf("MockWiFiClientSecure::write called. Size: %zu\n", size);
+        CANASPAD_LOGV("MockWiFiClientSecure::write called. Size: %zu", size);
 
         m_writePerformed += 1; // write メソッドが呼ばれたことを記録
 
@@ -95,7 +100,16 @@ namespace canaspad
             break;
         }
 
-        m_log.addSent(buf, size);
+        if (m_maxWriteSize > 0 && size > m_maxWriteSize)
+        {
+            size = m_maxWriteSize;
+        }
+
+        if (m_recordSent)
+        {
+            m_log.addSent(buf, size);
+        }
+        m_requestSentAt = std::chrono::steady_clock::now();
 
         return size;
     }
@@ -210,67 +224,130 @@ namespace canaspad
 
     int MockWiFiClientSecure::available()
     {
-        // Serial.printf("MockWiFiClientSecure::available() called. Connected: %d, Responses: %zu\n", m_connected, m_responses.size());
         if (!connected() || m_responses.empty())
         {
-            // Serial.println("MockWiFiClientSecure::available() - Not connected or no responses");
             return 0;
         }
 
-        int availableBytes = m_responses.front().size() - m_currentResponsePos;
-        // Serial.printf("MockWiFiClientSecure::available() - Available bytes: %d\n", availableBytes);
-        return availableBytes;
+        size_t released = releasedBytes();
+        return released > m_currentResponsePos ? static_cast<int>(released - m_currentResponsePos) : 0;
+    }
+
+    // 現在のレスポンスのうち、読み込みシナリオ上すでに届いているバイト数
+    size_t MockWiFiClientSecure::releasedBytes() const
+    {
+        if (m_responses.empty())
+        {
+            return 0;
+        }
+
+        size_t size = m_responses.front().size();
+        switch (m_readBehavior)
+        {
+        case ReadBehavior::Timeout:
+        case ReadBehavior::DropConnection:
+            return 0;
+
+        case ReadBehavior::SlowResponse:
+        {
+            if (m_slowResponseDelay.count() <= 0)
+            {
+                return size;
+            }
+            auto segments = (std::chrono::steady_clock::now() - m_requestSentAt) / m_slowResponseDelay;
+            return std::min(size, static_cast<size_t>(segments) * kSlowResponseSegmentSize);
+        }
+
+        default:
+            return size;
+        }
+    }
+
+    ReadReadiness MockWiFiClientSecure::waitForData(std::chrono::steady_clock::time_point deadline)
+    {
+        if (m_readBehavior == ReadBehavior::Timeout && m_connected)
+        {
+            // 接続を維持したまま何も届かない
+            std::this_thread::sleep_until(deadline);
+            return ReadReadiness::TimedOut;
+        }
+
+        while (true)
+        {
+            if (available() > 0)
+            {
+                return ReadReadiness::Ready;
+            }
+            if (m_readBehavior == ReadBehavior::DropConnection)
+            {
+                m_connected = false;
+            }
+            // 現在のレスポンスを読み切った後はサーバーが何も送らない (閉じた) ものとして扱う
+            if (!connected() || m_currentResponsePos >= m_responses.front().size())
+            {
+                return ReadReadiness::Closed;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return ReadReadiness::TimedOut;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     }
 
     void MockWiFiClientSecure::moveToNextResponse()
     {
         if (!m_responses.empty())
         {
-            Serial.println("MockWiFiClientSecure::moveToNextResponse - Moving to next response");
+            CANASPAD_LOGV("MockWiFiClientSecure::moveToNextResponse - Moving to next response");
             m_responses.pop_front();
             m_currentResponsePos = 0;
             m_readPerformed = m_writePerformed;
         }
         else
         {
-            Serial.println("MockWiFiClientSecure::moveToNextResponse - No more responses available");
+            CANASPAD_LOGV("MockWiFiClientSecure::moveToNextResponse - No more responses available");
         }
     }
 
     int MockWiFiClientSecure::read()
     {
-        Serial.printf("MockWiFiClientSecure::read() called. Connected: %d, Responses: %zu\n", m_connected, m_responses.size());
+        CANASPAD_LOGV("MockWiFiClientSecure::read() called. Connected: %d, Responses: %zu", m_connected, m_responses.size());
         if (!connected())
         {
-            Serial.println("MockWiFiClientSecure::read() - Not connected or no responses");
+            CANASPAD_LOGV("MockWiFiClientSecure::read() - Not connected or no responses");
             return -1;
         }
 
         const auto &currentResponse = m_responses.front();
-        if (m_currentResponsePos >= currentResponse.size())
+        if (available() <= 0)
         {
-            Serial.println("MockWiFiClientSecure::read() - End of current response");
+            CANASPAD_LOGV("MockWiFiClientSecure::read() - End of current response");
             return -1;
         }
 
         uint8_t data = currentResponse[m_currentResponsePos++];
-        m_log.addReceived(&data, 1);
-        Serial.printf("MockWiFiClientSecure::read() - Read byte: %02X\n", data);
+        if (m_recordReceived)
+        {
+            m_log.addReceived(&data, 1);
+        }
+        CANASPAD_LOGV("MockWiFiClientSecure::read() - Read byte: %02X", data);
         return data;
     }
 
     int MockWiFiClientSecure::read(uint8_t *buf, size_t size)
     {
         m_readPerformed += 1; // read メソッドが呼ばれたことを記録
-        Serial.printf("MockWiFiClientSecure::read called. Size: %zu\n", size);
+        CANASPAD_LOGV("MockWiFiClientSecure::read called. Size: %zu", size);
 
         if (!connected())
         {
             return 0;
         }
 
-        const auto currentResponse = m_responses.front();
-        size_t bytesAvailable = currentResponse.size() - m_currentResponsePos;
+        // レスポンス全体をコピーせず、要求された分だけ取り出す
+        const auto &currentResponse = m_responses.front();
+        size_t bytesAvailable = static_cast<size_t>(available());
         size_t bytesToRead = std::min(size, bytesAvailable);
 
         std::copy(currentResponse.begin() + m_currentResponsePos,
@@ -278,7 +355,10 @@ namespace canaspad
                   buf);
 
         m_currentResponsePos += bytesToRead;
-        m_log.addReceived(buf, bytesToRead);
+        if (m_recordReceived)
+        {
+            m_log.addReceived(buf, bytesToRead);
+        }
 
         return bytesToRead;
     }
@@ -288,6 +368,107 @@ namespace canaspad
         m_responses.push_back(response);
     }
 
+    void MockWiFiClientSecure::completeHandshake()
+    {
+        if (m_presetAddress == 0)
+        {
+            m_connectTiming.dnsStart = std::chrono::steady_clock::now();
+            m_dnsLookupCount++;
+            m_resolvedAddress = 0x0100007F; // 127.0.0.1
+            m_connectTiming.dnsEnd = std::chrono::steady_clock::now();
+        }
+        else
+        {
+            m_resolvedAddress = m_presetAddress;
+        }
+        m_presetAddress = 0;
+        m_connectTiming.connectStart = std::chrono::steady_clock::now();
+        m_connectTiming.connectEnd = m_connectTiming.connectStart;
+        if (m_handshakeDelay.count() > 0)
+        {
+            std::this_thread::sleep_for(m_handshakeDelay);
+        }
+
+        // セッションチケットと同様に、自身が発行した形式のセッションであれば
+        // 別のインスタンス (スリープ前のクライアント) が受け取ったものでも再開とみなす
+        static const std::string ticketPrefix = "mock-session-";
+        m_sessionResumed = m_sessionResumptionEnabled && m_offeredSession.size() > ticketPrefix.size() &&
+                           std::equal(ticketPrefix.begin(), ticketPrefix.end(), m_offeredSession.begin());
+        if (m_sessionResumed)
+        {
+            m_issuedSession = m_offeredSession;
+        }
+        else
+        {
+            std::string ticket = ticketPrefix + std::to_string(++m_handshakeCount);
+            m_issuedSession.assign(ticket.begin(), ticket.end());
+        }
+        m_offeredSession.clear();
+        m_connectTiming.tlsEnd = std::chrono::steady_clock::now();
+    }
+
+    bool MockWiFiClientSecure::getConnectTiming(ConnectTiming &timing) const
+    {
+        if (m_connectTiming.connectStart == std::chrono::steady_clock::time_point())
+        {
+            return false;
+        }
+        timing = m_connectTiming;
+        return true;
+    }
+
+    bool MockWiFiClientSecure::setResolvedAddress(uint32_t address)
+    {
+        m_presetAddress = address;
+        return true;
+    }
+
+    bool MockWiFiClientSecure::getResolvedAddress(uint32_t &address) const
+    {
+        if (!m_connected || m_resolvedAddress == 0)
+        {
+            return false;
+        }
+        address = m_resolvedAddress;
+        return true;
+    }
+
+    bool MockWiFiClientSecure::setTlsSession(const std::vector<uint8_t> &session)
+    {
+        m_offeredSession = session;
+        return true;
+    }
+
+    bool MockWiFiClientSecure::getTlsSession(std::vector<uint8_t> &session) const
+    {
+        if (!m_connected || m_issuedSession.empty())
+        {
+            return false;
+        }
+        session = m_issuedSession;
+        return true;
+    }
+
+    bool MockWiFiClientSecure::isTlsSessionResumed() const
+    {
+        return m_sessionResumed;
+    }
+
+    void MockWiFiClientSecure::setSessionResumptionEnabled(bool enabled)
+    {
+        m_sessionResumptionEnabled = enabled;
+    }
+
+    void MockWiFiClientSecure::setRecordReceivedData(bool record)
+    {
+        m_recordReceived = record;
+    }
+
+    void MockWiFiClientSecure::setRecordSentData(bool record)
+    {
+        m_recordSent = record;
+    }
+
     const CommunicationLog &MockWiFiClientSecure::getCommunicationLog() const
     {
         return m_log;
@@ -9,7 +9,6 @@
 #include <string>
 #include <chrono>
 #include <algorithm>
-#include <Arduino.h>
 
 namespace canaspad
 {
@@ -50,6 +49,8 @@ namespace canaspad
         std::chrono::milliseconds m_readTimeout{0};
         int m_writePerformed = 0;
         int m_readPerformed = 0;
+        bool m_recordReceived = true; // 受信データをログに記録するか
+        bool m_recordSent = true;     // 送信データをログに記録するか
 
         // SSL 関連の設定を保持する変数
         bool m_verifySsl;
@@ -57,6 +58,22 @@ namespace canaspad
         std::string m_clientCert;
         std::string m_clientPrivateKey;
 
+        // TLS セッション再開のシミュレーション
+        std::vector<uint8_t> m_offeredSession; // 次回の connect で提示されるセッション
+        std::vector<uint8_t> m_issuedSession;  // 直近のハンドシェイクで発行したセッション
+        bool m_sessionResumed = false;
+        bool m_sessionResumptionEnabled = true;
+        int m_handshakeCount = 0;
+
+        // 名前解決のシミュレーション
+        uint32_t m_presetAddress = 0;   // 次回の connect で使うアドレス
+        uint32_t m_resolvedAddress = 0; // 直近の接続で使ったアドレス
+        int m_dnsLookupCount = 0;
+
+        // 接続の各段階の時刻
+        ConnectTiming m_connectTiming;
+        std::chrono::milliseconds m_handshakeDelay{0}; // TLS ハンドシェイクにかかる時間
+
         // 接続シナリオ
         ConnectBehavior m_connectBehavior{ConnectBehavior::AlwaysSuccess}; // デフォルトは必ず成功
         int m_failCount{0};                                                // FailNTimesThenSuccess の場合の失敗回数
@@ -64,10 +81,12 @@ namespace canaspad
         // 読み込みシナリオ
         ReadBehavior m_readBehavior{ReadBehavior::Normal}; // デフォルトは正常
         std::chrono::milliseconds m_slowResponseDelay{0};  // SlowResponse の場合の遅延時間
+        std::chrono::steady_clock::time_point m_requestSentAt; // 直近のリクエストを書き込んだ時刻
 
         // 書き込みシナリオ
         WriteBehavior m_writeBehavior{WriteBehavior::Normal}; // デフォルトは正常
         std::chrono::milliseconds m_writeDelay{0};            // 書き込み遅延時間
+        size_t m_maxWriteSize{0};                             // 1 回の write で受け付ける最大バイト数 (0 は無制限)
 
     public:
         MockWiFiClientSecure(const ClientOptions &options);
@@ -90,6 +109,16 @@ namespace canaspad
         bool connected() const override;
         int available() override;
         int read() override;
+        bool setTlsSession(const std::vector<uint8_t> &session) override;
+        bool getTlsSession(std::vector<uint8_t> &session) const override;
+        bool isTlsSessionResumed() const override;
+        bool setResolvedAddress(uint32_t address) override;
+        bool getResolvedAddress(uint32_t &address) const override;
+        bool getConnectTiming(ConnectTiming &timing) const override;
+        ReadReadiness waitForData(std::chrono::steady_clock::time_point deadline) override;
+
+        // SlowResponse では書き込みから delay ごとにこのバイト数ずつ受信できるようになる
+        static constexpr size_t kSlowResponseSegmentSize = 16;
 
         // テスト用メソッド
         void injectResponse(const std::vector<uint8_t> &response);
@@ -99,16 +128,28 @@ namespace canaspad
         }
         void moveToNextResponse();
         const CommunicationLog &getCommunicationLog() const;
+        void setRecordReceivedData(bool record); // 大きなレスポンスの計測時はログへの複製を無効にする
+        void setRecordSentData(bool record);     // 大きなリクエストの計測時はログへの複製を無効にする
+        int getWriteCount() const { return m_writePerformed; }
+        void setMaxWriteSize(size_t size) { m_maxWriteSize = size; } // 送信バッファが詰まった場合の短い書き込みを模擬する
         void setOptions(const ClientOptions &options);
         void setConnectBehavior(ConnectBehavior behavior, int failCount = 0);
         void setReadBehavior(ReadBehavior behavior, std::chrono::milliseconds delay = std::chrono::milliseconds(0));
         void setWriteBehavior(WriteBehavior behavior, std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+        void setSessionResumptionEnabled(bool enabled); // false の場合はサーバーがセッションを拒否する
+        int getDnsLookupCount() const { return m_dnsLookupCount; }
+        int getHandshakeCount() const { return m_handshakeCount; }
+        void setHandshakeDelay(std::chrono::milliseconds delay) { m_handshakeDelay = delay; }
 
         // SSL 設定を確認するためのGetter メソッド
         bool getVerifySsl() const;
         const std::string &getCACert() const;
         const std::string &getClientCert() const;
         const std::string &getClientPrivateKey() const;
+
+    private:
+        void completeHandshake();
+        size_t releasedBytes() const;
     };
 
 } // namespace canaspad
\ No newline at end of file
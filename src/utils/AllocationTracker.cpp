@@ -0,0 +1,126 @@
+#include "AllocationTracker.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace canaspad
+{
+
+    namespace
+    {
+        // タスク (スレッド) ごとに数え、並行する送信の区間が互いの最大値を書き換えないようにする
+        // 他のタスクで確保したブロックを解放すると使用中バイト数は負になり得るため、符号付きで持つ
+        thread_local size_t t_count = 0;
+        thread_local size_t t_bytes = 0;
+        thread_local std::ptrdiff_t t_live = 0;
+        thread_local std::ptrdiff_t t_peak = 0;
+
+        void raisePeak(std::ptrdiff_t value)
+        {
+            if (value > t_peak)
+            {
+                t_peak = value;
+            }
+        }
+    } // namespace
+
+    AllocationScope::AllocationScope()
+        : m_startCount(t_count), m_startBytes(t_bytes), m_startLive(t_live)
+    {
+        // 外側の区間の最大値は抜けるときに戻す
+        m_savedPeak = t_peak;
+        t_peak = m_startLive;
+    }
+
+    AllocationScope::~AllocationScope()
+    {
+        raisePeak(m_savedPeak);
+    }
+
+    size_t AllocationScope::count() const
+    {
+        return t_count - m_startCount;
+    }
+
+    size_t AllocationScope::bytes() const
+    {
+        return t_bytes - m_startBytes;
+    }
+
+    size_t AllocationScope::peakBytes() const
+    {
+        return t_peak > m_startLive ? static_cast<size_t>(t_peak - m_startLive) : 0;
+    }
+
+    size_t AllocationScope::liveBytes() const
+    {
+        return t_live > m_startLive ? static_cast<size_t>(t_live - m_startLive) : 0;
+    }
+
+    AllocationStats AllocationScope::stats() const
+    {
+        AllocationStats stats;
+        stats.count = count();
+        stats.bytes = bytes();
+        stats.peakBytes = peakBytes();
+        return stats;
+    }
+
+} // namespace canaspad
+
+#if CANASPAD_ALLOC_TRACKING
+
+namespace
+{
+    // 解放時に使用中バイト数を減らせるよう、確保サイズをブロックの先頭に記録する
+    constexpr size_t kHeaderSize = alignof(std::max_align_t);
+}
+
+void *operator new(size_t size)
+{
+    void *block = std::malloc(kHeaderSize + size);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(block) = size;
+    ++canaspad::t_count;
+    canaspad::t_bytes += size;
+    canaspad::t_live += static_cast<std::ptrdiff_t>(size);
+    canaspad::raisePeak(canaspad::t_live);
+    return static_cast<char *>(block) + kHeaderSize;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p)
+    {
+        return;
+    }
+    void *block = static_cast<char *>(p) - kHeaderSize;
+    canaspad::t_live -= static_cast<std::ptrdiff_t>(*static_cast<size_t *>(block));
+    std::free(block);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+#endif // CANASPAD_ALLOC_TRACKING
\ No newline at end of file
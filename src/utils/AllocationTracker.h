@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+// operator new / delete を置き換えて、確保回数・確保バイト数・使用中バイト数を数える
+// platformio.ini の build_flags に -DCANASPAD_ALLOC_TRACKING=1 を指定すると有効になる (ユニットテストのビルドでは既定で有効)
+// 無効なビルドでは置き換えを行わず、計測値はすべて 0 になる
+#ifndef CANASPAD_ALLOC_TRACKING
+#ifdef PIO_UNIT_TESTING
+#define CANASPAD_ALLOC_TRACKING 1
+#else
+#define CANASPAD_ALLOC_TRACKING 0
+#endif
+#endif
+
+namespace canaspad
+{
+
+    struct AllocationStats
+    {
+        size_t count = 0;     // operator new の呼び出し回数
+        size_t bytes = 0;     // 確保したバイト数の合計
+        size_t peakBytes = 0; // 計測開始時点からの使用中バイト数の最大増加量
+    };
+
+    // 計測区間。入れ子にでき、内側の区間を抜けても外側の最大値は失われない
+    // カウンタはタスク (スレッド) ごとに持つため、区間を作ったタスクの確保だけを数える
+    // 他のタスクへ渡して解放したブロックは、解放したタスクの使用中バイト数から引かれる
+    class AllocationScope
+    {
+    public:
+        AllocationScope();
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope &) = delete;
+        AllocationScope &operator=(const AllocationScope &) = delete;
+
+        size_t count() const;
+        size_t bytes() const;
+        size_t peakBytes() const;
+        // 計測開始時点から増えた使用中バイト数
+        size_t liveBytes() const;
+        AllocationStats stats() const;
+
+        // このビルドで計測が有効か
+        static constexpr bool isEnabled() { return CANASPAD_ALLOC_TRACKING != 0; }
+
+    private:
+        size_t m_startCount;
+        size_t m_startBytes;
+        std::ptrdiff_t m_startLive;
+        std::ptrdiff_t m_savedPeak;
+    };
+
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "Log.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include "Platform.h"
+
+namespace canaspad
+{
+    namespace Log
+    {
+        namespace
+        {
+            const char *levelPrefix(Level level)
+            {
+                switch (level)
+                {
+                case Level::Error:
+                    return "[E] ";
+                case Level::Warn:
+                    return "[W] ";
+                case Level::Info:
+                    return "[I] ";
+                case Level::Debug:
+                    return "[D] ";
+                default:
+                    return "[V] ";
+                }
+            }
+
+            std::atomic<Sink> s_sink{serialSink};
+            std::atomic<Level> s_level{static_cast<Level>(CANASPAD_LOG_LEVEL)};
+        } // namespace
+
+        void serialSink(Level level, const char *message)
+        {
+            platform::writeLine(levelPrefix(level), message);
+        }
+
+        Sink setSink(Sink sink)
+        {
+            return s_sink.exchange(sink, std::memory_order_relaxed);
+        }
+
+        void setLevel(Level level)
+        {
+            s_level.store(level, std::memory_order_relaxed);
+        }
+
+        Level getLevel()
+        {
+            return s_level.load(std::memory_order_relaxed);
+        }
+
+        bool isEnabled(Level level)
+        {
+            return level != Level::None &&
+                   static_cast<uint8_t>(level) <= static_cast<uint8_t>(s_level.load(std::memory_order_relaxed)) &&
+                   s_sink.load(std::memory_order_relaxed) != nullptr;
+        }
+
+        void write(Level level, const char *format, ...)
+        {
+            // 無効なレベルでは整形も行わない
+            if (!isEnabled(level))
+            {
+                return;
+            }
+
+            // ヒープを使わずスタック上で整形する (長い行は切り詰める)
+            char buffer[192];
+            va_list args;
+            va_start(args, format);
+            vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+
+            Sink sink = s_sink.load(std::memory_order_relaxed);
+            if (sink)
+            {
+                sink(level, buffer);
+            }
+        }
+    } // namespace Log
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+// コンパイル時のログレベル
+// CANASPAD_LOG_LEVEL より詳細なログは呼び出しごと削除され、引数も評価されない
+// platformio.ini の build_flags に -DCANASPAD_LOG_LEVEL=4 などを指定して変更する
+#define CANASPAD_LOG_LEVEL_NONE 0
+#define CANASPAD_LOG_LEVEL_ERROR 1
+#define CANASPAD_LOG_LEVEL_WARN 2
+#define CANASPAD_LOG_LEVEL_INFO 3
+#define CANASPAD_LOG_LEVEL_DEBUG 4
+#define CANASPAD_LOG_LEVEL_VERBOSE 5
+
+#ifndef CANASPAD_LOG_LEVEL
+#define CANASPAD_LOG_LEVEL CANASPAD_LOG_LEVEL_WARN
+#endif
+
+namespace canaspad
+{
+    namespace Log
+    {
+        enum class Level : uint8_t
+        {
+            None = CANASPAD_LOG_LEVEL_NONE,
+            Error = CANASPAD_LOG_LEVEL_ERROR,
+            Warn = CANASPAD_LOG_LEVEL_WARN,
+            Info = CANASPAD_LOG_LEVEL_INFO,
+            Debug = CANASPAD_LOG_LEVEL_DEBUG,
+            Verbose = CANASPAD_LOG_LEVEL_VERBOSE
+        };
+
+        // 整形済みの 1 行を受け取る出力先 (既定は Serial、ホストのビルドでは標準エラー出力)
+        using Sink = void (*)(Level level, const char *message);
+
+        // 既定の出力先。レベルを付けて Serial (ホストのビルドでは標準エラー出力) に 1 行ずつ出力する
+        void serialSink(Level level, const char *message);
+
+        // nullptr を渡すとログを破棄する。以前の出力先を返す
+        Sink setSink(Sink sink);
+        // 実行時のレベル (コンパイル時に残したログをさらに絞り込む)
+        void setLevel(Level level);
+        Level getLevel();
+        bool isEnabled(Level level);
+
+        void write(Level level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+    } // namespace Log
+} // namespace canaspad
+
+#if CANASPAD_LOG_LEVEL >= CANASPAD_LOG_LEVEL_ERROR
+#define CANASPAD_LOGE(...) ::canaspad::Log::write(::canaspad::Log::Level::Error, __VA_ARGS__)
+#else
+#define CANASPAD_LOGE(...) ((void)0)
+#endif
+
+#if CANASPAD_LOG_LEVEL >= CANASPAD_LOG_LEVEL_WARN
+#define CANASPAD_LOGW(...) ::canaspad::Log::write(::canaspad::Log::Level::Warn, __VA_ARGS__)
+#else
+#define CANASPAD_LOGW(...) ((void)0)
+#endif
+
+#if CANASPAD_LOG_LEVEL >= CANASPAD_LOG_LEVEL_INFO
+#define CANASPAD_LOGI(...) ::canaspad::Log::write(::canaspad::Log::Level::Info, __VA_ARGS__)
+#else
+#define CANASPAD_LOGI(...) ((void)0)
+#endif
+
+#if CANASPAD_LOG_LEVEL >= CANASPAD_LOG_LEVEL_DEBUG
+#define CANASPAD_LOGD(...) ::canaspad::Log::write(::canaspad::Log::Level::Debug, __VA_ARGS__)
+#else
+#define CANASPAD_LOGD(...) ((void)0)
+#endif
+
+#if CANASPAD_LOG_LEVEL >= CANASPAD_LOG_LEVEL_VERBOSE
+#define CANASPAD_LOGV(...) ::canaspad::Log::write(::canaspad::Log::Level::Verbose, __VA_ARGS__)
+#else
+#define CANASPAD_LOGV(...) ((void)0)
+#endif
\ No newline at end of file
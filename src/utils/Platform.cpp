@@ -0,0 +1,47 @@
+#include "Platform.h"
+
+#include <ctime>
+
+#if CANASPAD_PLATFORM_ARDUINO
+#include <Arduino.h>
+#else
+#include <cstdio>
+#include <thread>
+#endif
+
+namespace canaspad
+{
+    namespace platform
+    {
+#if CANASPAD_PLATFORM_ARDUINO
+        void sleepFor(std::chrono::milliseconds duration)
+        {
+            delay(static_cast<unsigned long>(duration.count()));
+        }
+
+        void writeLine(const char *prefix, const char *message)
+        {
+            Serial.print(prefix);
+            Serial.println(message);
+        }
+#else
+        void sleepFor(std::chrono::milliseconds duration)
+        {
+            std::this_thread::sleep_for(duration);
+        }
+
+        void writeLine(const char *prefix, const char *message)
+        {
+            fprintf(stderr, "%s%s\n", prefix, message);
+        }
+#endif
+
+        bool isWallClockSet()
+        {
+            // 起動直後の ESP32 は 1970 年から数え始める
+            time_t now;
+            time(&now);
+            return now >= 3600 * 9;
+        }
+    } // namespace platform
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+
+// 実行環境の差異を吸収する
+// Arduino (ESP32) では Arduino のAPI、それ以外 (ホストの Linux ビルド) では標準ライブラリと POSIX を使う
+// 時刻はどちらの環境でも std::chrono::steady_clock を使う
+#if defined(ARDUINO)
+#define CANASPAD_PLATFORM_ARDUINO 1
+#else
+#define CANASPAD_PLATFORM_POSIX 1
+#endif
+
+// C++20 のコルーチンを使えるか (ESP32 の GCC 8 は対応していない)
+// 対応していないビルドでは HttpClient::sendCo などのコルーチンの API を提供しない
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define CANASPAD_HAS_COROUTINES 1
+#endif
+
+namespace canaspad
+{
+    namespace platform
+    {
+        // 呼び出したタスク (スレッド) を止める
+        void sleepFor(std::chrono::milliseconds duration);
+        // 1 行を出力する (Arduino では Serial、ホストでは標準エラー出力)
+        void writeLine(const char *prefix, const char *message);
+        // システム時刻が NTP などで設定済みか
+        bool isWallClockSet();
+    } // namespace platform
+} // namespace canaspad
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "Url.h"
+
+#include <cctype>
+
+namespace canaspad
+{
+
+    Url::Url() {}
+
+    Url::Url(const std::string &url) : m_url(url) { parse(); }
+
+    Url::Url(std::string &&url) : m_url(std::move(url)) { parse(); }
+
+    std::string_view Url::authorityHost() const
+    {
+        if (m_ipv6)
+        {
+            return std::string_view(m_url).substr(m_host.offset - 1, m_host.length + 2);
+        }
+        return host();
+    }
+
+    std::string_view Url::path() const
+    {
+        if (m_path.length == 0)
+        {
+            return "/";
+        }
+        return view(m_path);
+    }
+
+    void Url::parse()
+    {
+        const std::string &s = m_url;
+        const size_t size = s.size();
+        size_t pos = 0;
+
+        // スキーム
+        size_t schemeEnd = s.find("://");
+        if (schemeEnd != std::string::npos && schemeEnd > 0 && std::isalpha(static_cast<unsigned char>(s[0])))
+        {
+            bool schemeChars = true;
+            for (size_t i = 1; i < schemeEnd; ++i)
+            {
+                char c = s[i];
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '+' && c != '-' && c != '.')
+                {
+                    schemeChars = false;
+                    break;
+                }
+            }
+            if (schemeChars)
+            {
+                m_scheme = {0, schemeEnd};
+                pos = schemeEnd + 3;
+            }
+        }
+
+        // authority は最初の '/', '?', '#' まで
+        size_t authorityEnd = pos;
+        size_t userinfoEnd = std::string::npos;
+        while (authorityEnd < size && s[authorityEnd] != '/' && s[authorityEnd] != '?' && s[authorityEnd] != '#')
+        {
+            if (s[authorityEnd] == '@')
+            {
+                userinfoEnd = authorityEnd;
+            }
+            ++authorityEnd;
+        }
+        m_pathStart = authorityEnd;
+
+        size_t hostStart = pos;
+        if (userinfoEnd != std::string::npos)
+        {
+            m_userinfo = {pos, userinfoEnd - pos};
+            hostStart = userinfoEnd + 1;
+        }
+
+        m_valid = true;
+        size_t portStart = std::string::npos;
+        if (hostStart < authorityEnd && s[hostStart] == '[')
+        {
+            // IPv6 リテラル
+            size_t close = s.find(']', hostStart);
+            if (close == std::string::npos || close > authorityEnd)
+            {
+                m_valid = false;
+                m_host = {hostStart, authorityEnd - hostStart};
+            }
+            else
+            {
+                m_ipv6 = true;
+                m_host = {hostStart + 1, close - hostStart - 1};
+                if (close + 1 < authorityEnd)
+                {
+                    if (s[close + 1] == ':')
+                    {
+                        portStart = close + 2;
+                    }
+                    else
+                    {
+                        m_valid = false;
+                    }
+                }
+            }
+        }
+        else
+        {
+            size_t colon = s.find(':', hostStart);
+            if (colon != std::string::npos && colon < authorityEnd)
+            {
+                m_host = {hostStart, colon - hostStart};
+                portStart = colon + 1;
+            }
+            else
+            {
+                m_host = {hostStart, authorityEnd - hostStart};
+            }
+        }
+
+        // ポート番号 (空の場合は既定値)
+        if (portStart != std::string::npos && portStart < authorityEnd)
+        {
+            long port = 0;
+            for (size_t i = portStart; i < authorityEnd; ++i)
+            {
+                char c = s[i];
+                if (!std::isdigit(static_cast<unsigned char>(c)) || port > 65535)
+                {
+                    m_valid = false;
+                    break;
+                }
+                port = port * 10 + (c - '0');
+            }
+            if (port > 65535)
+            {
+                m_valid = false;
+            }
+            m_hasPort = true;
+            m_port = m_valid ? static_cast<int>(port) : -1;
+        }
+        else
+        {
+            m_port = scheme() == "https" ? 443 : 80;
+        }
+
+        // パス、クエリ、フラグメント
+        pos = authorityEnd;
+        size_t pathEnd = pos;
+        while (pathEnd < size && s[pathEnd] != '?' && s[pathEnd] != '#')
+        {
+            ++pathEnd;
+        }
+        m_path = {pos, pathEnd - pos};
+        pos = pathEnd;
+
+        if (pos < size && s[pos] == '?')
+        {
+            size_t queryEnd = s.find('#', pos + 1);
+            if (queryEnd == std::string::npos)
+            {
+                queryEnd = size;
+            }
+            m_query = {pos + 1, queryEnd - pos - 1};
+            pos = queryEnd;
+        }
+        if (pos < size && s[pos] == '#')
+        {
+            m_fragment = {pos + 1, size - pos - 1};
+        }
+    }
+
+} // namespace canaspad
\ No newline at end of file
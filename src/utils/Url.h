@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace canaspad
+{
+
+    // 一度だけ解析した URL
+    // 各要素は元の文字列へのオフセットとして保持するため、コピーしても再解析は不要
+    // scheme://userinfo@host:port/path?query#fragment
+    class Url
+    {
+    public:
+        Url();
+        explicit Url(const std::string &url);
+        explicit Url(std::string &&url);
+
+        // 構文として解釈できたか (ポート番号が数値でない・範囲外の場合は false)
+        bool isValid() const { return m_valid; }
+        bool empty() const { return m_url.empty(); }
+        const std::string &str() const { return m_url; }
+
+        std::string_view scheme() const { return view(m_scheme); }
+        std::string_view userinfo() const { return view(m_userinfo); }
+        // IPv6 リテラルは角括弧を除いたアドレス
+        std::string_view host() const { return view(m_host); }
+        // authority に書かれたままのホスト (IPv6 リテラルは角括弧付き)
+        std::string_view authorityHost() const;
+        bool isIpv6Literal() const { return m_ipv6; }
+        // 明示されていなければスキームの既定値 (https: 443, それ以外: 80)。不正な場合は -1
+        int port() const { return m_port; }
+        bool hasExplicitPort() const { return m_hasPort; }
+        // パスが空の場合は "/"
+        std::string_view path() const;
+        std::string_view query() const { return view(m_query); }
+        std::string_view fragment() const { return view(m_fragment); }
+        // scheme://authority (パス以降を除いた部分)
+        std::string_view origin() const { return std::string_view(m_url).substr(0, m_pathStart); }
+
+    private:
+        struct Range
+        {
+            size_t offset = 0;
+            size_t length = 0;
+        };
+
+        std::string m_url;
+        Range m_scheme;
+        Range m_userinfo;
+        Range m_host;
+        Range m_path;
+        Range m_query;
+        Range m_fragment;
+        size_t m_pathStart = 0; // authority の直後 (パス・クエリ・フラグメントの開始位置)
+        int m_port = -1;
+        bool m_hasPort = false;
+        bool m_ipv6 = false;
+        bool m_valid = false;
+
+        void parse();
+        std::string_view view(const Range &range) const { return std::string_view(m_url).substr(range.offset, range.length); }
+    };
+
+} // namespace canaspad
\ No newline at end of file
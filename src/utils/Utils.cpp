@@ -9,122 +9,34 @@ namespace canaspad
 
     std::string Utils::extractScheme(const std::string &url)
     {
-        std::string::size_type protocolEnd = url.find("://");
-        if (protocolEnd == std::string::npos)
-        {
-            return "";
-        }
-        else
-        {
-            return url.substr(0, protocolEnd);
-        }
+        return std::string(Url(url).scheme());
     }
 
     std::string Utils::extractHost(const std::string &url)
     {
-        std::string::size_type protocolEnd = url.find("://");
-        if (protocolEnd == std::string::npos)
-        {
-            protocolEnd = 0;
-        }
-        else
-        {
-            protocolEnd += 3;
-        }
-
-        // '@' の位置を探す
-        std::string::size_type authEnd = url.find('@', protocolEnd);
-        if (authEnd != std::string::npos)
-        {
-            // 認証情報がある場合は、'@' 以降からホスト名を抽出
-            protocolEnd = authEnd + 1;
-        }
-
-        // コロンの位置を探す
-        std::string::size_type colonPos = url.find(':', protocolEnd);
-
-        // pathStart をコロンかスラッシュの位置に設定
-        std::string::size_type pathStart = std::min(url.find('/', protocolEnd), colonPos);
-
-        if (pathStart == std::string::npos)
-        {
-            return url.substr(protocolEnd);
-        }
-        return url.substr(protocolEnd, pathStart - protocolEnd);
+        return std::string(Url(url).host());
     }
 
     int Utils::extractPort(const std::string &url)
     {
-        std::string::size_type protocolEnd = url.find("://");
-        if (protocolEnd == std::string::npos)
-        {
-            protocolEnd = 0;
-        }
-        else
-        {
-            protocolEnd += 3; // "://" の3文字分進める
-        }
-
-        // '@' の位置を探す
-        std::string::size_type authEnd = url.find('@', protocolEnd);
-        if (authEnd != std::string::npos)
-        {
-            // 認証情報がある場合は、'@' 以降からポート番号を抽出
-            protocolEnd = authEnd + 1;
-        }
-
-        // protocolEnd 以降でコロンの位置を探す
-        std::string::size_type colonPos = url.find(':', protocolEnd);
-
-        if (colonPos != std::string::npos)
-        {
-            return std::stoi(url.substr(colonPos + 1));
-        }
-        return url.substr(0, 5) == "https" ? 443 : 80;
+        return Url(url).port();
     }
 
     std::string Utils::extractPath(const std::string &url)
     {
-        std::string::size_type protocolEnd = url.find("://");
-        if (protocolEnd == std::string::npos)
-        {
-            protocolEnd = 0;
-        }
-        else
+        Url parsed(url);
+        std::string path(parsed.path());
+        if (!parsed.query().empty())
         {
-            protocolEnd += 3;
+            path += '?';
+            path += parsed.query();
         }
-        std::string::size_type pathStart = url.find('/', protocolEnd);
-        if (pathStart == std::string::npos)
-        {
-            return "/";
-        }
-        return url.substr(pathStart);
+        return path;
     }
 
     std::string Utils::extractBaseUrl(const std::string &url)
     {
-        // プロトコル部分の終わりを探す
-        std::string::size_type protocolEnd = url.find("://");
-        if (protocolEnd == std::string::npos)
-        {
-            protocolEnd = 0;
-        }
-        else
-        {
-            protocolEnd += 3;
-        }
-
-        // 最初の "/" の位置を探す。ただし、プロトコル部分の後の "//" はスキップする
-        std::string::size_type pathStart = url.find('/', protocolEnd + 2);
-
-        // "/" が見つからない場合、URL 全体がベース URL
-        if (pathStart == std::string::npos)
-        {
-            return url;
-        }
-
-        return url.substr(0, pathStart);
+        return std::string(Url(url).origin());
     }
 
     std::string Utils::extractProxyAuth(const std::string &proxyUrl)
@@ -241,11 +153,16 @@ namespace canaspad
             std::string value = headerLine.substr(colonPos + 1);
             value.erase(0, value.find_first_not_of(" "));
             value.erase(value.find_last_not_of("\r\n") + 1);
-            result.headers[key] = value;
+            result.headers.add(key, value);
         }
     }
 
     void Utils::parseCookie(const std::string &setCookieHeader, Cookie &cookie, const std::string &requestUrl)
+    {
+        parseCookie(setCookieHeader, cookie, Url(requestUrl));
+    }
+
+    void Utils::parseCookie(const std::string &setCookieHeader, Cookie &cookie, const Url &requestUrl)
     {
         std::istringstream iss(setCookieHeader);
         std::string token;
@@ -287,37 +204,32 @@ namespace canaspad
         // Domain 属性が指定されていない場合、リクエストURLのホスト部分を設定
         if (cookie.domain.empty())
         {
-            cookie.domain = Utils::extractHost(requestUrl);
+            cookie.domain = std::string(requestUrl.host());
         }
     }
 
-    std::string Utils::extractHeaderValue(const std::unordered_map<std::string, std::string> &headers, const std::string &key)
+    std::string Utils::extractHeaderValue(const HeaderMap &headers, const HeaderName &key)
     {
-        auto it = headers.find(key);
-        if (it != headers.end())
-        {
-            return it->second;
-        }
-        return "";
+        return std::string(headers.get(key));
     }
 
-    std::vector<std::string> Utils::extractHeaders(const std::unordered_map<std::string, std::string> &headers, const std::string &key)
+    std::vector<std::string> Utils::extractHeaders(const HeaderMap &headers, const HeaderName &key)
     {
         std::vector<std::string> result;
-        auto range = headers.equal_range(key);
-        for (auto it = range.first; it != range.second; ++it)
+        for (auto value : headers.getAll(key))
         {
-            result.push_back(it->second);
+            result.emplace_back(value);
         }
         return result;
     }
 
-    size_t Utils::extractContentLength(const std::unordered_map<std::string, std::string> &headers)
+    size_t Utils::extractContentLength(const HeaderMap &headers)
     {
-        auto it = headers.find("Content-Length");
-        if (it != headers.end())
+        auto value = headers.get(HeaderNames::ContentLength);
+        if (!value.empty())
         {
-            return std::stoul(it->second);
+            // 値は NUL 終端されている
+            return std::stoul(value.data());
         }
         return 0;
     }
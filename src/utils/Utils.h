@@ -5,6 +5,7 @@
 #include "../core/Request.h"
 #include "../cookie/Cookie.h"
 #include "../core/HttpResult.h"
+#include "Url.h"
 
 namespace canaspad
 {
@@ -12,6 +13,7 @@ namespace canaspad
     class Utils
     {
     public:
+        // 単発の抽出用。同じ URL を何度も参照する場合は Url を一度だけ作って使う
         static std::string extractScheme(const std::string &url);
         static std::string extractHost(const std::string &url);
         static int extractPort(const std::string &url);
@@ -24,9 +26,10 @@ namespace canaspad
         static void parseStatusLine(const std::string &statusLine, HttpResult &result);
         static void parseHeader(const std::string &headerLine, HttpResult &result);
         static void parseCookie(const std::string &setCookieHeader, Cookie &cookie, const std::string &requestUrl);
-        static std::string extractHeaderValue(const std::unordered_map<std::string, std::string> &headers, const std::string &key);
-        static std::vector<std::string> extractHeaders(const std::unordered_map<std::string, std::string> &headers, const std::string &key);
-        static size_t extractContentLength(const std::unordered_map<std::string, std::string> &headers);
+        static void parseCookie(const std::string &setCookieHeader, Cookie &cookie, const Url &requestUrl);
+        static std::string extractHeaderValue(const HeaderMap &headers, const HeaderName &key);
+        static std::vector<std::string> extractHeaders(const HeaderMap &headers, const HeaderName &key);
+        static size_t extractContentLength(const HeaderMap &headers);
         static void parseHeaders(const std::string &headers, HttpResult &result);
     };
 
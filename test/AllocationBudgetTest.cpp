@@ -0,0 +1,237 @@
+#include "AllocationBudgetTest.h"
+#include <memory>
+#include <string>
+
+#if CANASPAD_PLATFORM_POSIX
+#include <thread>
+#endif
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: 27\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "{\"status\":\"ok\",\"next\":3600}";
+
+    const char *kRedirect =
+        "HTTP/1.1 302 Found\r\n"
+        "Location: https://example.com/moved\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient, const char *response = kResponse)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+    }
+
+    std::unique_ptr<canaspad::HttpClient> newClient(canaspad::MockWiFiClientSecure **mockClient)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        (*mockClient)->setRecordSentData(false);
+        (*mockClient)->setRecordReceivedData(false);
+        return client;
+    }
+
+    // 接続の作成など初回のみの確保を除くため、一度送信してから計測する
+    canaspad::AllocationStats steadyStateSend(canaspad::HttpClient &client, canaspad::MockWiFiClientSecure *mockClient, canaspad::Arena *arena)
+    {
+        canaspad::Request request;
+        request.setUrl("https://example.com/status");
+        injectResponse(mockClient);
+        TEST_ASSERT_TRUE(client.send(request).isSuccess());
+
+        injectResponse(mockClient);
+        auto result = arena ? client.send(request, *arena) : client.send(request);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        return result.value().allocations;
+    }
+
+    void reportBudget(const char *name, const canaspad::AllocationStats &stats)
+    {
+        char message[128];
+        snprintf(message, sizeof(message), "%s: allocs=%zu bytes=%zu peak=%zu", name, stats.count, stats.bytes, stats.peakBytes);
+        TEST_MESSAGE(message);
+    }
+}
+
+// 送信 1 回あたりの確保の上限。ライブラリの変更で超えた場合はテストを失敗させる
+// 上限を緩める場合は、増えた理由をコミットに書くこと
+constexpr size_t kSmallGetMaxAllocs = 20;
+constexpr size_t kSmallGetMaxPeakBytes = 1024;
+constexpr size_t kArenaGetMaxAllocs = 10;
+// ストリーミング受信はボディの大きさによらず、受信バッファ 1 つ分と固定の余裕に収まる
+constexpr size_t kStreamingSlackBytes = 1024;
+
+void test_allocation_scope_nested_peak()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::AllocationScope outer;
+    {
+        std::unique_ptr<char[]> large(new char[4096]);
+        large[0] = 1;
+    }
+    {
+        canaspad::AllocationScope inner;
+        std::unique_ptr<char[]> small(new char[64]);
+        small[0] = 1;
+        TEST_ASSERT_EQUAL_INT(1, inner.count());
+        TEST_ASSERT_TRUE(inner.peakBytes() >= 64 && inner.peakBytes() < 4096);
+    }
+    // 内側の区間を抜けても外側の最大値は残る
+    TEST_ASSERT_EQUAL_INT(2, outer.count());
+    TEST_ASSERT_TRUE(outer.peakBytes() >= 4096);
+    TEST_ASSERT_EQUAL_INT(0, outer.liveBytes());
+}
+
+#if CANASPAD_PLATFORM_POSIX
+
+void test_allocation_scope_ignores_other_tasks()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::AllocationScope scope;
+    size_t otherPeak = 0;
+    std::thread other([&otherPeak]()
+                      {
+                          canaspad::AllocationScope otherScope;
+                          std::unique_ptr<char[]> large(new char[64 * 1024]);
+                          large[0] = 1;
+                          otherPeak = otherScope.peakBytes(); });
+    other.join();
+
+    // 同時に動く区間は互いの最大値を書き換えず、他のタスクの確保も数えない
+    TEST_ASSERT_TRUE(otherPeak >= 64 * 1024);
+    TEST_ASSERT_TRUE(scope.peakBytes() < 4096);
+}
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+void test_send_reports_allocations()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    auto stats = steadyStateSend(*client, mockClient, nullptr);
+    TEST_ASSERT_TRUE(stats.count > 0);
+    TEST_ASSERT_TRUE(stats.bytes >= stats.peakBytes);
+    TEST_ASSERT_TRUE(stats.peakBytes > 0);
+}
+
+void test_redirect_allocations_included()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    auto direct = steadyStateSend(*client, mockClient, nullptr);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/status");
+    injectResponse(mockClient, kRedirect);
+    injectResponse(mockClient);
+    auto result = client->send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+
+    // リダイレクト先への送信も含めて数える
+    TEST_ASSERT_TRUE(result.value().allocations.count > direct.count);
+}
+
+void test_allocation_budget_small_get()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    auto stats = steadyStateSend(*client, mockClient, nullptr);
+    reportBudget("small GET", stats);
+    TEST_ASSERT_TRUE(stats.count <= kSmallGetMaxAllocs);
+    TEST_ASSERT_TRUE(stats.peakBytes <= kSmallGetMaxPeakBytes);
+}
+
+void test_allocation_budget_arena_get()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    alignas(16) static uint8_t buffer[2048];
+    canaspad::Arena arena(buffer, sizeof(buffer));
+    auto stats = steadyStateSend(*client, mockClient, &arena);
+    reportBudget("small GET with arena", stats);
+    TEST_ASSERT_TRUE(stats.count <= kArenaGetMaxAllocs);
+}
+
+void test_allocation_budget_streaming_download()
+{
+    if (!canaspad::AllocationScope::isEnabled())
+    {
+        TEST_IGNORE_MESSAGE("CANASPAD_ALLOC_TRACKING is disabled");
+    }
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setRecordSentData(false);
+    mockClient->setRecordReceivedData(false);
+
+    // 4MB のボディ (レスポンス自体はモックが保持し、計測区間の外で確保する)
+    const size_t bodySize = 4 * 1024 * 1024;
+    std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(bodySize) + "\r\n\r\n";
+    response.resize(response.size() + bodySize, 'x');
+    mockClient->injectResponse(response);
+    response = std::string();
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/firmware.bin");
+    size_t totalBytes = 0;
+    auto result = client.sendStreaming(request, [&totalBytes](const char *, size_t size)
+                                       { totalBytes += size; });
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(bodySize, totalBytes);
+
+    // 接続と受信バッファの作成を含めても、ピークは受信バッファ 1 つ分に収まる
+    const auto &stats = result.value().allocations;
+    reportBudget("4MB streaming download", stats);
+    TEST_ASSERT_TRUE(stats.peakBytes <= options.readBufferSize + kStreamingSlackBytes);
+}
+
+void run_allocation_budget_tests(void)
+{
+    RUN_TEST(test_allocation_scope_nested_peak);
+#if CANASPAD_PLATFORM_POSIX
+    RUN_TEST(test_allocation_scope_ignores_other_tasks);
+#endif
+    RUN_TEST(test_send_reports_allocations);
+    RUN_TEST(test_redirect_allocations_included);
+    RUN_TEST(test_allocation_budget_small_get);
+    RUN_TEST(test_allocation_budget_arena_get);
+    RUN_TEST(test_allocation_budget_streaming_download);
+}
\ No newline at end of file
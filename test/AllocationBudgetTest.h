@@ -0,0 +1,15 @@
+#ifndef ALLOCATION_BUDGET_TEST_H
+#define ALLOCATION_BUDGET_TEST_H
+
+#include "helpers.h"
+
+void test_allocation_scope_nested_peak();
+void test_allocation_scope_ignores_other_tasks();
+void test_send_reports_allocations();
+void test_redirect_allocations_included();
+void test_allocation_budget_small_get();
+void test_allocation_budget_arena_get();
+void test_allocation_budget_streaming_download();
+void run_allocation_budget_tests(void);
+
+#endif // ALLOCATION_BUDGET_TEST_H
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "ArenaTest.h"
+#include <string>
+#include <vector>
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Date: Fri, 16 Oct 2026 09:00:00 GMT\r\n"
+        "Content-Type: application/json; charset=utf-8\r\n"
+        "Content-Length: 27\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+        "X-Request-Id: 5f1c2a7e-9d3b-4c1a-8e2f-0b6d4a9c3e71\r\n"
+        "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n"
+        "\r\n"
+        "{\"status\":\"ok\",\"next\":3600}";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(kResponse, kResponse + strlen(kResponse)));
+    }
+
+    bool isInside(const void *p, const void *buffer, size_t size)
+    {
+        auto address = reinterpret_cast<uintptr_t>(p);
+        auto begin = reinterpret_cast<uintptr_t>(buffer);
+        return address >= begin && address < begin + size;
+    }
+
+    // 確保できる最大の連続領域 (実機のみ)
+    size_t largestFreeBlock()
+    {
+#ifdef ESP_PLATFORM
+        return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#else
+        return 0;
+#endif
+    }
+
+    canaspad::HttpClient *newClient(canaspad::MockWiFiClientSecure **mockClient)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        auto *client = new canaspad::HttpClient(options, true);
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        (*mockClient)->setRecordSentData(false);
+        (*mockClient)->setRecordReceivedData(false);
+        return client;
+    }
+}
+
+void test_arena_alignment_and_reset()
+{
+    canaspad::Arena arena(256);
+    void *first = arena.allocate(3, 1);
+    void *aligned = arena.allocate(16, 8);
+    TEST_ASSERT_EQUAL_INT(0, reinterpret_cast<uintptr_t>(aligned) % 8);
+    TEST_ASSERT_TRUE(arena.used() >= 19);
+
+    // reset() 後は同じ領域を先頭から使い直す
+    arena.reset();
+    TEST_ASSERT_EQUAL_INT(0, arena.used());
+    TEST_ASSERT_TRUE(arena.allocate(3, 1) == first);
+    TEST_ASSERT_EQUAL_INT(0, arena.overflowBlocks());
+}
+
+void test_arena_fixed_buffer_overflow()
+{
+    alignas(16) uint8_t buffer[64];
+    canaspad::Arena arena(buffer, sizeof(buffer), 128);
+
+    void *inBuffer = arena.allocate(40, 8);
+    TEST_ASSERT_TRUE(isInside(inBuffer, buffer, sizeof(buffer)));
+
+    // 収まらない分はヒープのブロックを追加する
+    void *overflow = arena.allocate(40, 8);
+    TEST_ASSERT_FALSE(isInside(overflow, buffer, sizeof(buffer)));
+    void *large = arena.allocate(1000, 8);
+    TEST_ASSERT_NOT_NULL(large);
+    TEST_ASSERT_EQUAL_INT(2, arena.overflowBlocks());
+
+    arena.reset();
+    TEST_ASSERT_TRUE(arena.allocate(40, 8) == inBuffer);
+}
+
+void test_send_with_arena()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    std::unique_ptr<canaspad::HttpClient> client(newClient(&mockClient));
+    injectResponse(mockClient);
+
+    alignas(16) static uint8_t buffer[2048];
+    canaspad::Arena arena(buffer, sizeof(buffer));
+    canaspad::Request request;
+    request.setUrl("https://example.com/status");
+
+    auto result = client->send(request, arena);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    const auto &httpResult = result.value();
+    TEST_ASSERT_EQUAL_INT(200, httpResult.statusCode);
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"ok\",\"next\":3600}", httpResult.body.c_str());
+    TEST_ASSERT_EQUAL_INT(7, httpResult.headers.size());
+
+    // ヘッダーは呼び出し側のバッファに格納されている
+    auto type = httpResult.headers.get("content-type");
+    TEST_ASSERT_TRUE(type == "application/json; charset=utf-8");
+    TEST_ASSERT_TRUE(isInside(type.data(), buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_INT(0, arena.overflowBlocks());
+}
+
+void test_arena_result_copy_outlives_arena()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    std::unique_ptr<canaspad::HttpClient> client(newClient(&mockClient));
+    injectResponse(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/status");
+
+    canaspad::HttpResult copy;
+    {
+        canaspad::Arena arena;
+        auto result = client->send(request, arena);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        // コピーは通常のヒープに作られるため、arena を解放した後も使える
+        copy = canaspad::HttpResult(result.value());
+    }
+    TEST_ASSERT_TRUE(copy.headers.get("X-Request-Id") == "5f1c2a7e-9d3b-4c1a-8e2f-0b6d4a9c3e71");
+}
+
+// 長時間の連続送信でのヒープ使用
+// アプリケーションが少しずつ長寿命のデータを確保しながら送信を繰り返し、
+// 1 回の送信あたりの確保回数と、最後に確保できる最大の連続領域 (実機のみ) を比べる
+void benchmark_arena_soak_fragmentation()
+{
+    const int sendCount = 2000;
+    canaspad::Request request;
+    request.setUrl("https://example.com/status");
+
+    size_t heapAllocs = 0;
+    size_t heapLargest = 0;
+    {
+        canaspad::MockWiFiClientSecure *mockClient;
+        std::unique_ptr<canaspad::HttpClient> client(newClient(&mockClient));
+        std::vector<std::string> retained;
+        for (int i = 0; i < sendCount; ++i)
+        {
+            injectResponse(mockClient);
+            canaspad::AllocationScope counter;
+            TEST_ASSERT_TRUE(client->send(request).isSuccess());
+            heapAllocs += counter.count();
+            if (i % 20 == 0)
+            {
+                retained.emplace_back(48, 'r');
+            }
+        }
+        heapLargest = largestFreeBlock();
+    }
+
+    size_t arenaAllocs = 0;
+    size_t arenaLargest = 0;
+    {
+        canaspad::MockWiFiClientSecure *mockClient;
+        std::unique_ptr<canaspad::HttpClient> client(newClient(&mockClient));
+        alignas(16) static uint8_t buffer[2048];
+        canaspad::Arena arena(buffer, sizeof(buffer));
+        std::vector<std::string> retained;
+        for (int i = 0; i < sendCount; ++i)
+        {
+            injectResponse(mockClient);
+            canaspad::AllocationScope counter;
+            TEST_ASSERT_TRUE(client->send(request, arena).isSuccess());
+            arena.reset();
+            arenaAllocs += counter.count();
+            if (i % 20 == 0)
+            {
+                retained.emplace_back(48, 'r');
+            }
+        }
+        arenaLargest = largestFreeBlock();
+        TEST_ASSERT_EQUAL_INT(0, arena.overflowBlocks());
+    }
+
+    TEST_ASSERT_TRUE(arenaAllocs < heapAllocs);
+
+    char message[192];
+    snprintf(message, sizeof(message), "soak %d sends: heap allocs/send=%.1f largest free block(device)=%zu / arena allocs/send=%.1f largest free block(device)=%zu",
+             sendCount, static_cast<double>(heapAllocs) / sendCount, heapLargest,
+             static_cast<double>(arenaAllocs) / sendCount, arenaLargest);
+    TEST_MESSAGE(message);
+}
+
+void run_arena_tests(void)
+{
+    RUN_TEST(test_arena_alignment_and_reset);
+    RUN_TEST(test_arena_fixed_buffer_overflow);
+    RUN_TEST(test_send_with_arena);
+    RUN_TEST(test_arena_result_copy_outlives_arena);
+    RUN_TEST(benchmark_arena_soak_fragmentation);
+}
\ No newline at end of file
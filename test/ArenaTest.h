@@ -0,0 +1,13 @@
+#ifndef ARENA_TEST_H
+#define ARENA_TEST_H
+
+#include "helpers.h"
+
+void test_arena_alignment_and_reset();
+void test_arena_fixed_buffer_overflow();
+void test_send_with_arena();
+void test_arena_result_copy_outlives_arena();
+void benchmark_arena_soak_fragmentation();
+void run_arena_tests(void);
+
+#endif // ARENA_TEST_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "AsyncSendTest.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if CANASPAD_PLATFORM_POSIX
+#include "LoopbackServer.h"
+#endif
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "hello";
+
+    std::unique_ptr<canaspad::HttpClient> newClient(canaspad::MockWiFiClientSecure **mockClient, size_t queueSize = 8)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        options.asyncQueueSize = queueSize;
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        client->setReadTimeout(std::chrono::milliseconds(100));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        (*mockClient)->injectResponse(std::vector<uint8_t>(kResponse, kResponse + strlen(kResponse)));
+        return client;
+    }
+
+    canaspad::Request newRequest()
+    {
+        canaspad::Request request;
+        request.setUrl("https://example.com/upload");
+        return request;
+    }
+}
+
+void test_send_async_returns_before_completion()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    mockClient->setHandshakeDelay(std::chrono::milliseconds(100));
+
+    // ハンドシェイクに 100ms かかるため、送信を待って戻った場合は完了している
+    auto pending = client->sendAsync(newRequest());
+    TEST_ASSERT_TRUE(pending.valid());
+    TEST_ASSERT_FALSE(pending.ready());
+
+    // 送信中も呼び出し側のタスクは処理を続けられる
+    int samples = 0;
+    while (!pending.ready())
+    {
+        ++samples;
+        canaspad::platform::sleepFor(std::chrono::milliseconds(5));
+    }
+    TEST_ASSERT_TRUE(samples >= 5);
+
+    const auto &result = pending.get();
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    TEST_ASSERT_EQUAL_STRING("hello", result.value().body.c_str());
+}
+
+void test_send_async_completion_callback()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+
+    std::atomic<int> statusCode{0};
+    auto pending = client->sendAsync(newRequest(), [&statusCode](const canaspad::Result<canaspad::HttpResult> &result)
+                                     { statusCode = result.isSuccess() ? result.value().statusCode : -1; });
+    TEST_ASSERT_TRUE(pending.waitFor(std::chrono::seconds(2)));
+    // 完了を待ち終えた時点でコールバックは呼ばれている
+    TEST_ASSERT_EQUAL_INT(200, statusCode.load());
+
+    // 完了後に登録したコールバックはその場で呼ばれる
+    bool called = false;
+    pending.then([&called](const canaspad::Result<canaspad::HttpResult> &result)
+                 { called = result.isSuccess(); });
+    TEST_ASSERT_TRUE(called);
+}
+
+void test_send_async_queue_full()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient, 1);
+    mockClient->setHandshakeDelay(std::chrono::milliseconds(200));
+
+    auto first = client->sendAsync(newRequest());
+    // ワーカーが 1 件目を取り出すのを待つ
+    canaspad::platform::sleepFor(std::chrono::milliseconds(50));
+    auto second = client->sendAsync(newRequest());
+    auto third = client->sendAsync(newRequest());
+
+    // キューに入らなかったリクエストは完了済みのエラーとして返る
+    TEST_ASSERT_TRUE(third.ready());
+    TEST_ASSERT_TRUE(third.get().isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::QueueFull), static_cast<int>(third.get().error().code));
+    TEST_ASSERT_FALSE(second.ready());
+
+    TEST_ASSERT_TRUE(first.get().isSuccess());
+    second.wait();
+}
+
+void test_send_async_discarded_on_destroy()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    mockClient->setHandshakeDelay(std::chrono::milliseconds(100));
+
+    auto first = client->sendAsync(newRequest());
+    canaspad::platform::sleepFor(std::chrono::milliseconds(30));
+    auto second = client->sendAsync(newRequest());
+
+    // 破棄は実行中の送信を待ち、始まっていない送信を取り消す
+    client.reset();
+    TEST_ASSERT_TRUE(first.ready());
+    TEST_ASSERT_TRUE(first.get().isSuccess());
+    TEST_ASSERT_TRUE(second.ready());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::RequestCancelled), static_cast<int>(second.get().error().code));
+}
+
+#if CANASPAD_PLATFORM_POSIX
+
+void test_send_async_overlaps_hosts()
+{
+    LoopbackServer::Options serverOptions;
+    serverOptions.behavior = LoopbackServer::Behavior::Slow;
+    serverOptions.bodySize = 64;
+    serverOptions.slowPieces = 3;
+    serverOptions.slowDelay = std::chrono::milliseconds(100);
+    LoopbackServer a(serverOptions);
+    LoopbackServer b(serverOptions);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    options.asyncWorkers = 2;
+    canaspad::HttpClient client(options);
+
+    canaspad::Request requestA, requestB;
+    requestA.setUrl(a.url("/a"));
+    requestB.setUrl(b.url("/b"));
+    auto pendingA = client.sendAsync(requestA);
+    auto pendingB = client.sendAsync(requestB);
+    TEST_ASSERT_TRUE(pendingA.get().isSuccess());
+    TEST_ASSERT_TRUE(pendingB.get().isSuccess());
+
+    // それぞれ 200ms かかるレスポンスを並行して受け取る (一方を送り終える前に他方の受信が終わらない)
+    const auto &timingA = pendingA.get().value().timing;
+    const auto &timingB = pendingB.get().value().timing;
+    TEST_ASSERT_TRUE(timingA.requestSent < timingB.responseEnd);
+    TEST_ASSERT_TRUE(timingB.requestSent < timingA.responseEnd);
+    TEST_ASSERT_EQUAL_INT(2, client.getMetrics().requests);
+}
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+void run_async_send_tests(void)
+{
+    RUN_TEST(test_send_async_returns_before_completion);
+    RUN_TEST(test_send_async_completion_callback);
+    RUN_TEST(test_send_async_queue_full);
+    RUN_TEST(test_send_async_discarded_on_destroy);
+#if CANASPAD_PLATFORM_POSIX
+    RUN_TEST(test_send_async_overlaps_hosts);
+#endif
+}
\ No newline at end of file
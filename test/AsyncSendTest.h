@@ -0,0 +1,13 @@
+#ifndef ASYNC_SEND_TEST_H
+#define ASYNC_SEND_TEST_H
+
+#include "helpers.h"
+
+void test_send_async_returns_before_completion();
+void test_send_async_completion_callback();
+void test_send_async_queue_full();
+void test_send_async_discarded_on_destroy();
+void test_send_async_overlaps_hosts();
+void run_async_send_tests(void);
+
+#endif // ASYNC_SEND_TEST_H
\ No newline at end of file
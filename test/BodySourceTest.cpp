@@ -0,0 +1,236 @@
+#include "BodySourceTest.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    const char *kResponse = "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(kResponse, kResponse + strlen(kResponse)));
+    }
+
+    std::string allSentData(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        std::string sent;
+        for (const auto &entry : mockClient->getCommunicationLog().getLog())
+        {
+            if (entry.type == canaspad::CommunicationLog::Entry::Type::Sent &&
+                entry.source == canaspad::CommunicationLog::SourceType::Client)
+            {
+                sent.append(entry.data.begin(), entry.data.end());
+            }
+        }
+        return sent;
+    }
+
+    // 文字列を少しずつ返すリーダー
+    canaspad::CallbackBodySource::Reader stringReader(const std::string &data, size_t *position)
+    {
+        return [data, position](uint8_t *buf, size_t size)
+        {
+            size_t n = std::min(size, data.size() - *position);
+            std::memcpy(buf, data.data() + *position, n);
+            *position += n;
+            return n;
+        };
+    }
+
+    // 先頭へ戻せる本文
+    class RewindableSource : public canaspad::BodySource
+    {
+    public:
+        explicit RewindableSource(std::string data) : m_data(std::move(data)) {}
+        bool contentLength(size_t &length) const override
+        {
+            length = m_data.size();
+            return true;
+        }
+        int rewindCount = 0;
+
+    protected:
+        size_t read(uint8_t *buf, size_t size) override
+        {
+            size_t n = std::min(size, m_data.size() - m_offset);
+            std::memcpy(buf, m_data.data() + m_offset, n);
+            m_offset += n;
+            return n;
+        }
+        bool rewind() override
+        {
+            m_offset = 0;
+            rewindCount++;
+            return true;
+        }
+
+    private:
+        std::string m_data;
+        size_t m_offset = 0;
+    };
+}
+
+void test_body_reader_with_content_length()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.uploadChunkSize = 16;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    std::vector<std::pair<size_t, size_t>> progress;
+    client.setProgressCallback([&progress](size_t sent, size_t total)
+                               { progress.emplace_back(sent, total); });
+
+    const std::string payload = "line 1: boot\nline 2: connected\nline 3: sample\n";
+    size_t position = 0;
+    canaspad::Request request;
+    request.setUrl("https://example.com/logs").setMethod(canaspad::HttpMethod::POST).setBodyReader(stringReader(payload, &position), payload.size());
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(201, result.value().statusCode);
+
+    std::string sent = allSentData(mockClient);
+    std::string expectedTail = "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+    TEST_ASSERT_TRUE(sent.find(expectedTail) != std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Transfer-Encoding") == std::string::npos);
+
+    // uploadChunkSize ごとに送信済みバイト数と全体の長さが通知される
+    TEST_ASSERT_EQUAL_INT((payload.size() + 15) / 16, progress.size());
+    TEST_ASSERT_EQUAL_INT(16, progress.front().first);
+    TEST_ASSERT_EQUAL_INT(payload.size(), progress.back().first);
+    TEST_ASSERT_EQUAL_INT(payload.size(), progress.back().second);
+}
+
+void test_body_reader_chunked()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.uploadChunkSize = 8;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    size_t lastTotal = 1;
+    client.setProgressCallback([&lastTotal](size_t, size_t total)
+                               { lastTotal = total; });
+
+    const std::string payload = "camera-frame-bytes";
+    size_t position = 0;
+    canaspad::Request request;
+    request.setUrl("https://example.com/frames").setMethod(canaspad::HttpMethod::POST).setBodyReader(stringReader(payload, &position));
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    std::string sent = allSentData(mockClient);
+    TEST_ASSERT_TRUE(sent.find("Content-Length") == std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Transfer-Encoding: chunked\r\n\r\n"
+                               "8\r\ncamera-f\r\n"
+                               "8\r\nrame-byt\r\n"
+                               "2\r\nes\r\n"
+                               "0\r\n\r\n") != std::string::npos);
+    // 長さが分からない場合は全体を 0 として通知する
+    TEST_ASSERT_EQUAL_INT(0, lastTotal);
+}
+
+void test_body_source_short_writes()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+    // 1 回の write で 7 バイトしか受け付けない
+    mockClient->setMaxWriteSize(7);
+
+    std::string payload(300, 'a');
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    size_t position = 0;
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBodyReader(stringReader(payload, &position));
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    // 短い書き込みの続きを送り、バイト列が欠けたり重複したりしない
+    std::string sent = allSentData(mockClient);
+    TEST_ASSERT_TRUE(sent.find("\r\n\r\n12c\r\n" + payload + "\r\n0\r\n\r\n") != std::string::npos);
+}
+
+void test_body_source_ended_early()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    const std::string payload = "short";
+    size_t position = 0;
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBodyReader(stringReader(payload, &position), 64);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::InvalidBody, result.error().code);
+}
+
+void test_body_source_retry_requires_rewind()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 2;
+    options.retryDelay = std::chrono::milliseconds(1);
+    const std::string payload = "retry-me";
+
+    // 巻き戻せないリーダーは読み始めた後はリトライしない
+    {
+        canaspad::HttpClient client(options, true);
+        auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+        mockClient->setReadBehavior(canaspad::ReadBehavior::DropConnection);
+        int readerCalls = 0;
+        canaspad::Request request;
+        request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBodyReader([&readerCalls, &payload](uint8_t *buf, size_t size)
+                                                                                                         {
+            readerCalls++;
+            if (readerCalls > 1)
+            {
+                return size_t(0);
+            }
+            std::memcpy(buf, payload.data(), payload.size());
+            return payload.size(); },
+                                                                                                         payload.size());
+        auto result = client.send(request);
+        TEST_ASSERT_TRUE(result.isError());
+        TEST_ASSERT_EQUAL(canaspad::ErrorCode::NetworkError, result.error().code);
+        TEST_ASSERT_EQUAL_INT(1, readerCalls);
+    }
+
+    // 巻き戻せる本文はリトライのたびに先頭から送り直す
+    {
+        canaspad::HttpClient client(options, true);
+        auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+        mockClient->setReadBehavior(canaspad::ReadBehavior::DropConnection);
+        auto source = std::make_shared<RewindableSource>(payload);
+        canaspad::Request request;
+        request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBodySource(source);
+        auto result = client.send(request);
+        TEST_ASSERT_TRUE(result.isError());
+        TEST_ASSERT_EQUAL_INT(2, source->rewindCount);
+    }
+}
+
+void run_body_source_tests(void)
+{
+    RUN_TEST(test_body_reader_with_content_length);
+    RUN_TEST(test_body_reader_chunked);
+    RUN_TEST(test_body_source_short_writes);
+    RUN_TEST(test_body_source_ended_early);
+    RUN_TEST(test_body_source_retry_requires_rewind);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef BODY_SOURCE_TEST_H
+#define BODY_SOURCE_TEST_H
+
+#include "helpers.h"
+
+void test_body_reader_with_content_length();
+void test_body_reader_chunked();
+void test_body_source_short_writes();
+void test_body_source_ended_early();
+void test_body_source_retry_requires_rewind();
+void run_body_source_tests(void);
+
+#endif // BODY_SOURCE_TEST_H
\ No newline at end of file
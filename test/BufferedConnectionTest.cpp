@@ -0,0 +1,141 @@
+#include "BufferedConnectionTest.h"
+#include "../src/core/BufferedConnection.h"
+#include "../src/core/ResponseParser.h"
+#include <cstring>
+
+namespace
+{
+    // 下位の接続への read 呼び出し回数を数える
+    class CountingConnection : public canaspad::MockWiFiClientSecure
+    {
+    public:
+        using canaspad::MockWiFiClientSecure::MockWiFiClientSecure;
+        using canaspad::MockWiFiClientSecure::read;
+
+        int read(uint8_t *buf, size_t size) override
+        {
+            readCalls++;
+            return canaspad::MockWiFiClientSecure::read(buf, size);
+        }
+        int read() override
+        {
+            readCalls++;
+            return canaspad::MockWiFiClientSecure::read();
+        }
+
+        int readCalls = 0;
+    };
+
+    std::shared_ptr<CountingConnection> makeConnection(const std::string &data)
+    {
+        canaspad::ClientOptions options;
+        auto connection = std::make_shared<CountingConnection>(options);
+        connection->injectResponse(data);
+        connection->connect("example.com", 443);
+        return connection;
+    }
+}
+
+void test_buffered_connection_reads_in_bulk()
+{
+    auto inner = makeConnection("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nX-Test: 1\r\n\r\nhello");
+    canaspad::BufferedConnection connection(inner, 256);
+
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("Content-Length: 5", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("X-Test: 1", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("hello", connection.read(5).c_str());
+
+    // レスポンス全体が 1 回の読み込みで取得される
+    TEST_ASSERT_EQUAL_INT(1, inner->readCalls);
+}
+
+void test_buffered_connection_read_line()
+{
+    // バッファより長い行や \r のない改行も扱える
+    std::string longLine(300, 'a');
+    auto inner = makeConnection(longLine + "\r\nshort\nlast");
+    canaspad::BufferedConnection connection(inner, 64);
+
+    TEST_ASSERT_TRUE(connection.readLine() == longLine);
+    TEST_ASSERT_EQUAL_STRING("short", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("last", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_INT(0, connection.available());
+}
+
+void test_buffered_connection_read_until_respects_capacity()
+{
+    auto inner = makeConnection("1a2b;ext=1\r\n");
+    canaspad::BufferedConnection connection(inner, 64);
+
+    char out[4];
+    bool found = false;
+    size_t count = connection.readUntil(';', out, sizeof(out), found);
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL_INT(4, count);
+    TEST_ASSERT_TRUE(memcmp(out, "1a2b", 4) == 0);
+
+    // 呼び出し元のバッファが一杯になった場合は区切り文字を消費せずに戻る
+    count = connection.readUntil('\n', out, sizeof(out), found);
+    TEST_ASSERT_FALSE(found);
+    TEST_ASSERT_EQUAL_INT(4, count);
+    TEST_ASSERT_TRUE(memcmp(out, "ext=", 4) == 0);
+
+    count = connection.readUntil('\n', out, sizeof(out), found);
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL_INT(2, count);
+}
+
+void test_buffered_connection_peek_does_not_consume()
+{
+    auto inner = makeConnection("AB");
+    canaspad::BufferedConnection connection(inner, 64);
+
+    TEST_ASSERT_EQUAL_INT('A', connection.peek());
+    TEST_ASSERT_EQUAL_INT('A', connection.peek());
+    TEST_ASSERT_EQUAL_INT('A', connection.read());
+    TEST_ASSERT_EQUAL_INT('B', connection.read());
+    TEST_ASSERT_EQUAL_INT(-1, connection.peek());
+}
+
+void test_buffered_connection_large_read_bypasses_buffer()
+{
+    std::string body(1000, 'x');
+    auto inner = makeConnection(body);
+    canaspad::BufferedConnection connection(inner, 64);
+
+    uint8_t buffer[1000];
+    int count = connection.read(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_INT(1000, count);
+    TEST_ASSERT_EQUAL_INT(0, connection.buffered());
+    TEST_ASSERT_EQUAL_INT(1, inner->readCalls);
+}
+
+void test_pooled_connection_keeps_bytes_after_response()
+{
+    canaspad::ClientOptions options;
+    canaspad::ConnectionPool pool(options, [options](const std::string &)
+                                  { return makeConnection("HTTP/1.1 200 Connection established\r\n\r\n\x16\x03\x01"); });
+    auto connection = pool.getConnection("http", "proxy.example.com", 8080).value();
+    connection->fill();
+
+    canaspad::ResponseParser parser;
+    parser.setRequestMethod(canaspad::HttpMethod::CONNECT);
+    connection->consume(parser.feed(connection->bufferedData(), connection->buffered()));
+
+    // CONNECT 応答の後ろに届いたデータは失われない
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_INT(3, connection->buffered());
+    TEST_ASSERT_EQUAL_INT(0x16, connection->peek());
+}
+
+void run_buffered_connection_tests(void)
+{
+    RUN_TEST(test_buffered_connection_reads_in_bulk);
+    RUN_TEST(test_buffered_connection_read_line);
+    RUN_TEST(test_buffered_connection_read_until_respects_capacity);
+    RUN_TEST(test_buffered_connection_peek_does_not_consume);
+    RUN_TEST(test_buffered_connection_large_read_bypasses_buffer);
+    RUN_TEST(test_pooled_connection_keeps_bytes_after_response);
+}
\ No newline at end of file
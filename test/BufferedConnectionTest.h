@@ -0,0 +1,14 @@
+#ifndef BUFFERED_CONNECTION_TEST_H
+#define BUFFERED_CONNECTION_TEST_H
+
+#include "helpers.h"
+
+void test_buffered_connection_reads_in_bulk();
+void test_buffered_connection_read_line();
+void test_buffered_connection_read_until_respects_capacity();
+void test_buffered_connection_peek_does_not_consume();
+void test_buffered_connection_large_read_bypasses_buffer();
+void test_pooled_connection_keeps_bytes_after_response();
+void run_buffered_connection_tests(void);
+
+#endif // BUFFERED_CONNECTION_TEST_H
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "CancellationTest.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#if CANASPAD_PLATFORM_POSIX
+#include "LoopbackServer.h"
+#endif
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "hello";
+
+    std::unique_ptr<canaspad::HttpClient> newMockClient(canaspad::MockWiFiClientSecure **mockClient, int maxRetries = 0)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = maxRetries;
+        options.asyncWorkers = 1;
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        client->setReadTimeout(std::chrono::milliseconds(100));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        return client;
+    }
+
+    canaspad::Request newRequest(const std::string &url, const char *id = nullptr)
+    {
+        canaspad::Request request;
+        request.setUrl(url);
+        if (id)
+        {
+            request.setId(id);
+        }
+        return request;
+    }
+
+    int errorCode(const canaspad::Result<canaspad::HttpResult> &result)
+    {
+        return result.isError() ? static_cast<int>(result.error().code) : 0;
+    }
+
+    const int kCancelled = static_cast<int>(canaspad::ErrorCode::RequestCancelled);
+}
+
+void test_cancel_unknown_id()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(kResponse));
+
+    TEST_ASSERT_FALSE(client->cancel("missing"));
+    // 送信を終えたリクエストの登録は残らない
+    TEST_ASSERT_TRUE(client->send(newRequest("https://example.com/", "done")).isSuccess());
+    TEST_ASSERT_FALSE(client->cancel("done"));
+}
+
+void test_cancelled_token_fails_before_sending()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(kResponse));
+
+    auto token = canaspad::CancellationToken::create();
+    token.cancel();
+    canaspad::Request request = newRequest("https://example.com/");
+    request.setCancellationToken(token);
+
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(client->send(request)));
+    // 取り消していないリクエストには影響しない
+    TEST_ASSERT_TRUE(client->send(newRequest("https://example.com/")).isSuccess());
+}
+
+void test_cancel_during_retry_delay()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 3;
+    options.retryDelay = std::chrono::seconds(10);
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::AlwaysFail);
+
+    bool found = false;
+    std::thread canceller([&client, &found]()
+                          {
+                              canaspad::platform::sleepFor(std::chrono::milliseconds(50));
+                              found = client.cancel("upload"); });
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(newRequest("https://example.com/upload", "upload"));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    // リトライ前の待ち時間 (10 秒) を待たずに戻る
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(result));
+    TEST_ASSERT_TRUE(elapsed < std::chrono::seconds(5));
+}
+
+void test_resend_after_cancel()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 3;
+    options.retryDelay = std::chrono::seconds(10);
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::AlwaysFail);
+
+    canaspad::Request request = newRequest("https://example.com/upload", "upload");
+    std::thread canceller([&client]()
+                          {
+                              canaspad::platform::sleepFor(std::chrono::milliseconds(50));
+                              client.cancel("upload"); });
+    auto cancelled = client.send(request);
+    canceller.join();
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(cancelled));
+
+    // ID による取り消しはその送信だけに効き、同じリクエストやそのコピーは送り直せる
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::AlwaysSuccess);
+    mockClient->injectResponse(std::string(kResponse));
+    mockClient->injectResponse(std::string(kResponse));
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    canaspad::Request copy = request;
+    TEST_ASSERT_TRUE(client.send(copy).isSuccess());
+}
+
+void test_cancel_during_stalled_write()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    client.setWriteTimeout(std::chrono::seconds(10));
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->injectResponse(std::string(kResponse));
+    // 送信バッファが空かない状態を模擬する
+    mockClient->setWriteBehavior(canaspad::WriteBehavior::Timeout);
+
+    bool found = false;
+    std::thread canceller([&client, &found]()
+                          {
+                              canaspad::platform::sleepFor(std::chrono::milliseconds(50));
+                              found = client.cancel("upload"); });
+    canaspad::Request request = newRequest("https://example.com/upload", "upload");
+    request.setMethod(canaspad::HttpMethod::POST).setBody("payload");
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    // write タイムアウト (10 秒) を待たずに戻る
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(result));
+    TEST_ASSERT_TRUE(elapsed < std::chrono::seconds(5));
+}
+
+void test_cancel_queued_async_request()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(kResponse));
+    mockClient->setHandshakeDelay(std::chrono::milliseconds(100));
+
+    auto first = client->sendAsync(newRequest("https://example.com/first", "first"));
+    auto second = client->sendAsync(newRequest("https://example.com/second", "second"));
+    // ワーカーを待っている送信も取り消せる
+    TEST_ASSERT_TRUE(client->cancel("second"));
+
+    TEST_ASSERT_TRUE(first.get().isSuccess());
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(second.get()));
+}
+
+#if CANASPAD_PLATFORM_POSIX
+
+namespace
+{
+    LoopbackServer::Options slowServerOptions()
+    {
+        LoopbackServer::Options options;
+        options.behavior = LoopbackServer::Behavior::Slow;
+        options.bodySize = 64;
+        options.slowPieces = 30;
+        options.slowDelay = std::chrono::milliseconds(100);
+        return options;
+    }
+
+    canaspad::ClientOptions hostOptions()
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        return options;
+    }
+}
+
+void test_cancel_keeps_other_pooled_connections()
+{
+    LoopbackServer fast(LoopbackServer::Options{});
+    LoopbackServer slow(slowServerOptions());
+    canaspad::HttpClient client(hostOptions());
+
+    TEST_ASSERT_TRUE(client.send(newRequest(fast.url("/warm"))).isSuccess());
+
+    std::optional<canaspad::Result<canaspad::HttpResult>> slowResult;
+    std::chrono::steady_clock::duration elapsed;
+    std::thread sender([&]()
+                       {
+                           auto start = std::chrono::steady_clock::now();
+                           slowResult.emplace(client.send(newRequest(slow.url("/slow"), "slow")));
+                           elapsed = std::chrono::steady_clock::now() - start; });
+    canaspad::platform::sleepFor(std::chrono::milliseconds(150));
+    TEST_ASSERT_TRUE(client.cancel("slow"));
+    sender.join();
+
+    // 3 秒かかるレスポンスの途中で打ち切る
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(*slowResult));
+    TEST_ASSERT_TRUE(elapsed < std::chrono::seconds(2));
+
+    // 他のホストへの接続はプールに残り、次の送信で再利用する
+    auto result = client.send(newRequest(fast.url("/again")));
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_TRUE(result.value().timing.connectionReused);
+    TEST_ASSERT_EQUAL_INT(1, fast.connections());
+}
+
+void test_cancel_event_loop_exchange()
+{
+    LoopbackServer::Options serverOptions = slowServerOptions();
+    serverOptions.slowPieces = 3;
+    LoopbackServer a(serverOptions);
+    LoopbackServer b(serverOptions);
+    canaspad::HttpClient client(hostOptions());
+    canaspad::EventLoop loop(client);
+
+    auto token = canaspad::CancellationToken::create();
+    canaspad::Request requestA = newRequest(a.url("/a"));
+    requestA.setCancellationToken(token);
+    auto pendingA = loop.submit(requestA);
+    auto pendingB = loop.submit(newRequest(b.url("/b")));
+
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50))
+    {
+        loop.runOnce(std::chrono::milliseconds(10));
+    }
+    token.cancel();
+    loop.runOnce();
+    TEST_ASSERT_TRUE(pendingA.ready());
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(pendingA.get()));
+
+    // 同じループの他の送信はそのまま進む
+    loop.run();
+    TEST_ASSERT_TRUE(pendingB.get().isSuccess());
+}
+
+#if CANASPAD_HAS_COROUTINES
+
+namespace
+{
+    canaspad::Task<void> sendInto(canaspad::HttpClient *client, canaspad::Request request, std::optional<canaspad::Result<canaspad::HttpResult>> *out)
+    {
+        out->emplace(co_await client->sendCo(std::move(request)));
+    }
+
+    canaspad::Task<void> cancelLater(canaspad::CancellationToken token, std::chrono::milliseconds delay)
+    {
+        co_await canaspad::Scheduler::sleep(delay);
+        token.cancel();
+    }
+}
+
+void test_cancel_send_co()
+{
+    LoopbackServer slow(slowServerOptions());
+    canaspad::HttpClient client(hostOptions());
+
+    auto token = canaspad::CancellationToken::create();
+    canaspad::Request request = newRequest(slow.url("/slow"));
+    request.setCancellationToken(token);
+
+    std::optional<canaspad::Result<canaspad::HttpResult>> result;
+    canaspad::Scheduler scheduler;
+    scheduler.spawn(sendInto(&client, request, &result));
+    scheduler.spawn(cancelLater(token, std::chrono::milliseconds(100)));
+    auto start = std::chrono::steady_clock::now();
+    scheduler.run();
+
+    TEST_ASSERT_TRUE(result.has_value());
+    // 3 秒かかるレスポンスの途中で打ち切る
+    TEST_ASSERT_EQUAL_INT(kCancelled, errorCode(*result));
+    TEST_ASSERT_TRUE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+}
+
+#endif // CANASPAD_HAS_COROUTINES
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+void run_cancellation_tests(void)
+{
+    RUN_TEST(test_cancel_unknown_id);
+    RUN_TEST(test_cancelled_token_fails_before_sending);
+    RUN_TEST(test_cancel_during_retry_delay);
+    RUN_TEST(test_resend_after_cancel);
+    RUN_TEST(test_cancel_during_stalled_write);
+    RUN_TEST(test_cancel_queued_async_request);
+#if CANASPAD_PLATFORM_POSIX
+    RUN_TEST(test_cancel_keeps_other_pooled_connections);
+    RUN_TEST(test_cancel_event_loop_exchange);
+#if CANASPAD_HAS_COROUTINES
+    RUN_TEST(test_cancel_send_co);
+#endif
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef CANCELLATION_TEST_H
+#define CANCELLATION_TEST_H
+
+#include "helpers.h"
+
+void test_cancel_unknown_id();
+void test_cancelled_token_fails_before_sending();
+void test_cancel_during_retry_delay();
+void test_resend_after_cancel();
+void test_cancel_during_stalled_write();
+void test_cancel_queued_async_request();
+void test_cancel_keeps_other_pooled_connections();
+void test_cancel_event_loop_exchange();
+void test_cancel_send_co();
+void run_cancellation_tests(void);
+
+#endif // CANCELLATION_TEST_H
\ No newline at end of file
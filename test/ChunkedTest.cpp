@@ -0,0 +1,84 @@
+#include "ChunkedTest.h"
+#include <cstring>
+
+void test_chunked_response_is_decoded()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    const char *response =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "5\r\nHello\r\n"
+        "8\r\n, World!\r\n"
+        "0\r\n\r\n";
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/chunked").setMethod(canaspad::HttpMethod::GET);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    TEST_ASSERT_EQUAL_STRING("Hello, World!", result.value().body.c_str());
+}
+
+void test_chunked_response_with_crlf_in_data()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    // チャンクデータ内の CRLF はチャンク長に従って扱われる
+    const char *response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "c\r\nline1\r\nline2\r\n"
+        "0\r\n\r\n";
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/lines").setMethod(canaspad::HttpMethod::GET);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("line1\r\nline2", result.value().body.c_str());
+}
+
+void test_chunked_trailers_are_merged_into_headers()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    const char *response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Trailer: X-Checksum\r\n\r\n"
+        "4\r\ndata\r\n"
+        "0\r\n"
+        "X-Checksum: 1234\r\n\r\n";
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/trailer").setMethod(canaspad::HttpMethod::GET);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("data", result.value().body.c_str());
+    auto checksum = result.value().headers.find("X-Checksum");
+    TEST_ASSERT_TRUE(checksum != result.value().headers.end());
+    TEST_ASSERT_EQUAL_STRING("1234", checksum->value.data());
+}
+
+void run_chunked_tests(void)
+{
+    RUN_TEST(test_chunked_response_is_decoded);
+    RUN_TEST(test_chunked_response_with_crlf_in_data);
+    RUN_TEST(test_chunked_trailers_are_merged_into_headers);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef CHUNKED_TEST_H
+#define CHUNKED_TEST_H
+
+#include "helpers.h"
+
+void test_chunked_response_is_decoded();
+void test_chunked_response_with_crlf_in_data();
+void test_chunked_trailers_are_merged_into_headers();
+void run_chunked_tests(void);
+
+#endif // CHUNKED_TEST_H
\ No newline at end of file
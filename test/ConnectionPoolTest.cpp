@@ -0,0 +1,169 @@
+#include "ConnectionPoolTest.h"
+#include "../src/core/ConnectionPool.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // 呼び出しごとに新しいモック接続を作成するプール
+    canaspad::ConnectionPool makeMockPool(const canaspad::ClientOptions &options)
+    {
+        return canaspad::ConnectionPool(options, [options](const std::string &)
+                                        { return std::make_shared<canaspad::MockWiFiClientSecure>(options); });
+    }
+
+    std::shared_ptr<canaspad::Connection> checkout(canaspad::ConnectionPool &pool, const std::string &host)
+    {
+        auto connection = pool.getConnection("https", host, 443).value();
+        if (connection && !connection->isConnected())
+        {
+            connection->connect(host, 443);
+        }
+        return connection;
+    }
+}
+
+void test_pool_reuses_idle_connection_per_host()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    auto pool = makeMockPool(options);
+
+    auto first = checkout(pool, "api.example.com");
+    pool.releaseConnection(first);
+    auto second = checkout(pool, "api.example.com");
+
+    TEST_ASSERT_TRUE(first == second);
+    auto stats = pool.getStats();
+    TEST_ASSERT_EQUAL_INT(1, stats.hits);
+    TEST_ASSERT_EQUAL_INT(1, stats.misses);
+    TEST_ASSERT_EQUAL_INT(1, stats.active);
+}
+
+void test_pool_alternating_hosts_hit_idle_connections()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    auto pool = makeMockPool(options);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        pool.releaseConnection(checkout(pool, "a.example.com"));
+        pool.releaseConnection(checkout(pool, "b.example.com"));
+    }
+
+    // 最初の 2 回のみ新規接続となり、以降は各ホストのアイドル接続を再利用する
+    auto stats = pool.getStats();
+    TEST_ASSERT_EQUAL_INT(2, stats.misses);
+    TEST_ASSERT_EQUAL_INT(4, stats.hits);
+    TEST_ASSERT_EQUAL_INT(2, stats.idle);
+}
+
+void test_pool_enforces_global_limit()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxConnections = 2;
+    auto pool = makeMockPool(options);
+
+    auto a = checkout(pool, "a.example.com");
+    auto b = checkout(pool, "b.example.com");
+    // 上限に達し、アイドル接続もないため貸し出せない
+    TEST_ASSERT_NULL(pool.getConnection("https", "c.example.com", 443).value().get());
+
+    // アイドル接続があれば最も古いものを閉じて新しい接続を作成する
+    pool.releaseConnection(a);
+    auto c = checkout(pool, "c.example.com");
+    TEST_ASSERT_NOT_NULL(c.get());
+    TEST_ASSERT_FALSE(a->isConnected());
+    TEST_ASSERT_EQUAL_INT(1, pool.getStats().evictions);
+}
+
+void test_pool_discards_non_reusable_connection()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    auto pool = makeMockPool(options);
+
+    auto first = checkout(pool, "api.example.com");
+    pool.releaseConnection(first, false);
+    TEST_ASSERT_FALSE(first->isConnected());
+    TEST_ASSERT_EQUAL_INT(0, pool.getStats().idle);
+
+    auto second = checkout(pool, "api.example.com");
+    TEST_ASSERT_TRUE(first != second);
+    TEST_ASSERT_EQUAL_INT(2, pool.getStats().misses);
+}
+
+void test_pool_separates_schemes()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    std::vector<std::string> schemes;
+    canaspad::ConnectionPool pool(options, [options, &schemes](const std::string &scheme)
+                                  {
+                                      schemes.push_back(scheme);
+                                      return std::make_shared<canaspad::MockWiFiClientSecure>(options); });
+
+    auto secure = pool.getConnection("https", "api.example.com", 8443).value();
+    secure->connect("api.example.com", 8443);
+    pool.releaseConnection(secure);
+
+    // 同じ host:port でも https のアイドル接続を http に貸し出さない
+    auto plain = pool.getConnection("http", "api.example.com", 8443).value();
+    TEST_ASSERT_TRUE(plain != secure);
+    TEST_ASSERT_EQUAL_INT(2, schemes.size());
+    TEST_ASSERT_EQUAL_STRING("https", schemes[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("http", schemes[1].c_str());
+    TEST_ASSERT_EQUAL_INT(0, pool.getStats().hits);
+}
+
+void test_pool_rejects_unsupported_scheme()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::ConnectionPool pool(options, [options](const std::string &scheme)
+                                  { return scheme == "https" ? nullptr : std::make_shared<canaspad::MockWiFiClientSecure>(options); });
+
+    // TLS の接続を作れない場合は平文の接続で代用せずエラーにする
+    auto result = pool.getConnection("https", "api.example.com", 443);
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::UnsupportedProtocol), static_cast<int>(result.error().code));
+    TEST_ASSERT_EQUAL_INT(0, pool.getStats().active);
+    TEST_ASSERT_NOT_NULL(pool.getConnection("http", "api.example.com", 80).value().get());
+}
+
+void test_http_client_reuses_pooled_connection()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    const char *response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+
+    auto stats = client.getConnectionPoolStats();
+    TEST_ASSERT_EQUAL_INT(1, stats.misses);
+    TEST_ASSERT_EQUAL_INT(1, stats.hits);
+    TEST_ASSERT_EQUAL_INT(1, stats.idle);
+}
+
+void run_connection_pool_tests(void)
+{
+    RUN_TEST(test_pool_reuses_idle_connection_per_host);
+    RUN_TEST(test_pool_alternating_hosts_hit_idle_connections);
+    RUN_TEST(test_pool_enforces_global_limit);
+    RUN_TEST(test_pool_discards_non_reusable_connection);
+    RUN_TEST(test_pool_separates_schemes);
+    RUN_TEST(test_pool_rejects_unsupported_scheme);
+    RUN_TEST(test_http_client_reuses_pooled_connection);
+}
\ No newline at end of file
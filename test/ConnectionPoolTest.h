@@ -0,0 +1,15 @@
+#ifndef CONNECTION_POOL_TEST_H
+#define CONNECTION_POOL_TEST_H
+
+#include "helpers.h"
+
+void test_pool_reuses_idle_connection_per_host();
+void test_pool_alternating_hosts_hit_idle_connections();
+void test_pool_enforces_global_limit();
+void test_pool_discards_non_reusable_connection();
+void test_pool_separates_schemes();
+void test_pool_rejects_unsupported_scheme();
+void test_http_client_reuses_pooled_connection();
+void run_connection_pool_tests(void);
+
+#endif // CONNECTION_POOL_TEST_H
\ No newline at end of file
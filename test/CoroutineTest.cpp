@@ -0,0 +1,327 @@
+#include "CoroutineTest.h"
+
+#if CANASPAD_HAS_COROUTINES
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#if CANASPAD_PLATFORM_POSIX
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "LoopbackServer.h"
+#endif
+
+namespace
+{
+    using canaspad::Scheduler;
+    using canaspad::Task;
+
+    Task<int> addLater(int a, int b)
+    {
+        co_await Scheduler::sleep(std::chrono::milliseconds(5));
+        co_return a + b;
+    }
+
+    Task<void> sumInto(int *out)
+    {
+        int x = co_await addLater(1, 2);
+        *out = co_await addLater(x, 3);
+    }
+
+    Task<void> tick(std::vector<int> *log, int id, std::chrono::milliseconds interval, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            co_await Scheduler::sleep(interval);
+            log->push_back(id);
+        }
+    }
+
+    Task<void> sendInto(canaspad::HttpClient *client, canaspad::Request request, std::optional<canaspad::Result<canaspad::HttpResult>> *out)
+    {
+        out->emplace(co_await client->sendCo(std::move(request)));
+    }
+
+    // センサーの読み取りを模して、done になるまで一定間隔で数える
+    Task<void> sample(const std::optional<canaspad::Result<canaspad::HttpResult>> *done, int *samples)
+    {
+        while (!done->has_value())
+        {
+            ++*samples;
+            co_await Scheduler::sleep(std::chrono::milliseconds(5));
+        }
+    }
+
+    Task<void> collectBody(canaspad::HttpClient *client, canaspad::Request request, int *status, std::string *body, int *chunks)
+    {
+        auto opened = co_await client->openCo(std::move(request));
+        if (opened.isError())
+        {
+            co_return;
+        }
+        auto stream = std::move(opened).value();
+        *status = stream.statusCode();
+        while (true)
+        {
+            auto chunk = co_await stream.next();
+            if (chunk.isError() || chunk.value().empty())
+            {
+                break;
+            }
+            body->append(chunk.value().data(), chunk.value().size());
+            ++*chunks;
+        }
+    }
+
+    std::unique_ptr<canaspad::HttpClient> newClient(canaspad::MockWiFiClientSecure **mockClient)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        client->setReadTimeout(std::chrono::milliseconds(1000));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        return client;
+    }
+
+    canaspad::Request newRequest(const char *url)
+    {
+        canaspad::Request request;
+        request.setUrl(url).setMethod(canaspad::HttpMethod::GET);
+        return request;
+    }
+}
+
+void test_task_returns_nested_value()
+{
+    Scheduler scheduler;
+    int result = 0;
+    scheduler.spawn(sumInto(&result));
+    TEST_ASSERT_EQUAL_INT(1, scheduler.tasks());
+    scheduler.run();
+    TEST_ASSERT_EQUAL_INT(6, result);
+    TEST_ASSERT_EQUAL_INT(0, scheduler.tasks());
+}
+
+void test_scheduler_interleaves_sleeps()
+{
+    Scheduler scheduler;
+    std::vector<int> log;
+    scheduler.spawn(tick(&log, 1, std::chrono::milliseconds(20), 3));
+    scheduler.spawn(tick(&log, 2, std::chrono::milliseconds(50), 1));
+
+    scheduler.run();
+
+    // 2 つ目のタスクは 1 つ目の 2 回目と 3 回目の間に進む
+    TEST_ASSERT_EQUAL_INT(4, log.size());
+    TEST_ASSERT_EQUAL_INT(1, log[0]);
+    TEST_ASSERT_EQUAL_INT(1, log[1]);
+    TEST_ASSERT_EQUAL_INT(2, log[2]);
+    TEST_ASSERT_EQUAL_INT(1, log[3]);
+}
+
+void test_send_co_returns_response()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    mockClient->injectResponse(std::string(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n\r\n"
+        "hello"));
+
+    Scheduler scheduler;
+    std::optional<canaspad::Result<canaspad::HttpResult>> result;
+    scheduler.spawn(sendInto(client.get(), newRequest("https://example.com/co"), &result));
+    scheduler.run();
+
+    TEST_ASSERT_TRUE(result.has_value());
+    TEST_ASSERT_TRUE(result->isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result->value().statusCode);
+    TEST_ASSERT_EQUAL_STRING("hello", result->value().body.c_str());
+    TEST_ASSERT_EQUAL_INT(1, client->getMetrics().requests);
+}
+
+void test_send_co_yields_while_waiting()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    // 20ms ごとに 16 バイトずつ届く (全体で約 6 区切り)
+    mockClient->setReadBehavior(canaspad::ReadBehavior::SlowResponse, std::chrono::milliseconds(20));
+    mockClient->injectResponse(std::string(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 26\r\n\r\n"
+        "abcdefghijklmnopqrstuvwxyz"));
+
+    Scheduler scheduler;
+    std::optional<canaspad::Result<canaspad::HttpResult>> result;
+    int samples = 0;
+    scheduler.spawn(sendInto(client.get(), newRequest("https://example.com/slow"), &result));
+    scheduler.spawn(sample(&result, &samples));
+    scheduler.run();
+
+    TEST_ASSERT_TRUE(result->isSuccess());
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmnopqrstuvwxyz", result->value().body.c_str());
+    // 受信を待つ間も同じタスクで読み取りが進む
+    TEST_ASSERT_TRUE(samples >= 10);
+}
+
+void test_open_co_streams_body()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    mockClient->injectResponse(std::string(
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "3\r\nabc\r\n"
+        "4\r\ndefg\r\n"
+        "0\r\n\r\n"));
+
+    Scheduler scheduler;
+    int status = 0;
+    int chunks = 0;
+    std::string body;
+    scheduler.spawn(collectBody(client.get(), newRequest("https://example.com/stream"), &status, &body, &chunks));
+    scheduler.run();
+
+    TEST_ASSERT_EQUAL_INT(200, status);
+    TEST_ASSERT_EQUAL_STRING("abcdefg", body.c_str());
+    TEST_ASSERT_TRUE(chunks >= 1);
+}
+
+#if CANASPAD_PLATFORM_POSIX
+
+namespace
+{
+    Task<void> writeWhenReady(int socket, const bool *drained, bool *resumedAfterDrain)
+    {
+        co_await Scheduler::writable(socket, Scheduler::Clock::now() + std::chrono::seconds(5));
+        *resumedAfterDrain = *drained;
+    }
+
+    Task<void> drainLater(int socket, bool *drained)
+    {
+        co_await Scheduler::sleep(std::chrono::milliseconds(20));
+        char buffer[4096];
+        while (read(socket, buffer, sizeof(buffer)) > 0)
+        {
+        }
+        *drained = true;
+    }
+}
+
+void test_scheduler_waits_for_writable_handle()
+{
+    int sockets[2];
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+    fcntl(sockets[0], F_SETFL, O_NONBLOCK);
+    fcntl(sockets[1], F_SETFL, O_NONBLOCK);
+    // 送信バッファを埋めて書き込めない状態にする
+    char fill[4096] = {};
+    while (write(sockets[0], fill, sizeof(fill)) > 0)
+    {
+    }
+
+    Scheduler scheduler;
+    bool drained = false;
+    bool resumedAfterDrain = false;
+    scheduler.spawn(writeWhenReady(sockets[0], &drained, &resumedAfterDrain));
+    scheduler.spawn(drainLater(sockets[1], &drained));
+    auto start = std::chrono::steady_clock::now();
+    scheduler.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    close(sockets[0]);
+    close(sockets[1]);
+
+    // 相手が読み出して送信バッファが空いた時点で再開する (期限の 5 秒を待たない)
+    TEST_ASSERT_TRUE(resumedAfterDrain);
+    TEST_ASSERT_TRUE(elapsed < std::chrono::seconds(2));
+}
+
+void test_send_co_overlaps_hosts()
+{
+    LoopbackServer::Options serverOptions;
+    serverOptions.behavior = LoopbackServer::Behavior::Slow;
+    serverOptions.bodySize = 64;
+    serverOptions.slowPieces = 3;
+    serverOptions.slowDelay = std::chrono::milliseconds(100);
+    LoopbackServer a(serverOptions);
+    LoopbackServer b(serverOptions);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options);
+
+    Scheduler scheduler;
+    std::optional<canaspad::Result<canaspad::HttpResult>> resultA, resultB;
+    scheduler.spawn(sendInto(&client, newRequest(a.url("/a").c_str()), &resultA));
+    scheduler.spawn(sendInto(&client, newRequest(b.url("/b").c_str()), &resultB));
+    scheduler.run();
+
+    TEST_ASSERT_TRUE(resultA->isSuccess());
+    TEST_ASSERT_TRUE(resultB->isSuccess());
+    TEST_ASSERT_EQUAL_STRING(LoopbackServer::patternBody(64).c_str(), resultA->value().body.c_str());
+    // 1 つのタスクで、それぞれ 200ms かかるレスポンスを並行して受け取る (一方を送り終える前に他方の受信が終わらない)
+    const auto &timingA = resultA->value().timing;
+    const auto &timingB = resultB->value().timing;
+    TEST_ASSERT_TRUE(timingA.requestSent < timingB.responseEnd);
+    TEST_ASSERT_TRUE(timingB.requestSent < timingA.responseEnd);
+}
+
+#ifdef CANASPAD_USE_OPENSSL
+
+void test_send_co_overlaps_tls_handshakes()
+{
+    LoopbackServer::Options serverOptions;
+    serverOptions.bodySize = 64;
+    serverOptions.tls = true;
+    LoopbackServer server(serverOptions);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = true;
+    options.maxRetries = 0;
+    options.rootCA = server.certificatePem();
+    canaspad::HttpClient client(options);
+
+    Scheduler scheduler;
+    std::optional<canaspad::Result<canaspad::HttpResult>> resultA, resultB;
+    scheduler.spawn(sendInto(&client, newRequest(server.url("/a").c_str()), &resultA));
+    scheduler.spawn(sendInto(&client, newRequest(server.url("/b").c_str()), &resultB));
+    scheduler.run();
+
+    TEST_ASSERT_TRUE(resultA->isSuccess());
+    TEST_ASSERT_TRUE(resultB->isSuccess());
+    TEST_ASSERT_EQUAL_INT(2, server.connections());
+    // ハンドシェイクの応答を待つ間に他方の接続を始める
+    const auto &connectA = resultA->value().timing.connect;
+    const auto &connectB = resultB->value().timing.connect;
+    TEST_ASSERT_TRUE(connectB.connectStart < connectA.tlsEnd);
+    TEST_ASSERT_TRUE(connectA.connectStart < connectB.tlsEnd);
+}
+
+#endif // CANASPAD_USE_OPENSSL
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+#endif // CANASPAD_HAS_COROUTINES
+
+void run_coroutine_tests(void)
+{
+#if CANASPAD_HAS_COROUTINES
+    RUN_TEST(test_task_returns_nested_value);
+    RUN_TEST(test_scheduler_interleaves_sleeps);
+    RUN_TEST(test_send_co_returns_response);
+    RUN_TEST(test_send_co_yields_while_waiting);
+    RUN_TEST(test_open_co_streams_body);
+#if CANASPAD_PLATFORM_POSIX
+    RUN_TEST(test_scheduler_waits_for_writable_handle);
+    RUN_TEST(test_send_co_overlaps_hosts);
+#ifdef CANASPAD_USE_OPENSSL
+    RUN_TEST(test_send_co_overlaps_tls_handshakes);
+#endif
+#endif
+#endif
+}
\ No newline at end of file
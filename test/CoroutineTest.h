@@ -0,0 +1,16 @@
+#ifndef COROUTINE_TEST_H
+#define COROUTINE_TEST_H
+
+#include "helpers.h"
+
+void test_task_returns_nested_value();
+void test_scheduler_interleaves_sleeps();
+void test_send_co_returns_response();
+void test_send_co_yields_while_waiting();
+void test_open_co_streams_body();
+void test_scheduler_waits_for_writable_handle();
+void test_send_co_overlaps_hosts();
+void test_send_co_overlaps_tls_handshakes();
+void run_coroutine_tests(void);
+
+#endif // COROUTINE_TEST_H
\ No newline at end of file
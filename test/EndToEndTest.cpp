@@ -0,0 +1,243 @@
+#include "EndToEndTest.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include "LoopbackServer.h"
+#include "../src/core/PosixConnection.h"
+#include "../src/core/OpenSslConnection.h"
+
+namespace
+{
+    canaspad::ClientOptions hostOptions()
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        return options;
+    }
+
+    LoopbackServer::Options serverOptions(LoopbackServer::Behavior behavior, size_t bodySize)
+    {
+        LoopbackServer::Options options;
+        options.behavior = behavior;
+        options.bodySize = bodySize;
+        return options;
+    }
+
+    canaspad::Result<canaspad::HttpResult> get(canaspad::HttpClient &client, const std::string &url)
+    {
+        canaspad::Request request;
+        request.setUrl(url);
+        return client.send(request);
+    }
+}
+
+void test_end_to_end_fixed_keep_alive()
+{
+    LoopbackServer server(serverOptions(LoopbackServer::Behavior::Fixed, 1024));
+    canaspad::HttpClient client(hostOptions());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        auto result = get(client, server.url("/fixed"));
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+        TEST_ASSERT_TRUE(result.value().body == LoopbackServer::patternBody(1024));
+    }
+    TEST_ASSERT_EQUAL_INT(1, server.connections());
+    TEST_ASSERT_EQUAL_INT(5, server.requests());
+}
+
+void test_end_to_end_chunked()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Chunked, 65536);
+    options.chunkSize = 1000; // 受信バッファの境界とずらす
+    LoopbackServer server(options);
+    canaspad::HttpClient client(hostOptions());
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto result = get(client, server.url("/chunked"));
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_EQUAL_INT(65536, result.value().body.size());
+        TEST_ASSERT_TRUE(result.value().body == LoopbackServer::patternBody(65536));
+    }
+    TEST_ASSERT_EQUAL_INT(1, server.connections());
+}
+
+void test_end_to_end_slow_response()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Slow, 4096);
+    options.slowPieces = 5;
+    options.slowDelay = std::chrono::milliseconds(20);
+    LoopbackServer server(options);
+    canaspad::HttpClient client(hostOptions());
+    // 読み込みの期限はレスポンス全体に対して適用される
+    client.setReadTimeout(std::chrono::milliseconds(1000));
+
+    auto result = get(client, server.url("/slow"));
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_TRUE(result.value().body == LoopbackServer::patternBody(4096));
+    TEST_ASSERT_TRUE(result.value().timing.transfer() >= std::chrono::milliseconds(60));
+
+    client.setReadTimeout(std::chrono::milliseconds(30));
+    result = get(client, server.url("/slow"));
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::Timeout), static_cast<int>(result.error().code));
+}
+
+void test_end_to_end_connection_close()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Fixed, 256);
+    options.keepAlive = false;
+    LoopbackServer server(options);
+    canaspad::HttpClient client(hostOptions());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto result = get(client, server.url("/close"));
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_FALSE(result.value().timing.connectionReused);
+    }
+    // Connection: close の接続はプールに戻さない
+    TEST_ASSERT_EQUAL_INT(3, server.connections());
+    TEST_ASSERT_EQUAL_INT(0, client.getConnectionPoolStats().hits);
+}
+
+void test_end_to_end_proxy_absolute_form()
+{
+    LoopbackServer origin([](const std::string &head, const std::string &)
+                          {
+                              std::string line = head.substr(0, head.find("\r\n"));
+                              return "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(line.size()) +
+                                     "\r\nConnection: keep-alive\r\n\r\n" + line; });
+    LoopbackServer proxy(serverOptions(LoopbackServer::Behavior::Proxy, 0));
+
+    auto options = hostOptions();
+    options.proxyUrl = "http://127.0.0.1:" + std::to_string(proxy.port());
+    canaspad::HttpClient client(options);
+
+    std::string url = origin.url("/via-proxy");
+    for (int i = 0; i < 2; ++i)
+    {
+        auto result = get(client, url);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_EQUAL_STRING(("GET " + url + " HTTP/1.1").c_str(), result.value().body.c_str());
+    }
+    // プロキシとの接続を再利用し、転送先への接続も 1 本のまま
+    TEST_ASSERT_EQUAL_INT(1, proxy.connections());
+    TEST_ASSERT_EQUAL_INT(1, origin.connections());
+    TEST_ASSERT_EQUAL_INT(2, origin.requests());
+}
+
+void test_end_to_end_proxy_connect_tunnel()
+{
+    LoopbackServer origin(serverOptions(LoopbackServer::Behavior::Fixed, 16));
+    LoopbackServer proxy(serverOptions(LoopbackServer::Behavior::Proxy, 0));
+
+    canaspad::PosixConnection connection;
+    TEST_ASSERT_TRUE(connection.connect("127.0.0.1", proxy.port()));
+    std::string authority = "127.0.0.1:" + std::to_string(origin.port());
+    std::string connect = "CONNECT " + authority + " HTTP/1.1\r\nHost: " + authority + "\r\n\r\n";
+    connection.write(reinterpret_cast<const uint8_t *>(connect.data()), connect.size());
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 Connection Established", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_STRING("", connection.readLine().c_str());
+
+    // トンネルの中では転送先のサーバーと直接話す
+    std::string request = "GET / HTTP/1.1\r\nHost: " + authority + "\r\n\r\n";
+    connection.write(reinterpret_cast<const uint8_t *>(request.data()), request.size());
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", connection.readLine().c_str());
+    TEST_ASSERT_EQUAL_INT(1, origin.requests());
+}
+
+#ifdef CANASPAD_USE_OPENSSL
+
+namespace
+{
+    canaspad::ClientOptions tlsOptions(const LoopbackServer &server)
+    {
+        canaspad::ClientOptions options = hostOptions();
+        options.verifySsl = true;
+        options.rootCA = server.certificatePem();
+        options.connectionFactory = [](const std::string &)
+        { return std::shared_ptr<canaspad::Connection>(std::make_shared<canaspad::OpenSslConnection>()); };
+        return options;
+    }
+}
+
+void test_end_to_end_tls_keep_alive()
+{
+    auto serverOptions = ::serverOptions(LoopbackServer::Behavior::Fixed, 8192);
+    serverOptions.tls = true;
+    LoopbackServer server(serverOptions);
+    canaspad::HttpClient client(tlsOptions(server));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto result = get(client, server.url("/secure"));
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_TRUE(result.value().body == LoopbackServer::patternBody(8192));
+    }
+    TEST_ASSERT_EQUAL_INT(1, server.connections());
+    TEST_ASSERT_EQUAL_INT(2, client.getConnectionPoolStats().hits);
+}
+
+void test_end_to_end_tls_rejects_untrusted_certificate()
+{
+    auto serverOptions = ::serverOptions(LoopbackServer::Behavior::Fixed, 16);
+    serverOptions.tls = true;
+    LoopbackServer server(serverOptions);
+    LoopbackServer other(serverOptions);
+
+    // 別のサーバーの証明書だけを信頼する
+    canaspad::HttpClient client(tlsOptions(other));
+    auto result = get(client, server.url("/secure"));
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::NetworkError), static_cast<int>(result.error().code));
+    TEST_ASSERT_EQUAL_INT(0, server.requests());
+}
+
+void test_end_to_end_tls_session_resumption()
+{
+    auto serverOptions = ::serverOptions(LoopbackServer::Behavior::Fixed, 64);
+    serverOptions.tls = true;
+    serverOptions.keepAlive = false;
+    LoopbackServer server(serverOptions);
+    canaspad::HttpClient client(tlsOptions(server));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto result = get(client, server.url("/resume"));
+        TEST_ASSERT_TRUE(result.isSuccess());
+    }
+    // 2 回目以降の接続は TlsSessionCache のセッションで再開する
+    TEST_ASSERT_EQUAL_INT(3, server.connections());
+    TEST_ASSERT_EQUAL_INT(2, server.resumedSessions());
+    auto stats = client.getTlsSessionStats();
+    TEST_ASSERT_EQUAL_INT(1, stats.fullHandshakes);
+    TEST_ASSERT_EQUAL_INT(2, stats.resumedHandshakes);
+}
+
+#endif // CANASPAD_USE_OPENSSL
+
+void run_end_to_end_tests(void)
+{
+    RUN_TEST(test_end_to_end_fixed_keep_alive);
+    RUN_TEST(test_end_to_end_chunked);
+    RUN_TEST(test_end_to_end_slow_response);
+    RUN_TEST(test_end_to_end_connection_close);
+    RUN_TEST(test_end_to_end_proxy_absolute_form);
+    RUN_TEST(test_end_to_end_proxy_connect_tunnel);
+#ifdef CANASPAD_USE_OPENSSL
+    RUN_TEST(test_end_to_end_tls_keep_alive);
+    RUN_TEST(test_end_to_end_tls_rejects_untrusted_certificate);
+    RUN_TEST(test_end_to_end_tls_session_resumption);
+#endif
+}
+
+#else
+
+// ループバックのサーバーはホストのビルドでのみ使う
+void run_end_to_end_tests(void) {}
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
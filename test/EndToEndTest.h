@@ -0,0 +1,17 @@
+#ifndef END_TO_END_TEST_H
+#define END_TO_END_TEST_H
+
+#include "helpers.h"
+
+void test_end_to_end_fixed_keep_alive();
+void test_end_to_end_chunked();
+void test_end_to_end_slow_response();
+void test_end_to_end_connection_close();
+void test_end_to_end_proxy_absolute_form();
+void test_end_to_end_proxy_connect_tunnel();
+void test_end_to_end_tls_keep_alive();
+void test_end_to_end_tls_rejects_untrusted_certificate();
+void test_end_to_end_tls_session_resumption();
+void run_end_to_end_tests(void);
+
+#endif // END_TO_END_TEST_H
\ No newline at end of file
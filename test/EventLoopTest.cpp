@@ -0,0 +1,285 @@
+#include "EventLoopTest.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if CANASPAD_PLATFORM_POSIX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "LoopbackServer.h"
+#include "../src/core/OpenSslConnection.h"
+#endif
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "hello";
+
+    std::unique_ptr<canaspad::HttpClient> newMockClient(canaspad::MockWiFiClientSecure **mockClient)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        client->setReadTimeout(std::chrono::milliseconds(100));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        return client;
+    }
+
+    canaspad::Request newRequest(const std::string &url)
+    {
+        canaspad::Request request;
+        request.setUrl(url);
+        return request;
+    }
+}
+
+void test_event_loop_completes_request()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(kResponse));
+
+    canaspad::EventLoop loop(*client);
+    int statusCode = 0;
+    auto pending = loop.submit(newRequest("https://example.com/status"), [&statusCode](const canaspad::Result<canaspad::HttpResult> &result)
+                               { statusCode = result.isSuccess() ? result.value().statusCode : -1; });
+    // 結果は runOnce の中で設定される
+    TEST_ASSERT_FALSE(pending.ready());
+    TEST_ASSERT_EQUAL_INT(1, static_cast<int>(loop.pending()));
+
+    loop.run();
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(loop.pending()));
+    TEST_ASSERT_TRUE(pending.ready());
+    TEST_ASSERT_EQUAL_INT(200, statusCode);
+    TEST_ASSERT_EQUAL_STRING("hello", pending.get().value().body.c_str());
+    TEST_ASSERT_EQUAL_INT(1, client->getMetrics().requests);
+}
+
+void test_event_loop_follows_redirect()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(
+        "HTTP/1.1 302 Found\r\n"
+        "Location: https://example2.com/redirected\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n"));
+    mockClient->injectResponse(std::string(kResponse));
+
+    canaspad::EventLoop loop(*client);
+    auto pending = loop.submit(newRequest("https://example1.com/init"));
+    loop.run();
+
+    const auto &result = pending.get();
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    TEST_ASSERT_EQUAL_INT(1, result.value().timing.redirects);
+}
+
+void test_event_loop_retries_after_connect_failure()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 2;
+    options.retryDelay = std::chrono::milliseconds(10);
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::FailNTimesThenSuccess, 1);
+    mockClient->injectResponse(std::string(kResponse));
+
+    canaspad::EventLoop loop(client);
+    auto pending = loop.submit(newRequest("https://example.com/retry"));
+    loop.run();
+
+    const auto &result = pending.get();
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(1, result.value().timing.retries);
+}
+
+void test_event_loop_cancels_on_destroy()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newMockClient(&mockClient);
+    mockClient->injectResponse(std::string(kResponse));
+
+    canaspad::AsyncResult pending;
+    {
+        canaspad::EventLoop loop(*client);
+        pending = loop.submit(newRequest("https://example.com/status"));
+    }
+    TEST_ASSERT_TRUE(pending.ready());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::RequestCancelled), static_cast<int>(pending.get().error().code));
+}
+
+#if CANASPAD_PLATFORM_POSIX
+
+namespace
+{
+    LoopbackServer::Options slowServerOptions()
+    {
+        LoopbackServer::Options options;
+        options.behavior = LoopbackServer::Behavior::Slow;
+        options.bodySize = 64;
+        options.slowPieces = 3;
+        options.slowDelay = std::chrono::milliseconds(100);
+        return options;
+    }
+}
+
+void test_event_loop_fans_out_hosts()
+{
+    constexpr int kServers = 8;
+    std::vector<std::unique_ptr<LoopbackServer>> servers;
+    for (int i = 0; i < kServers; ++i)
+    {
+        servers.emplace_back(new LoopbackServer(slowServerOptions()));
+    }
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    options.maxConnections = kServers;
+    canaspad::HttpClient client(options);
+    canaspad::EventLoop loop(client);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<canaspad::AsyncResult> pending;
+    for (const auto &server : servers)
+    {
+        pending.push_back(loop.submit(newRequest(server->url("/fan-out"))));
+    }
+    loop.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    canaspad::RequestTiming::TimePoint lastSent;
+    canaspad::RequestTiming::TimePoint firstEnd = canaspad::RequestTiming::TimePoint::max();
+    for (auto &result : pending)
+    {
+        TEST_ASSERT_TRUE(result.get().isSuccess());
+        TEST_ASSERT_TRUE(result.get().value().body == LoopbackServer::patternBody(64));
+        lastSent = std::max(lastSent, result.get().value().timing.requestSent);
+        firstEnd = std::min(firstEnd, result.get().value().timing.responseEnd);
+    }
+    // それぞれ 200ms かかるレスポンスを 1 つのタスクで並行して受け取る
+    // 全件を送り終えてから最初の 1 件を読み終えていれば、待ち時間は重なっている
+    TEST_ASSERT_TRUE(lastSent < firstEnd);
+    TEST_MESSAGE(("fan-out elapsed ms: " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count())).c_str());
+    TEST_ASSERT_EQUAL_INT(kServers, client.getMetrics().requests);
+}
+
+void test_event_loop_waits_for_pool_slot()
+{
+    LoopbackServer::Options serverOptions;
+    serverOptions.bodySize = 256;
+    LoopbackServer server(serverOptions);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    options.maxConnections = 2;
+    canaspad::HttpClient client(options);
+    canaspad::EventLoop loop(client);
+
+    // 上限を超えた送信は、接続がプールへ戻るのを待って再利用する
+    std::vector<canaspad::AsyncResult> pending;
+    for (int i = 0; i < 6; ++i)
+    {
+        pending.push_back(loop.submit(newRequest(server.url("/pool"))));
+    }
+    loop.run();
+
+    for (auto &result : pending)
+    {
+        TEST_ASSERT_TRUE(result.get().isSuccess());
+    }
+    TEST_ASSERT_TRUE(server.connections() <= 2);
+    TEST_ASSERT_EQUAL_INT(6, server.requests());
+}
+
+void test_event_loop_connection_refused()
+{
+    // 閉じたばかりのポートへ接続する
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length);
+    close(listener);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options);
+    canaspad::EventLoop loop(client);
+
+    auto start = std::chrono::steady_clock::now();
+    auto pending = loop.submit(newRequest("http://127.0.0.1:" + std::to_string(ntohs(address.sin_port)) + "/"));
+    loop.run();
+
+    TEST_ASSERT_TRUE(pending.get().isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::NetworkError), static_cast<int>(pending.get().error().code));
+    // 接続拒否はタイムアウトを待たずに返る (接続タイムアウトより十分短ければよい)
+    TEST_ASSERT_TRUE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+}
+
+#ifdef CANASPAD_USE_OPENSSL
+
+void test_event_loop_tls_handshake()
+{
+    LoopbackServer::Options serverOptions = slowServerOptions();
+    serverOptions.tls = true;
+    LoopbackServer server(serverOptions);
+
+    canaspad::ClientOptions options;
+    options.verifySsl = true;
+    options.maxRetries = 0;
+    options.rootCA = server.certificatePem();
+    options.connectionFactory = [](const std::string &)
+    { return std::shared_ptr<canaspad::Connection>(std::make_shared<canaspad::OpenSslConnection>()); };
+    canaspad::HttpClient client(options);
+    canaspad::EventLoop loop(client);
+
+    // 同時に送る 2 件は別々の接続でハンドシェイクを進める
+    auto pendingA = loop.submit(newRequest(server.url("/a")));
+    auto pendingB = loop.submit(newRequest(server.url("/b")));
+    loop.run();
+
+    TEST_ASSERT_TRUE(pendingA.get().isSuccess());
+    TEST_ASSERT_TRUE(pendingB.get().isSuccess());
+    TEST_ASSERT_TRUE(pendingA.get().value().timing.tlsHandshake() > std::chrono::microseconds(0));
+    const auto &timingA = pendingA.get().value().timing;
+    const auto &timingB = pendingB.get().value().timing;
+    TEST_ASSERT_TRUE(timingA.requestSent < timingB.responseEnd);
+    TEST_ASSERT_TRUE(timingB.requestSent < timingA.responseEnd);
+    TEST_ASSERT_EQUAL_INT(2, server.connections());
+}
+
+#endif // CANASPAD_USE_OPENSSL
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+void run_event_loop_tests(void)
+{
+    RUN_TEST(test_event_loop_completes_request);
+    RUN_TEST(test_event_loop_follows_redirect);
+    RUN_TEST(test_event_loop_retries_after_connect_failure);
+    RUN_TEST(test_event_loop_cancels_on_destroy);
+#if CANASPAD_PLATFORM_POSIX
+    RUN_TEST(test_event_loop_fans_out_hosts);
+    RUN_TEST(test_event_loop_waits_for_pool_slot);
+    RUN_TEST(test_event_loop_connection_refused);
+#ifdef CANASPAD_USE_OPENSSL
+    RUN_TEST(test_event_loop_tls_handshake);
+#endif
+#endif
+}
\ No newline at end of file
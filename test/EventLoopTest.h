@@ -0,0 +1,16 @@
+#ifndef EVENT_LOOP_TEST_H
+#define EVENT_LOOP_TEST_H
+
+#include "helpers.h"
+
+void test_event_loop_completes_request();
+void test_event_loop_follows_redirect();
+void test_event_loop_retries_after_connect_failure();
+void test_event_loop_cancels_on_destroy();
+void test_event_loop_fans_out_hosts();
+void test_event_loop_waits_for_pool_slot();
+void test_event_loop_connection_refused();
+void test_event_loop_tls_handshake();
+void run_event_loop_tests(void);
+
+#endif // EVENT_LOOP_TEST_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "HeaderMapTest.h"
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    // 一般的な API サーバーのレスポンスヘッダー
+    const std::pair<const char *, const char *> kTypicalHeaders[] = {
+        {"Date", "Fri, 16 Oct 2026 09:00:00 GMT"},
+        {"Content-Type", "application/json; charset=utf-8"},
+        {"Content-Length", "348"},
+        {"Connection", "keep-alive"},
+        {"Cache-Control", "no-cache, no-store, must-revalidate"},
+        {"Server", "nginx"},
+        {"X-Request-Id", "5f1c2a7e-9d3b-4c1a-8e2f-0b6d4a9c3e71"},
+        {"Strict-Transport-Security", "max-age=31536000; includeSubDomains"},
+        {"Set-Cookie", "session_id=12345; Path=/; HttpOnly"},
+        {"Set-Cookie", "theme=dark; Path=/"},
+        {"Vary", "Accept-Encoding"},
+        {"ETag", "\"33a64df551425fcc55e4d42a148795d9f25f89d4\""},
+    };
+}
+
+void test_header_lookup_ignores_case()
+{
+    canaspad::HeaderMap headers;
+    headers.add("content-length", "42");
+    headers.add("X-Custom", "value");
+
+    TEST_ASSERT_TRUE(headers.contains("Content-Length"));
+    TEST_ASSERT_TRUE(headers.contains(canaspad::HeaderNames::ContentLength));
+    TEST_ASSERT_TRUE(headers.get("x-custom") == "value");
+    TEST_ASSERT_TRUE(headers.find("X-CUSTOM") != headers.end());
+    TEST_ASSERT_TRUE(headers.find("X-Missing") == headers.end());
+    TEST_ASSERT_TRUE(headers.get("X-Missing").empty());
+    TEST_ASSERT_EQUAL_INT(42, canaspad::Utils::extractContentLength(headers));
+
+    // 名前は追加したときの表記のまま保持する
+    TEST_ASSERT_TRUE(headers.begin()->name == "content-length");
+}
+
+void test_header_repeated_fields_kept_in_order()
+{
+    canaspad::HeaderMap headers;
+    headers.add("Set-Cookie", "a=1");
+    headers.add("Content-Type", "text/plain");
+    headers.add("set-cookie", "b=2");
+
+    auto cookies = canaspad::Utils::extractHeaders(headers, canaspad::HeaderNames::SetCookie);
+    TEST_ASSERT_EQUAL_INT(2, cookies.size());
+    TEST_ASSERT_EQUAL_STRING("a=1", cookies[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("b=2", cookies[1].c_str());
+    TEST_ASSERT_EQUAL_INT(3, headers.size());
+
+    // 追加した順に列挙される
+    std::string order;
+    for (const auto &field : headers)
+    {
+        order.append(field.name).append(";");
+    }
+    TEST_ASSERT_EQUAL_STRING("Set-Cookie;Content-Type;set-cookie;", order.c_str());
+}
+
+void test_header_set_replaces_all_fields()
+{
+    canaspad::Request request;
+    request.addHeader("Content-Type", "text/plain");
+    request.addHeader("content-type", "application/json");
+
+    const auto &headers = request.getHeaders();
+    TEST_ASSERT_EQUAL_INT(1, headers.size());
+    TEST_ASSERT_TRUE(headers.get(canaspad::HeaderNames::ContentType) == "application/json");
+}
+
+void test_header_remove_compacts_buffer()
+{
+    canaspad::HeaderMap headers;
+    for (int i = 0; i < 50; ++i)
+    {
+        headers.set("X-Counter", std::to_string(i));
+    }
+    headers.add("X-Other", "kept");
+
+    TEST_ASSERT_EQUAL_INT(2, headers.size());
+    TEST_ASSERT_TRUE(headers.get("X-Counter") == "49");
+    TEST_ASSERT_TRUE(headers.get("X-Other") == "kept");
+    // 置き換えを繰り返しても使われなくなったバイトは溜まり続けない
+    TEST_ASSERT_TRUE(headers.memoryUsage() < 256);
+
+    TEST_ASSERT_EQUAL_INT(1, headers.remove("x-counter"));
+    TEST_ASSERT_EQUAL_INT(0, headers.remove("x-counter"));
+    TEST_ASSERT_EQUAL_INT(1, headers.size());
+    TEST_ASSERT_EQUAL_STRING("kept", headers.get("X-Other").data());
+}
+
+void test_response_headers_case_insensitive()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    client.enableCookies();
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    const char *response =
+        "HTTP/1.1 200 OK\r\n"
+        "content-length: 2\r\n"
+        "set-cookie: a=1; Path=/\r\n"
+        "Set-Cookie: b=2; Path=/\r\n"
+        "\r\n"
+        "OK";
+    mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/");
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    const auto &httpResult = result.value();
+    TEST_ASSERT_EQUAL_INT(2, canaspad::Utils::extractContentLength(httpResult.headers));
+    // 2 つ目の Set-Cookie が 1 つ目を上書きしない
+    TEST_ASSERT_EQUAL_INT(2, httpResult.headers.getAll(canaspad::HeaderNames::SetCookie).size());
+    TEST_ASSERT_EQUAL_INT(2, httpResult.cookies.size());
+}
+
+// 1 つのレスポンスのヘッダーを保持するのに使うヒープの量
+// 以前の unordered_map<string, string> はフィールドごとにハッシュノードと (SSO に収まらない) 文字列を確保していた
+void benchmark_header_map_memory_per_response()
+{
+    size_t mapCount;
+    size_t mapBytes;
+    {
+        canaspad::AllocationScope counter;
+        std::unordered_map<std::string, std::string> headers;
+        for (const auto &[name, value] : kTypicalHeaders)
+        {
+            headers[name] = value;
+        }
+        mapCount = counter.count();
+        mapBytes = counter.liveBytes();
+    }
+
+    size_t flatCount;
+    size_t flatBytes;
+    {
+        canaspad::AllocationScope counter;
+        canaspad::HeaderMap headers;
+        for (const auto &[name, value] : kTypicalHeaders)
+        {
+            headers.add(name, value);
+        }
+        flatCount = counter.count();
+        flatBytes = counter.liveBytes();
+        TEST_ASSERT_EQUAL_INT(12, headers.size());
+    }
+
+    TEST_ASSERT_TRUE(flatCount < mapCount);
+    TEST_ASSERT_TRUE(flatBytes < mapBytes);
+
+    char message[160];
+    snprintf(message, sizeof(message), "12 response headers: unordered_map %zu allocs / %zu bytes, HeaderMap %zu allocs / %zu bytes",
+             mapCount, mapBytes, flatCount, flatBytes);
+    TEST_MESSAGE(message);
+}
+
+void run_header_map_tests(void)
+{
+    RUN_TEST(test_header_lookup_ignores_case);
+    RUN_TEST(test_header_repeated_fields_kept_in_order);
+    RUN_TEST(test_header_set_replaces_all_fields);
+    RUN_TEST(test_header_remove_compacts_buffer);
+    RUN_TEST(test_response_headers_case_insensitive);
+    RUN_TEST(benchmark_header_map_memory_per_response);
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef HEADER_MAP_TEST_H
+#define HEADER_MAP_TEST_H
+
+#include "helpers.h"
+
+void test_header_lookup_ignores_case();
+void test_header_repeated_fields_kept_in_order();
+void test_header_set_replaces_all_fields();
+void test_header_remove_compacts_buffer();
+void test_response_headers_case_insensitive();
+void benchmark_header_map_memory_per_response();
+void run_header_map_tests(void);
+
+#endif // HEADER_MAP_TEST_H
\ No newline at end of file
@@ -146,7 +146,7 @@ void test_options_method(void)
 
     auto allowIt = result.value().headers.find("Allow");
     TEST_ASSERT_TRUE(allowIt != result.value().headers.end());
-    TEST_ASSERT_EQUAL_STRING("GET, POST, HEAD, OPTIONS", allowIt->second.c_str());
+    TEST_ASSERT_EQUAL_STRING("GET, POST, HEAD, OPTIONS", allowIt->value.data());
 }
 
 void run_http_method_tests(void)
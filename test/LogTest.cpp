@@ -0,0 +1,145 @@
+#include "LogTest.h"
+#include "../src/utils/Log.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string> capturedMessages;
+
+    void captureSink(canaspad::Log::Level level, const char *message)
+    {
+        capturedMessages.push_back(message);
+    }
+
+    // テスト中だけ出力先とレベルを差し替える
+    class ScopedSink
+    {
+    public:
+        ScopedSink(canaspad::Log::Sink sink, canaspad::Log::Level level)
+            : m_previousSink(canaspad::Log::setSink(sink)), m_previousLevel(canaspad::Log::getLevel())
+        {
+            canaspad::Log::setLevel(level);
+            capturedMessages.clear();
+        }
+        ~ScopedSink()
+        {
+            canaspad::Log::setSink(m_previousSink);
+            canaspad::Log::setLevel(m_previousLevel);
+        }
+
+    private:
+        canaspad::Log::Sink m_previousSink;
+        canaspad::Log::Level m_previousLevel;
+    };
+
+    // モック経由で Keep-Alive のリクエストを繰り返し、1 秒あたりのリクエスト数を返す
+    double measureRequestsPerSecond(int requestCount)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        canaspad::HttpClient client(options, true);
+        auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+        mockClient->setRecordReceivedData(false);
+
+        const std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 16\r\n\r\n{\"status\":\"ok\"} ";
+        for (int i = 0; i < requestCount; ++i)
+        {
+            mockClient->injectResponse(response);
+        }
+
+        canaspad::Request request;
+        request.setUrl("https://example.com/api").setMethod(canaspad::HttpMethod::GET);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < requestCount; ++i)
+        {
+            TEST_ASSERT_TRUE(client.send(request).isSuccess());
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return requestCount / elapsed;
+    }
+}
+
+void test_log_sink_receives_formatted_message()
+{
+    ScopedSink scoped(captureSink, canaspad::Log::Level::Verbose);
+
+    canaspad::Log::write(canaspad::Log::Level::Warn, "status %d from %s", 503, "example.com");
+    TEST_ASSERT_EQUAL_INT(1, capturedMessages.size());
+    TEST_ASSERT_EQUAL_STRING("status 503 from example.com", capturedMessages[0].c_str());
+}
+
+void test_log_runtime_level_filters_messages()
+{
+    ScopedSink scoped(captureSink, canaspad::Log::Level::Warn);
+
+    canaspad::Log::write(canaspad::Log::Level::Error, "error");
+    canaspad::Log::write(canaspad::Log::Level::Info, "info");
+    canaspad::Log::write(canaspad::Log::Level::Debug, "debug");
+    TEST_ASSERT_EQUAL_INT(1, capturedMessages.size());
+    TEST_ASSERT_FALSE(canaspad::Log::isEnabled(canaspad::Log::Level::Info));
+
+    // 出力先がない場合はどのレベルも無効
+    canaspad::Log::setSink(nullptr);
+    TEST_ASSERT_FALSE(canaspad::Log::isEnabled(canaspad::Log::Level::Error));
+}
+
+void test_log_truncates_long_messages()
+{
+    ScopedSink scoped(captureSink, canaspad::Log::Level::Verbose);
+
+    std::string longText(1024, 'x');
+    canaspad::Log::write(canaspad::Log::Level::Error, "%s", longText.c_str());
+    TEST_ASSERT_EQUAL_INT(1, capturedMessages.size());
+    TEST_ASSERT_TRUE(capturedMessages[0].size() < longText.size());
+}
+
+void test_log_compiled_out_statements_are_not_evaluated()
+{
+    ScopedSink scoped(captureSink, canaspad::Log::Level::Verbose);
+
+    int evaluated = 0;
+    CANASPAD_LOGV("value %d", ++evaluated);
+#if CANASPAD_LOG_LEVEL < CANASPAD_LOG_LEVEL_VERBOSE
+    // 呼び出しごと削除され、引数も評価されない
+    TEST_ASSERT_EQUAL_INT(0, evaluated);
+    TEST_ASSERT_EQUAL_INT(0, capturedMessages.size());
+#else
+    TEST_ASSERT_EQUAL_INT(1, evaluated);
+    TEST_ASSERT_EQUAL_INT(1, capturedMessages.size());
+#endif
+}
+
+// コンパイル時に残したログを実行時に無効化した場合と、既定の出力先 (Serial) に出力した場合の比較
+// ログを完全に削除した場合との比較は CANASPAD_LOG_LEVEL を変えてビルドし直して行う
+void benchmark_requests_per_second_with_logging()
+{
+    const int requestCount = 200;
+    double silentRps;
+    double enabledRps;
+    {
+        ScopedSink scoped(nullptr, canaspad::Log::Level::None);
+        measureRequestsPerSecond(requestCount / 10); // ウォームアップ
+        silentRps = measureRequestsPerSecond(requestCount);
+    }
+    {
+        ScopedSink scoped(canaspad::Log::serialSink, canaspad::Log::Level::Verbose);
+        enabledRps = measureRequestsPerSecond(requestCount);
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message), "CANASPAD_LOG_LEVEL=%d runtime-off=%.0f req/s runtime-verbose=%.0f req/s",
+             CANASPAD_LOG_LEVEL, silentRps, enabledRps);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(silentRps > 0);
+}
+
+void run_log_tests(void)
+{
+    RUN_TEST(test_log_sink_receives_formatted_message);
+    RUN_TEST(test_log_runtime_level_filters_messages);
+    RUN_TEST(test_log_truncates_long_messages);
+    RUN_TEST(test_log_compiled_out_statements_are_not_evaluated);
+    RUN_TEST(benchmark_requests_per_second_with_logging);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef LOG_TEST_H
+#define LOG_TEST_H
+
+#include "helpers.h"
+
+void test_log_sink_receives_formatted_message();
+void test_log_runtime_level_filters_messages();
+void test_log_truncates_long_messages();
+void test_log_compiled_out_statements_are_not_evaluated();
+void benchmark_requests_per_second_with_logging();
+void run_log_tests(void);
+
+#endif // LOG_TEST_H
\ No newline at end of file
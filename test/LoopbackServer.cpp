@@ -0,0 +1,448 @@
+#include "LoopbackServer.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdio>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef CANASPAD_USE_OPENSSL
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#endif
+
+// 接続ごとの送受信 (TLS の場合は SSL を通す)
+struct LoopbackServer::Stream
+{
+    int fd = -1;
+#ifdef CANASPAD_USE_OPENSSL
+    SSL *ssl = nullptr;
+#endif
+
+    ssize_t receive(char *buffer, size_t size)
+    {
+#ifdef CANASPAD_USE_OPENSSL
+        if (ssl)
+        {
+            return SSL_read(ssl, buffer, static_cast<int>(size));
+        }
+#endif
+        return ::recv(fd, buffer, size, 0);
+    }
+
+    bool sendAll(const char *data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t n;
+#ifdef CANASPAD_USE_OPENSSL
+            if (ssl)
+            {
+                n = SSL_write(ssl, data, static_cast<int>(size));
+            }
+            else
+#endif
+            {
+                n = ::send(fd, data, size, MSG_NOSIGNAL);
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+};
+
+namespace
+{
+    const char *kHeadTerminator = "\r\n\r\n";
+
+    int connectTo(const std::string &host, const std::string &port)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *result = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr)
+        {
+            return -1;
+        }
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(result);
+        return fd;
+    }
+
+    // 片方が閉じるまで双方向にバイト列を中継する
+    void pipeBytes(int a, int b)
+    {
+        char buffer[16384];
+        while (true)
+        {
+            pollfd fds[2] = {{a, POLLIN, 0}, {b, POLLIN, 0}};
+            if (::poll(fds, 2, -1) <= 0)
+            {
+                return;
+            }
+            for (int i = 0; i < 2; ++i)
+            {
+                if (fds[i].revents == 0)
+                {
+                    continue;
+                }
+                int from = i == 0 ? a : b;
+                int to = i == 0 ? b : a;
+                ssize_t n = ::recv(from, buffer, sizeof(buffer), 0);
+                if (n <= 0 || ::send(to, buffer, n, MSG_NOSIGNAL) != n)
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    std::string requestTarget(const std::string &head)
+    {
+        size_t start = head.find(' ');
+        size_t end = head.find(' ', start + 1);
+        if (start == std::string::npos || end == std::string::npos)
+        {
+            return "";
+        }
+        return head.substr(start + 1, end - start - 1);
+    }
+} // namespace
+
+LoopbackServer::LoopbackServer(Handler handler)
+{
+    m_options.behavior = Behavior::Custom;
+    m_options.handler = std::move(handler);
+    start();
+}
+
+LoopbackServer::LoopbackServer(const Options &options) : m_options(options)
+{
+    start();
+}
+
+LoopbackServer::~LoopbackServer()
+{
+    ::shutdown(m_listener, SHUT_RDWR);
+    ::close(m_listener);
+    m_acceptThread.join();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int fd : m_clients)
+        {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+#ifdef CANASPAD_USE_OPENSSL
+    SSL_CTX_free(m_tlsContext);
+#endif
+}
+
+std::string LoopbackServer::url(const char *path) const
+{
+    return std::string(m_tlsContext ? "https" : "http") + "://127.0.0.1:" + std::to_string(m_port) + path;
+}
+
+std::string LoopbackServer::patternBody(size_t size)
+{
+    std::string body(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+    {
+        body[i] = static_cast<char>('a' + i % 26);
+    }
+    return body;
+}
+
+void LoopbackServer::start()
+{
+    std::string connection = m_options.keepAlive ? "keep-alive" : "close";
+    std::string body = patternBody(m_options.bodySize);
+    if (m_options.behavior == Behavior::Chunked)
+    {
+        m_response = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nTransfer-Encoding: chunked\r\nConnection: " +
+                     connection + "\r\n\r\n";
+        size_t chunkSize = m_options.chunkSize > 0 ? m_options.chunkSize : body.size();
+        for (size_t offset = 0; offset < body.size(); offset += chunkSize)
+        {
+            size_t size = std::min(chunkSize, body.size() - offset);
+            char sizeLine[24];
+            snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", size);
+            m_response.append(sizeLine).append(body, offset, size).append("\r\n");
+        }
+        m_response += "0\r\n\r\n";
+    }
+    else
+    {
+        m_response = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " +
+                     std::to_string(body.size()) + "\r\nConnection: " + connection + "\r\n\r\n" + body;
+    }
+
+    if (m_options.tls && m_options.behavior != Behavior::Proxy)
+    {
+        setUpTls();
+    }
+
+    m_listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(m_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    ::listen(m_listener, 64);
+    socklen_t length = sizeof(address);
+    getsockname(m_listener, reinterpret_cast<sockaddr *>(&address), &length);
+    m_port = ntohs(address.sin_port);
+    m_acceptThread = std::thread([this]()
+                                 { acceptLoop(); });
+}
+
+void LoopbackServer::acceptLoop()
+{
+    while (true)
+    {
+        int client = ::accept(m_listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            return;
+        }
+        int noDelay = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        m_connections++;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clients.push_back(client);
+        m_threads.emplace_back([this, client]()
+                               { serve(client); });
+    }
+}
+
+void LoopbackServer::serve(int client)
+{
+    Stream stream;
+    stream.fd = client;
+    bool ready = true;
+#ifdef CANASPAD_USE_OPENSSL
+    if (m_tlsContext)
+    {
+        stream.ssl = SSL_new(m_tlsContext);
+        SSL_set_fd(stream.ssl, client);
+        ready = SSL_accept(stream.ssl) == 1;
+        if (ready && SSL_session_reused(stream.ssl))
+        {
+            m_resumedSessions++;
+        }
+    }
+#endif
+
+    std::string pending;
+    char buffer[16384];
+    while (ready)
+    {
+        size_t headEnd = pending.find(kHeadTerminator);
+        if (headEnd != std::string::npos)
+        {
+            std::string head = pending.substr(0, headEnd + 4);
+            if (m_options.behavior == Behavior::Proxy)
+            {
+                m_requests++;
+                proxy(stream, head, pending);
+                break;
+            }
+
+            size_t bodyLength = 0;
+            size_t field = head.find("Content-Length: ");
+            if (field != std::string::npos)
+            {
+                bodyLength = std::stoul(head.substr(field + 16));
+            }
+            if (pending.size() >= head.size() + bodyLength)
+            {
+                std::string body = pending.substr(head.size(), bodyLength);
+                pending.erase(0, head.size() + bodyLength);
+                m_requests++;
+                if (!respond(stream, head, body))
+                {
+                    break;
+                }
+                continue;
+            }
+        }
+        ssize_t n = stream.receive(buffer, sizeof(buffer));
+        if (n <= 0)
+        {
+            break;
+        }
+        pending.append(buffer, n);
+    }
+
+#ifdef CANASPAD_USE_OPENSSL
+    if (stream.ssl)
+    {
+        SSL_shutdown(stream.ssl);
+        SSL_free(stream.ssl);
+    }
+#endif
+    {
+        // 閉じた番号が再利用される前に一覧から外す
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+        {
+            if (*it == client)
+            {
+                m_clients.erase(it);
+                break;
+            }
+        }
+    }
+    ::close(client);
+}
+
+bool LoopbackServer::respond(Stream &stream, const std::string &head, const std::string &body)
+{
+    switch (m_options.behavior)
+    {
+    case Behavior::Custom:
+    {
+        std::string response = m_options.handler(head, body);
+        return response.empty() || stream.sendAll(response.data(), response.size());
+    }
+    case Behavior::Slow:
+    {
+        size_t pieces = std::max<size_t>(1, m_options.slowPieces);
+        size_t pieceSize = (m_response.size() + pieces - 1) / pieces;
+        for (size_t offset = 0; offset < m_response.size(); offset += pieceSize)
+        {
+            if (offset > 0)
+            {
+                std::this_thread::sleep_for(m_options.slowDelay);
+            }
+            if (!stream.sendAll(m_response.data() + offset, std::min(pieceSize, m_response.size() - offset)))
+            {
+                return false;
+            }
+        }
+        return m_options.keepAlive;
+    }
+    default:
+        return stream.sendAll(m_response.data(), m_response.size()) && m_options.keepAlive;
+    }
+}
+
+void LoopbackServer::proxy(Stream &stream, const std::string &head, const std::string &pending)
+{
+    std::string target = requestTarget(head);
+    bool tunnel = head.compare(0, 8, "CONNECT ") == 0;
+    if (!tunnel)
+    {
+        // 絶対形式 (http://host:port/path) から転送先を取り出す
+        size_t scheme = target.find("://");
+        size_t authorityStart = scheme == std::string::npos ? 0 : scheme + 3;
+        target = target.substr(authorityStart, target.find('/', authorityStart) - authorityStart);
+    }
+    size_t colon = target.rfind(':');
+    std::string host = target.substr(0, colon);
+    std::string port = colon == std::string::npos ? "80" : target.substr(colon + 1);
+
+    int upstream = connectTo(host, port);
+    if (upstream < 0)
+    {
+        const std::string response = "HTTP/1.1 502 Bad Gateway\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        stream.sendAll(response.data(), response.size());
+        return;
+    }
+
+    if (tunnel)
+    {
+        const std::string response = "HTTP/1.1 200 Connection Established\r\n\r\n";
+        stream.sendAll(response.data(), response.size());
+        std::string rest = pending.substr(head.size());
+        ::send(upstream, rest.data(), rest.size(), MSG_NOSIGNAL);
+    }
+    else
+    {
+        // サーバーは絶対形式のリクエストも受け付けるため、書き換えずにそのまま転送する
+        // 以降の同じ接続のリクエストも同じ転送先に送る
+        ::send(upstream, pending.data(), pending.size(), MSG_NOSIGNAL);
+    }
+    pipeBytes(stream.fd, upstream);
+    ::close(upstream);
+}
+
+void LoopbackServer::setUpTls()
+{
+#ifdef CANASPAD_USE_OPENSSL
+    // 起動ごとに P-256 の鍵と 127.0.0.1 / localhost 向けの自己署名証明書を作る
+    EVP_PKEY *key = nullptr;
+    EVP_PKEY_CTX *keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_keygen_init(keyContext);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1);
+    EVP_PKEY_keygen(keyContext, &key);
+    EVP_PKEY_CTX_free(keyContext);
+
+    X509 *certificate = X509_new();
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), -60);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 60 * 60);
+    X509_set_pubkey(certificate, key);
+    X509_NAME *name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+
+    X509V3_CTX extensionContext;
+    X509V3_set_ctx_nodb(&extensionContext);
+    X509V3_set_ctx(&extensionContext, certificate, certificate, nullptr, nullptr, 0);
+    const std::pair<int, const char *> extensions[] = {
+        {NID_basic_constraints, "critical,CA:TRUE"},
+        {NID_subject_alt_name, "IP:127.0.0.1,DNS:localhost"}};
+    for (const auto &entry : extensions)
+    {
+        X509_EXTENSION *extension = X509V3_EXT_conf_nid(nullptr, &extensionContext, entry.first, entry.second);
+        X509_add_ext(certificate, extension, -1);
+        X509_EXTENSION_free(extension);
+    }
+    X509_sign(certificate, key, EVP_sha256());
+
+    BIO *bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_X509(bio, certificate);
+    char *data = nullptr;
+    long length = BIO_get_mem_data(bio, &data);
+    m_certificatePem.assign(data, length);
+    BIO_free(bio);
+
+    m_tlsContext = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(m_tlsContext, certificate);
+    SSL_CTX_use_PrivateKey(m_tlsContext, key);
+    // セッション ID による再開を受け付ける
+    static const unsigned char kSessionContext[] = "loopback";
+    SSL_CTX_set_session_id_context(m_tlsContext, kSessionContext, sizeof(kSessionContext) - 1);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+#endif
+}
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef LOOPBACK_SERVER_H
+#define LOOPBACK_SERVER_H
+
+#include "../src/utils/Platform.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef struct ssl_ctx_st SSL_CTX;
+
+// 127.0.0.1 の空いているポートで待ち受ける HTTP/1.1 サーバー (ホストのテストとベンチマーク用)
+// 接続ごとにスレッドを立て、リクエストを読み終えるたびに設定された振る舞いで応答する
+class LoopbackServer
+{
+public:
+    using Handler = std::function<std::string(const std::string &head, const std::string &body)>;
+
+    enum class Behavior
+    {
+        Fixed,   // Content-Length 付きのボディを一度に送る
+        Chunked, // chunkSize ごとのチャンクで送る
+        Slow,    // slowPieces 個の断片に分け、slowDelay ずつ間を空けて送る
+        Proxy,   // CONNECT のトンネル、または絶対形式のリクエストを転送するプロキシ
+        Custom   // handler の戻り値をそのまま送る
+    };
+
+    struct Options
+    {
+        Behavior behavior = Behavior::Fixed;
+        size_t bodySize = 1024;
+        size_t chunkSize = 4096;
+        size_t slowPieces = 4;
+        std::chrono::milliseconds slowDelay{2};
+        bool keepAlive = true; // false の場合は応答ごとに Connection: close を付けて切断する
+        bool tls = false;      // 自己署名証明書で TLS を行う (CANASPAD_USE_OPENSSL が必要)
+        Handler handler;
+    };
+
+    explicit LoopbackServer(Handler handler);
+    explicit LoopbackServer(const Options &options);
+    ~LoopbackServer();
+
+    LoopbackServer(const LoopbackServer &) = delete;
+    LoopbackServer &operator=(const LoopbackServer &) = delete;
+
+    int port() const { return m_port; }
+    std::string url(const char *path) const;
+    // TLS の場合にクライアントが信頼する証明書 (ClientOptions::rootCA に指定する)
+    const std::string &certificatePem() const { return m_certificatePem; }
+    int connections() const { return m_connections.load(); }
+    int requests() const { return m_requests.load(); }
+    // TLS のセッション再開で受け付けた接続数
+    int resumedSessions() const { return m_resumedSessions.load(); }
+
+    // Fixed / Chunked / Slow で返すボディ (破損を検出できるよう英小文字を順に並べる)
+    static std::string patternBody(size_t size);
+
+private:
+    struct Stream;
+
+    Options m_options;
+    int m_listener = -1;
+    int m_port = 0;
+    std::string m_response; // Fixed / Chunked / Slow で毎回送る応答
+    std::string m_certificatePem;
+    SSL_CTX *m_tlsContext = nullptr;
+    std::thread m_acceptThread;
+    std::vector<std::thread> m_threads;
+    std::vector<int> m_clients;
+    std::mutex m_mutex;
+    std::atomic<int> m_connections{0};
+    std::atomic<int> m_requests{0};
+    std::atomic<int> m_resumedSessions{0};
+
+    void start();
+    void acceptLoop();
+    void serve(int client);
+    bool respond(Stream &stream, const std::string &head, const std::string &body);
+    void proxy(Stream &stream, const std::string &head, const std::string &pending);
+    void setUpTls();
+};
+
+#endif // CANASPAD_PLATFORM_POSIX
+
+#endif // LOOPBACK_SERVER_H
\ No newline at end of file
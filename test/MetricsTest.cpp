@@ -0,0 +1,225 @@
+#include "MetricsTest.h"
+#include <memory>
+#include <string>
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "hello";
+
+    const char *kNotFound =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n";
+
+    const char *kRedirect =
+        "HTTP/1.1 302 Found\r\n"
+        "Location: https://example.com/moved\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient, const char *response)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+    }
+
+    std::unique_ptr<canaspad::HttpClient> newClient(canaspad::MockWiFiClientSecure **mockClient, int maxRetries = 0)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = maxRetries;
+        options.retryDelay = std::chrono::milliseconds(1);
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        return client;
+    }
+
+    canaspad::Request newRequest(const char *url = "https://example.com/status")
+    {
+        canaspad::Request request;
+        request.setUrl(url);
+        return request;
+    }
+
+    canaspad::RequestTiming timingOf(int ms)
+    {
+        canaspad::RequestTiming timing;
+        timing.start = std::chrono::steady_clock::now();
+        timing.end = timing.start + std::chrono::milliseconds(ms);
+        return timing;
+    }
+}
+
+void test_histogram_buckets_and_percentiles()
+{
+    TEST_ASSERT_EQUAL_INT(0, canaspad::LatencyHistogram::bucketIndex(0));
+    TEST_ASSERT_EQUAL_INT(0, canaspad::LatencyHistogram::bucketIndex(1));
+    TEST_ASSERT_EQUAL_INT(1, canaspad::LatencyHistogram::bucketIndex(2));
+    TEST_ASSERT_EQUAL_INT(canaspad::HistogramSnapshot::kBucketCount - 1, canaspad::LatencyHistogram::bucketIndex(60000));
+
+    canaspad::LatencyHistogram histogram;
+    for (int ms = 1; ms <= 100; ++ms)
+    {
+        histogram.record(std::chrono::milliseconds(ms));
+    }
+    auto snapshot = histogram.snapshot();
+    TEST_ASSERT_EQUAL_INT(100, snapshot.count);
+    TEST_ASSERT_EQUAL_INT(100, snapshot.maxMs);
+    TEST_ASSERT_EQUAL_INT(50, snapshot.meanMs());
+    // 区間の幅の範囲で実際の値に近い推定値になる
+    TEST_ASSERT_TRUE(snapshot.percentile(0.5) >= 40 && snapshot.percentile(0.5) <= 60);
+    TEST_ASSERT_TRUE(snapshot.percentile(0.99) >= 94 && snapshot.percentile(0.99) <= 100);
+    TEST_ASSERT_TRUE(snapshot.percentile(1.0) <= snapshot.maxMs);
+
+    canaspad::HistogramSnapshot empty;
+    TEST_ASSERT_EQUAL_INT(0, empty.percentile(0.5));
+}
+
+void test_histogram_merge()
+{
+    canaspad::LatencyHistogram fast;
+    canaspad::LatencyHistogram slow;
+    for (int i = 0; i < 90; ++i)
+    {
+        fast.record(std::chrono::milliseconds(10));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        slow.record(std::chrono::milliseconds(2500));
+    }
+
+    // 端末ごとのヒストグラムを足し合わせてから全体のパーセンタイルを求める
+    auto merged = fast.snapshot();
+    merged.merge(slow.snapshot());
+    TEST_ASSERT_EQUAL_INT(100, merged.count);
+    TEST_ASSERT_EQUAL_INT(2500, merged.maxMs);
+    TEST_ASSERT_TRUE(merged.percentile(0.5) <= 10);
+    TEST_ASSERT_TRUE(merged.percentile(0.99) > 2000);
+}
+
+void test_metrics_record_without_allocation()
+{
+    canaspad::ClientMetrics metrics;
+    auto timing = timingOf(12);
+    canaspad::AllocationScope scope;
+    metrics.record("example.com", 200, canaspad::ErrorCode::None, timing);
+    metrics.record("EXAMPLE.com", 200, canaspad::ErrorCode::None, timing);
+    metrics.addBytes(100, 200);
+    if (canaspad::AllocationScope::isEnabled())
+    {
+        TEST_ASSERT_EQUAL_INT(0, scope.count());
+    }
+
+    // ホスト名は大文字小文字を区別せずにまとめる
+    auto snapshot = metrics.snapshot();
+    TEST_ASSERT_EQUAL_INT(1, snapshot.endpoints.size());
+    TEST_ASSERT_EQUAL_STRING("example.com", snapshot.endpoints[0].host.c_str());
+    TEST_ASSERT_EQUAL_INT(2, snapshot.endpoints[0].requests);
+}
+
+void test_metrics_endpoint_overflow()
+{
+    canaspad::ClientMetrics metrics;
+    auto timing = timingOf(5);
+    for (size_t i = 0; i < canaspad::ClientMetrics::kMaxEndpoints + 3; ++i)
+    {
+        std::string host = "host" + std::to_string(i) + ".example.com";
+        metrics.record(host, 200, canaspad::ErrorCode::None, timing);
+    }
+
+    auto snapshot = metrics.snapshot();
+    TEST_ASSERT_EQUAL_INT(canaspad::ClientMetrics::kMaxEndpoints + 1, snapshot.endpoints.size());
+    TEST_ASSERT_EQUAL_STRING("*", snapshot.endpoints.back().host.c_str());
+    TEST_ASSERT_EQUAL_INT(3, snapshot.endpoints.back().requests);
+}
+
+void test_client_metrics_counts()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    injectResponse(mockClient, kResponse);
+    injectResponse(mockClient, kNotFound);
+    injectResponse(mockClient, kRedirect);
+    injectResponse(mockClient, kResponse);
+    TEST_ASSERT_TRUE(client->send(newRequest()).isSuccess());
+    TEST_ASSERT_TRUE(client->send(newRequest()).isSuccess());
+    TEST_ASSERT_TRUE(client->send(newRequest()).isSuccess());
+
+    auto metrics = client->getMetrics();
+    TEST_ASSERT_EQUAL_INT(3, metrics.requests);
+    TEST_ASSERT_EQUAL_INT(2, metrics.statusClasses[1]);
+    TEST_ASSERT_EQUAL_INT(1, metrics.statusClasses[3]);
+    TEST_ASSERT_EQUAL_INT(0, metrics.errorCount());
+    TEST_ASSERT_EQUAL_INT(1, metrics.redirects);
+    TEST_ASSERT_EQUAL_INT(2, metrics.reusedConnections);
+    TEST_ASSERT_EQUAL_INT(1, metrics.fullHandshakes);
+    TEST_ASSERT_EQUAL_INT(1, metrics.poolMisses);
+    TEST_ASSERT_EQUAL_INT(3, metrics.poolHits);
+    TEST_ASSERT_TRUE(metrics.poolHitRate() > 0.7);
+    TEST_ASSERT_TRUE(metrics.bytesSent > 0);
+    TEST_ASSERT_EQUAL_INT(strlen(kResponse) * 2 + strlen(kNotFound) + strlen(kRedirect), metrics.bytesReceived);
+    TEST_ASSERT_EQUAL_INT(3, metrics.latency.count);
+    TEST_ASSERT_EQUAL_INT(1, metrics.endpoints.size());
+    TEST_ASSERT_EQUAL_STRING("example.com", metrics.endpoints[0].host.c_str());
+}
+
+void test_client_metrics_errors_and_reset()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient, 2);
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::AlwaysFail);
+    TEST_ASSERT_TRUE(client->send(newRequest()).isError());
+
+    auto metrics = client->getMetrics();
+    TEST_ASSERT_EQUAL_INT(1, metrics.requests);
+    TEST_ASSERT_EQUAL_INT(1, metrics.errors[static_cast<size_t>(canaspad::ErrorCode::NetworkError)]);
+    TEST_ASSERT_EQUAL_INT(2, metrics.retries);
+    TEST_ASSERT_EQUAL_INT(1, metrics.endpoints[0].errors);
+
+    client->resetMetrics();
+    metrics = client->getMetrics();
+    TEST_ASSERT_EQUAL_INT(0, metrics.requests);
+    TEST_ASSERT_EQUAL_INT(0, metrics.errorCount());
+    TEST_ASSERT_EQUAL_INT(0, metrics.poolMisses);
+    TEST_ASSERT_EQUAL_INT(0, metrics.endpoints.size());
+}
+
+void test_metrics_json()
+{
+    canaspad::ClientMetrics metrics;
+    metrics.record("api.example.com", 200, canaspad::ErrorCode::None, timingOf(40));
+    metrics.record("api.example.com", 0, canaspad::ErrorCode::Timeout, timingOf(5000));
+    metrics.record("bad\"host", 503, canaspad::ErrorCode::None, timingOf(3));
+    metrics.addBytes(10, 20);
+
+    std::string json = metrics.snapshot().toJson();
+    TEST_MESSAGE(json.c_str());
+    TEST_ASSERT_TRUE(json.front() == '{');
+    TEST_ASSERT_TRUE(json.back() == '}');
+    TEST_ASSERT_TRUE(json.find("\"requests\":3,") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"status\":{\"2xx\":1,\"5xx\":1}") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"errors\":{\"Timeout\":1}") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"bytesOut\":10,\"bytesIn\":20") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"api.example.com\":{\"requests\":2,\"errors\":1,") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"bad\\\"host\"") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find("\"bounds\":[1,2,3,") != std::string::npos);
+    TEST_ASSERT_TRUE(json.find(",,") == std::string::npos);
+    TEST_ASSERT_TRUE(json.find(",}") == std::string::npos);
+}
+
+void run_metrics_tests(void)
+{
+    RUN_TEST(test_histogram_buckets_and_percentiles);
+    RUN_TEST(test_histogram_merge);
+    RUN_TEST(test_metrics_record_without_allocation);
+    RUN_TEST(test_metrics_endpoint_overflow);
+    RUN_TEST(test_client_metrics_counts);
+    RUN_TEST(test_client_metrics_errors_and_reset);
+    RUN_TEST(test_metrics_json);
+}
\ No newline at end of file
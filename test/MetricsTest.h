@@ -0,0 +1,15 @@
+#ifndef METRICS_TEST_H
+#define METRICS_TEST_H
+
+#include "helpers.h"
+
+void test_histogram_buckets_and_percentiles();
+void test_histogram_merge();
+void test_metrics_record_without_allocation();
+void test_metrics_endpoint_overflow();
+void test_client_metrics_counts();
+void test_client_metrics_errors_and_reset();
+void test_metrics_json();
+void run_metrics_tests(void);
+
+#endif // METRICS_TEST_H
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "MultipartTest.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    const char *kResponse = "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(kResponse, kResponse + strlen(kResponse)));
+    }
+
+    std::string allSentData(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        std::string sent;
+        for (const auto &entry : mockClient->getCommunicationLog().getLog())
+        {
+            if (entry.type == canaspad::CommunicationLog::Entry::Type::Sent &&
+                entry.source == canaspad::CommunicationLog::SourceType::Client)
+            {
+                sent.append(entry.data.begin(), entry.data.end());
+            }
+        }
+        return sent;
+    }
+
+    // BodySource を最後まで読み出す
+    std::string drain(canaspad::BodySource &source, size_t chunkSize)
+    {
+        std::string out;
+        std::vector<uint8_t> buf(chunkSize);
+        size_t n;
+        while ((n = source.pull(buf.data(), buf.size())) > 0)
+        {
+            out.append(reinterpret_cast<const char *>(buf.data()), n);
+        }
+        return out;
+    }
+
+    std::string bodyOf(const std::string &sent)
+    {
+        size_t pos = sent.find("\r\n\r\n");
+        return pos == std::string::npos ? std::string() : sent.substr(pos + 4);
+    }
+}
+
+void test_multipart_body_encoding()
+{
+    canaspad::MultipartBody body("BOUNDARY");
+    body.addField("device", "sensor-01")
+        .addFile("log", "boot \"1\".txt", "text/plain", std::string("line 1\nline 2\n"));
+
+    const std::string expected =
+        "--BOUNDARY\r\n"
+        "Content-Disposition: form-data; name=\"device\"\r\n"
+        "\r\n"
+        "sensor-01\r\n"
+        "--BOUNDARY\r\n"
+        "Content-Disposition: form-data; name=\"log\"; filename=\"boot %221%22.txt\"\r\n"
+        "Content-Type: text/plain\r\n"
+        "\r\n"
+        "line 1\nline 2\n\r\n"
+        "--BOUNDARY--\r\n";
+
+    size_t length = 0;
+    TEST_ASSERT_TRUE(body.contentLength(length));
+    TEST_ASSERT_EQUAL_INT(expected.size(), length);
+    TEST_ASSERT_EQUAL_STRING("multipart/form-data; boundary=BOUNDARY", body.contentType().c_str());
+
+    // 読み出す単位に関係なく同じバイト列になる
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), drain(body, 3).c_str());
+    TEST_ASSERT_TRUE(body.restart());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), drain(body, 1024).c_str());
+}
+
+void test_multipart_request_content_length()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    const std::string image(5000, '\x7f');
+    size_t position = 0;
+    auto reader = [&image, &position](uint8_t *buf, size_t size)
+    {
+        size_t n = std::min(size, image.size() - position);
+        std::memcpy(buf, image.data() + position, n);
+        position += n;
+        return n;
+    };
+
+    auto body = std::make_shared<canaspad::MultipartBody>();
+    body->addField("caption", "front door")
+        .addFile("image", "frame.jpg", "image/jpeg", std::make_shared<canaspad::CallbackBodySource>(reader, image.size()));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::POST).setMultipartBody(body);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(201, result.value().statusCode);
+
+    std::string sent = allSentData(mockClient);
+    TEST_ASSERT_TRUE(sent.find("Content-Type: multipart/form-data; boundary=" + body->boundary() + "\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Transfer-Encoding") == std::string::npos);
+
+    // 事前に計算した Content-Length と実際に送った本文の長さが一致する
+    std::string sentBody = bodyOf(sent);
+    TEST_ASSERT_TRUE(sent.find("Content-Length: " + std::to_string(sentBody.size()) + "\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sentBody.find("filename=\"frame.jpg\"\r\nContent-Type: image/jpeg\r\n\r\n" + image + "\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sentBody.find("--" + body->boundary() + "--\r\n") == sentBody.size() - body->boundary().size() - 6);
+}
+
+void test_multipart_form_data_fields()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/form")
+        .setMethod(canaspad::HttpMethod::POST)
+        .addHeader("X-Device", "sensor-01")
+        .setMultipartFormData({{"temperature", "21.5"}, {"humidity", "40"}});
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    std::string sent = allSentData(mockClient);
+    std::string sentBody = bodyOf(sent);
+    TEST_ASSERT_TRUE(sent.find("Content-Type: multipart/form-data; boundary=") != std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("X-Device: sensor-01\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Content-Length: " + std::to_string(sentBody.size()) + "\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sentBody.find("name=\"temperature\"\r\n\r\n21.5\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sentBody.find("name=\"humidity\"\r\n\r\n40\r\n") != std::string::npos);
+}
+
+void test_multipart_unknown_length_part_uses_chunked()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    bool done = false;
+    auto reader = [&done](uint8_t *buf, size_t)
+    {
+        if (done)
+        {
+            return size_t(0);
+        }
+        done = true;
+        std::memcpy(buf, "stream", 6);
+        return size_t(6);
+    };
+
+    auto body = std::make_shared<canaspad::MultipartBody>("B");
+    body->addFile("data", "live.bin", "application/octet-stream", std::make_shared<canaspad::CallbackBodySource>(reader));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::POST).setMultipartBody(body);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    // 長さが分からないパートがあれば全体を chunked で送る
+    std::string sent = allSentData(mockClient);
+    TEST_ASSERT_TRUE(sent.find("Content-Length") == std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(sent.find("Content-Type: application/octet-stream\r\n\r\nstream\r\n--B--\r\n") != std::string::npos);
+}
+
+// 2MB のファイルパートを送る間に send() が追加で使用するヒープの最大量
+// 以前は multipart の本文全体を文字列として組み立ててから送っていた
+void benchmark_multipart_large_file_peak_heap()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setRecordSentData(false);
+    injectResponse(mockClient);
+
+    const size_t fileSize = 2 * 1024 * 1024;
+    size_t position = 0;
+    auto reader = [&position, fileSize](uint8_t *buf, size_t size)
+    {
+        size_t n = std::min(size, fileSize - position);
+        std::memset(buf, 'f', n);
+        position += n;
+        return n;
+    };
+
+    auto body = std::make_shared<canaspad::MultipartBody>();
+    body->addField("name", "firmware").addFile("file", "firmware.bin", "application/octet-stream", std::make_shared<canaspad::CallbackBodySource>(reader, fileSize));
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::POST).setMultipartBody(body);
+
+    size_t peak;
+    {
+        canaspad::AllocationScope counter;
+        auto result = client.send(request);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        peak = counter.peakBytes();
+    }
+
+    TEST_ASSERT_EQUAL_INT(fileSize, position);
+    TEST_ASSERT_TRUE(peak < 16 * 1024);
+
+    char message[128];
+    snprintf(message, sizeof(message), "multipart file=%zu bytes: peak additional heap during send=%zu bytes", fileSize, peak);
+    TEST_MESSAGE(message);
+}
+
+void run_multipart_tests(void)
+{
+    RUN_TEST(test_multipart_body_encoding);
+    RUN_TEST(test_multipart_request_content_length);
+    RUN_TEST(test_multipart_form_data_fields);
+    RUN_TEST(test_multipart_unknown_length_part_uses_chunked);
+    RUN_TEST(benchmark_multipart_large_file_peak_heap);
+}
\ No newline at end of file
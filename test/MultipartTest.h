@@ -0,0 +1,13 @@
+#ifndef MULTIPART_TEST_H
+#define MULTIPART_TEST_H
+
+#include "helpers.h"
+
+void test_multipart_body_encoding();
+void test_multipart_request_content_length();
+void test_multipart_form_data_fields();
+void test_multipart_unknown_length_part_uses_chunked();
+void benchmark_multipart_large_file_peak_heap();
+void run_multipart_tests(void);
+
+#endif // MULTIPART_TEST_H
\ No newline at end of file
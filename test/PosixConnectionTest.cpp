@@ -0,0 +1,148 @@
+#include "PosixConnectionTest.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include "LoopbackServer.h"
+#include "../src/core/PosixConnection.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace
+{
+    std::string okResponse(const std::string &body)
+    {
+        return "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " + std::to_string(body.size()) +
+               "\r\nConnection: keep-alive\r\n\r\n" + body;
+    }
+
+    canaspad::ClientOptions hostOptions()
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        return options;
+    }
+}
+
+void test_posix_connection_round_trip()
+{
+    LoopbackServer server([](const std::string &, const std::string &)
+                          { return okResponse("pong"); });
+
+    canaspad::PosixConnection connection;
+    TEST_ASSERT_TRUE(connection.connect("127.0.0.1", server.port()));
+    TEST_ASSERT_TRUE(connection.isConnected());
+
+    const std::string head = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+    const std::string tail = "Connection: keep-alive\r\n\r\n";
+    const canaspad::WriteSegment segments[] = {
+        {reinterpret_cast<const uint8_t *>(head.data()), head.size()},
+        {reinterpret_cast<const uint8_t *>(tail.data()), tail.size()}};
+    TEST_ASSERT_EQUAL_INT(head.size() + tail.size(), connection.writev(segments, 2));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    TEST_ASSERT_TRUE(connection.waitForData(deadline) == canaspad::ReadReadiness::Ready);
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", connection.readLine().c_str());
+
+    canaspad::ConnectTiming timing;
+    TEST_ASSERT_TRUE(connection.getConnectTiming(timing));
+    TEST_ASSERT_TRUE(timing.dnsEnd >= timing.dnsStart);
+    TEST_ASSERT_TRUE(timing.connectEnd >= timing.connectStart);
+    uint32_t address = 0;
+    TEST_ASSERT_TRUE(connection.getResolvedAddress(address));
+    TEST_ASSERT_EQUAL_INT(htonl(INADDR_LOOPBACK), address);
+
+    connection.disconnect();
+    TEST_ASSERT_FALSE(connection.isConnected());
+}
+
+void test_posix_http_client_keep_alive()
+{
+    LoopbackServer server([](const std::string &head, const std::string &)
+                          { return okResponse(head.substr(0, head.find("\r\n"))); });
+    canaspad::HttpClient client(hostOptions());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        canaspad::Request request;
+        request.setUrl(server.url("/hello"));
+        auto result = client.send(request);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+        TEST_ASSERT_EQUAL_STRING("GET /hello HTTP/1.1", result.value().body.c_str());
+        TEST_ASSERT_EQUAL_INT(i > 0, result.value().timing.connectionReused);
+    }
+
+    // 2 回目以降はプールの接続を再利用する
+    TEST_ASSERT_EQUAL_INT(1, server.connections());
+    TEST_ASSERT_EQUAL_INT(3, server.requests());
+    TEST_ASSERT_EQUAL_INT(2, client.getConnectionPoolStats().hits);
+}
+
+void test_posix_http_client_post_body()
+{
+    LoopbackServer server([](const std::string &, const std::string &body)
+                          { return okResponse(std::to_string(body.size())); });
+    canaspad::HttpClient client(hostOptions());
+
+    canaspad::Request request;
+    request.setUrl(server.url("/upload")).setMethod(canaspad::HttpMethod::POST).setBody(std::string(100000, 'x'));
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("100000", result.value().body.c_str());
+}
+
+void test_posix_connection_refused()
+{
+    int port;
+    {
+        // 待ち受けを終えたポートには接続できない
+        LoopbackServer server([](const std::string &, const std::string &)
+                              { return std::string(); });
+        port = server.port();
+    }
+
+    canaspad::PosixConnection connection;
+    TEST_ASSERT_FALSE(connection.connect("127.0.0.1", port));
+
+    canaspad::HttpClient client(hostOptions());
+    canaspad::Request request;
+    request.setUrl("http://127.0.0.1:" + std::to_string(port) + "/");
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::NetworkError), static_cast<int>(result.error().code));
+}
+
+void test_posix_read_timeout()
+{
+    // レスポンスを返さないサーバー
+    LoopbackServer server([](const std::string &, const std::string &)
+                          { return std::string(); });
+    canaspad::HttpClient client(hostOptions());
+    client.setReadTimeout(std::chrono::milliseconds(100));
+
+    canaspad::Request request;
+    request.setUrl(server.url("/slow"));
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(canaspad::ErrorCode::Timeout), static_cast<int>(result.error().code));
+    TEST_ASSERT_TRUE(elapsed < std::chrono::seconds(1));
+}
+
+void run_posix_connection_tests(void)
+{
+    RUN_TEST(test_posix_connection_round_trip);
+    RUN_TEST(test_posix_http_client_keep_alive);
+    RUN_TEST(test_posix_http_client_post_body);
+    RUN_TEST(test_posix_connection_refused);
+    RUN_TEST(test_posix_read_timeout);
+}
+
+#else
+
+// PosixConnection はホストのビルドでのみ使う
+void run_posix_connection_tests(void) {}
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef POSIX_CONNECTION_TEST_H
+#define POSIX_CONNECTION_TEST_H
+
+#include "helpers.h"
+
+void test_posix_connection_round_trip();
+void test_posix_http_client_keep_alive();
+void test_posix_http_client_post_body();
+void test_posix_connection_refused();
+void test_posix_read_timeout();
+void run_posix_connection_tests(void);
+
+#endif // POSIX_CONNECTION_TEST_H
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef PREPARED_REQUEST_TEST_H
+#define PREPARED_REQUEST_TEST_H
+
+#include "helpers.h"
+
+void test_prepared_request_matches_ad_hoc_request();
+void test_prepared_request_updates_content_length();
+void test_prepared_request_rejects_multipart();
+void test_prepared_request_validates_url();
+void benchmark_prepared_request_per_send();
+void run_prepared_request_tests(void);
+
+#endif // PREPARED_REQUEST_TEST_H
\ No newline at end of file
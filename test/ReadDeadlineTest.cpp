@@ -0,0 +1,132 @@
+#include "ReadDeadlineTest.h"
+#include <cstring>
+#include <chrono>
+
+namespace
+{
+    void injectText(canaspad::MockWiFiClientSecure *mockClient, const char *text)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(text, text + strlen(text)));
+    }
+}
+
+void test_slow_response_completes_within_deadline()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    client.setReadTimeout(std::chrono::milliseconds(1000));
+
+    // 20ms ごとに 16 バイトずつ届く (全体で約 5 区切り)
+    mockClient->setReadBehavior(canaspad::ReadBehavior::SlowResponse, std::chrono::milliseconds(20));
+    injectText(mockClient,
+               "HTTP/1.1 200 OK\r\n"
+               "Content-Length: 26\r\n\r\n"
+               "abcdefghijklmnopqrstuvwxyz");
+
+    canaspad::Request request;
+    request.setUrl("https://example.com").setMethod(canaspad::HttpMethod::GET);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmnopqrstuvwxyz", result.value().body.c_str());
+    // 到着を待つだけで、読み取り全体の期限までは待たない
+    TEST_ASSERT_TRUE(elapsed.count() < 500);
+}
+
+void test_slow_response_past_deadline_times_out()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    client.setReadTimeout(std::chrono::milliseconds(100));
+
+    // 各区切りの到着は早いが、全体では読み取り期限を超える
+    mockClient->setReadBehavior(canaspad::ReadBehavior::SlowResponse, std::chrono::milliseconds(40));
+    injectText(mockClient,
+               "HTTP/1.1 200 OK\r\n"
+               "Content-Length: 64\r\n\r\n"
+               "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+
+    canaspad::Request request;
+    request.setUrl("https://example.com").setMethod(canaspad::HttpMethod::GET);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::Timeout, result.error().code);
+    TEST_ASSERT_TRUE(elapsed.count() >= 100 && elapsed.count() < 300);
+}
+
+void test_connection_closed_mid_body()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    client.setReadTimeout(std::chrono::milliseconds(1000));
+
+    // Content-Length より短いところで接続が閉じられる
+    injectText(mockClient,
+               "HTTP/1.1 200 OK\r\n"
+               "Content-Length: 32\r\n\r\n"
+               "truncated");
+
+    canaspad::Request request;
+    request.setUrl("https://example.com").setMethod(canaspad::HttpMethod::GET);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::NetworkError, result.error().code);
+    // 切断はすぐに検出され、読み取り期限まで待たない
+    TEST_ASSERT_TRUE(elapsed.count() < 500);
+}
+
+void test_body_until_close()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    client.setReadTimeout(std::chrono::milliseconds(1000));
+
+    // Content-Length も chunked もないレスポンスは切断までが本文
+    injectText(mockClient,
+               "HTTP/1.1 200 OK\r\n"
+               "Connection: close\r\n\r\n"
+               "read until close");
+
+    canaspad::Request request;
+    request.setUrl("https://example.com").setMethod(canaspad::HttpMethod::GET);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = client.send(request);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("read until close", result.value().body.c_str());
+    TEST_ASSERT_TRUE(elapsed.count() < 500);
+}
+
+void run_read_deadline_tests(void)
+{
+    RUN_TEST(test_slow_response_completes_within_deadline);
+    RUN_TEST(test_slow_response_past_deadline_times_out);
+    RUN_TEST(test_connection_closed_mid_body);
+    RUN_TEST(test_body_until_close);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef READ_DEADLINE_TEST_H
+#define READ_DEADLINE_TEST_H
+
+#include "helpers.h"
+
+void test_slow_response_completes_within_deadline();
+void test_slow_response_past_deadline_times_out();
+void test_connection_closed_mid_body();
+void test_body_until_close();
+void run_read_deadline_tests(void);
+
+#endif // READ_DEADLINE_TEST_H
\ No newline at end of file
@@ -19,7 +19,7 @@ void test_http_client_redirect_handling()
     const char *response2 =
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: text/plain\r\n"
-        "Content-Length: 18\r\n\r\n"
+        "Content-Length: 16\r\n\r\n"
         "Redirected page!";
     mockClient->injectResponse(std::vector<uint8_t>(response2, response2 + strlen(response2)));
 
@@ -0,0 +1,128 @@
+#include "RequestTimingTest.h"
+#include <memory>
+#include <string>
+
+namespace
+{
+    const char *kResponse =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "hello";
+
+    const char *kRedirect =
+        "HTTP/1.1 302 Found\r\n"
+        "Location: https://example.com/moved\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient, const char *response = kResponse)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(response, response + strlen(response)));
+    }
+
+    std::unique_ptr<canaspad::HttpClient> newClient(canaspad::MockWiFiClientSecure **mockClient, int maxRetries = 0)
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = maxRetries;
+        options.retryDelay = std::chrono::milliseconds(1);
+        std::unique_ptr<canaspad::HttpClient> client(new canaspad::HttpClient(options, true));
+        *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client->getConnection());
+        return client;
+    }
+
+    canaspad::Request newRequest()
+    {
+        canaspad::Request request;
+        request.setUrl("https://example.com/status");
+        return request;
+    }
+}
+
+void test_timing_phases_populated()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    mockClient->setHandshakeDelay(std::chrono::milliseconds(20));
+    injectResponse(mockClient);
+
+    auto result = client->send(newRequest());
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    const auto &timing = result.value().timing;
+    TEST_ASSERT_FALSE(timing.connectionReused);
+    TEST_ASSERT_EQUAL_INT(0, timing.retries);
+    TEST_ASSERT_EQUAL_INT(0, timing.redirects);
+    // 各段階は start から end の間に順に並ぶ
+    TEST_ASSERT_TRUE(timing.connect.dnsStart >= timing.start);
+    TEST_ASSERT_TRUE(timing.connect.dnsEnd <= timing.connect.connectStart);
+    TEST_ASSERT_TRUE(timing.connect.tlsEnd <= timing.requestSent);
+    TEST_ASSERT_TRUE(timing.requestSent <= timing.firstByte);
+    TEST_ASSERT_TRUE(timing.firstByte <= timing.responseEnd);
+    TEST_ASSERT_TRUE(timing.responseEnd <= timing.end);
+    // ハンドシェイクの遅延は TLS の段階に計上される
+    TEST_ASSERT_TRUE(timing.tlsHandshake() >= std::chrono::milliseconds(20));
+    TEST_ASSERT_TRUE(timing.total() >= timing.tlsHandshake());
+}
+
+void test_timing_reused_connection()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient);
+    injectResponse(mockClient);
+    TEST_ASSERT_TRUE(client->send(newRequest()).isSuccess());
+
+    injectResponse(mockClient);
+    auto result = client->send(newRequest());
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    // 再利用した接続では接続の段階を計測しない
+    const auto &timing = result.value().timing;
+    TEST_ASSERT_TRUE(timing.connectionReused);
+    TEST_ASSERT_EQUAL_INT(0, timing.dns().count());
+    TEST_ASSERT_EQUAL_INT(0, timing.tlsHandshake().count());
+    TEST_ASSERT_TRUE(timing.firstByte != canaspad::RequestTiming::TimePoint());
+}
+
+void test_timing_counts_redirects_and_retries()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient, 2);
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::FailNTimesThenSuccess, 1);
+    injectResponse(mockClient, kRedirect);
+    injectResponse(mockClient);
+
+    auto result = client->send(newRequest());
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    TEST_ASSERT_EQUAL_INT(1, result.value().timing.retries);
+    TEST_ASSERT_EQUAL_INT(1, result.value().timing.redirects);
+}
+
+void test_timing_attached_to_error()
+{
+    canaspad::MockWiFiClientSecure *mockClient;
+    auto client = newClient(&mockClient, 1);
+    mockClient->setConnectBehavior(canaspad::ConnectBehavior::AlwaysFail);
+
+    auto result = client->send(newRequest());
+    TEST_ASSERT_TRUE(result.isError());
+
+    // 失敗した送信でもリトライ回数と所要時間が分かる
+    const auto &timing = result.error().timing;
+    TEST_ASSERT_EQUAL_INT(1, timing.retries);
+    TEST_ASSERT_TRUE(timing.end >= timing.start);
+    TEST_ASSERT_TRUE(timing.total() >= std::chrono::milliseconds(1));
+    TEST_ASSERT_TRUE(timing.requestSent == canaspad::RequestTiming::TimePoint());
+}
+
+void run_request_timing_tests(void)
+{
+    RUN_TEST(test_timing_phases_populated);
+    RUN_TEST(test_timing_reused_connection);
+    RUN_TEST(test_timing_counts_redirects_and_retries);
+    RUN_TEST(test_timing_attached_to_error);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef REQUEST_TIMING_TEST_H
+#define REQUEST_TIMING_TEST_H
+
+#include "helpers.h"
+
+void test_timing_phases_populated();
+void test_timing_reused_connection();
+void test_timing_counts_redirects_and_retries();
+void test_timing_attached_to_error();
+void run_request_timing_tests(void);
+
+#endif // REQUEST_TIMING_TEST_H
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "RequestWriteTest.h"
+#include <string>
+
+namespace
+{
+    const char *kResponse = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nOK";
+
+    void injectResponse(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        mockClient->injectResponse(std::vector<uint8_t>(kResponse, kResponse + strlen(kResponse)));
+    }
+
+    std::vector<std::string> sentEntries(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        std::vector<std::string> entries;
+        for (const auto &entry : mockClient->getCommunicationLog().getLog())
+        {
+            if (entry.type == canaspad::CommunicationLog::Entry::Type::Sent &&
+                entry.source == canaspad::CommunicationLog::SourceType::Client)
+            {
+                entries.emplace_back(entry.data.begin(), entry.data.end());
+            }
+        }
+        return entries;
+    }
+}
+
+void test_small_request_coalesced_into_one_write()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/api").setMethod(canaspad::HttpMethod::POST).setBody("{\"value\":1}");
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    // ヘッダーと小さな本文は 1 回の書き込み (1 レコード) にまとめる
+    TEST_ASSERT_EQUAL_INT(1, mockClient->getWriteCount());
+    auto entries = sentEntries(mockClient);
+    TEST_ASSERT_EQUAL_INT(1, entries.size());
+    TEST_ASSERT_TRUE(entries[0].find("Content-Length: 11\r\n\r\n{\"value\":1}") != std::string::npos);
+}
+
+void test_large_body_written_as_separate_segment()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectResponse(mockClient);
+
+    std::string body(4096, 'x');
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBody(body);
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+
+    // 大きな本文はヘッダーと連結せず、そのまま書き込む
+    TEST_ASSERT_EQUAL_INT(2, mockClient->getWriteCount());
+    auto entries = sentEntries(mockClient);
+    TEST_ASSERT_EQUAL_INT(2, entries.size());
+    TEST_ASSERT_TRUE(entries[0].find("Content-Length: 4096\r\n\r\n") != std::string::npos);
+    TEST_ASSERT_EQUAL_INT(entries[0].size(), entries[0].find("\r\n\r\n") + 4);
+    TEST_ASSERT_TRUE(entries[1] == body);
+}
+
+void test_write_failure_reported()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    options.maxRetries = 0;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setWriteBehavior(canaspad::WriteBehavior::DropConnection);
+    injectResponse(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBody(std::string(2048, 'x'));
+    auto result = client.send(request);
+
+    // 切断された接続には本文を書き込まない
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::NetworkError, result.error().code);
+    TEST_ASSERT_EQUAL_INT(0, sentEntries(mockClient).size());
+}
+
+// 100KB のアップロード中に send() が追加で使用するヒープの最大量
+// 以前はヘッダーの ostringstream、その文字列化、リクエストのコピーで本文が 3 重に存在した
+void benchmark_upload_peak_heap()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setRecordSentData(false);
+    injectResponse(mockClient);
+
+    const size_t bodySize = 100 * 1024;
+    canaspad::Request request;
+    request.setUrl("https://example.com/upload").setMethod(canaspad::HttpMethod::PUT).setBody(std::string(bodySize, 'x'));
+
+    size_t peak;
+    {
+        canaspad::AllocationScope counter;
+        auto result = client.send(request);
+        TEST_ASSERT_TRUE(result.isSuccess());
+        peak = counter.peakBytes();
+    }
+
+    // 本文は呼び出し側の Request にある 1 つだけで、送信処理はその一部も複製しない
+    TEST_ASSERT_TRUE(peak < bodySize / 4);
+
+    char message[128];
+    snprintf(message, sizeof(message), "upload body=%zu bytes: peak additional heap during send=%zu bytes", bodySize, peak);
+    TEST_MESSAGE(message);
+}
+
+void run_request_write_tests(void)
+{
+    RUN_TEST(test_small_request_coalesced_into_one_write);
+    RUN_TEST(test_large_body_written_as_separate_segment);
+    RUN_TEST(test_write_failure_reported);
+    RUN_TEST(benchmark_upload_peak_heap);
+}
\ No newline at end of file
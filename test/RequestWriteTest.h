@@ -0,0 +1,12 @@
+#ifndef REQUEST_WRITE_TEST_H
+#define REQUEST_WRITE_TEST_H
+
+#include "helpers.h"
+
+void test_small_request_coalesced_into_one_write();
+void test_large_body_written_as_separate_segment();
+void test_write_failure_reported();
+void benchmark_upload_peak_heap();
+void run_request_write_tests(void);
+
+#endif // REQUEST_WRITE_TEST_H
\ No newline at end of file
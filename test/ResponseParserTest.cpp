@@ -0,0 +1,198 @@
+#include "ResponseParserTest.h"
+#include "../src/core/ResponseParser.h"
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace
+{
+    struct ParsedResponse
+    {
+        int statusCode = 0;
+        std::string statusMessage;
+        std::map<std::string, std::string> headers;
+        std::map<std::string, std::string> trailers;
+        std::string body;
+        bool complete = false;
+    };
+
+    // レスポンスを fragmentSize バイトずつパーサへ渡す
+    ParsedResponse parseInFragments(const std::string &response, size_t fragmentSize)
+    {
+        ParsedResponse parsed;
+        canaspad::ResponseParser parser;
+        parser.onStatus([&](int code, std::string_view message)
+                        {
+                            parsed.statusCode = code;
+                            parsed.statusMessage = message; });
+        parser.onHeader([&](std::string_view key, std::string_view value)
+                        { parsed.headers[std::string(key)] = std::string(value); });
+        parser.onTrailer([&](std::string_view key, std::string_view value)
+                         { parsed.trailers[std::string(key)] = std::string(value); });
+        parser.onBody([&](const char *data, size_t size)
+                      { parsed.body.append(data, size); });
+
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(response.data());
+        for (size_t offset = 0; offset < response.size() && !parser.isComplete(); offset += fragmentSize)
+        {
+            parser.feed(data + offset, std::min(fragmentSize, response.size() - offset));
+        }
+        parsed.complete = parser.isComplete();
+        return parsed;
+    }
+
+    std::string buildResponseWithHeaders(size_t headerCount, size_t bodySize)
+    {
+        std::string response = "HTTP/1.1 200 OK\r\n";
+        for (size_t i = 0; i < headerCount; ++i)
+        {
+            response += "X-Header-" + std::to_string(i) + ": value-" + std::to_string(i) + "\r\n";
+        }
+        response += "Content-Length: " + std::to_string(bodySize) + "\r\n\r\n";
+        response += std::string(bodySize, 'x');
+        return response;
+    }
+}
+
+void test_response_parser_content_length_fragments()
+{
+    const std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 13\r\n"
+        "\r\n"
+        "Hello, World!";
+
+    for (size_t fragmentSize : {1, 17, 4096})
+    {
+        auto parsed = parseInFragments(response, fragmentSize);
+        TEST_ASSERT_TRUE(parsed.complete);
+        TEST_ASSERT_EQUAL_INT(200, parsed.statusCode);
+        TEST_ASSERT_EQUAL_STRING("OK", parsed.statusMessage.c_str());
+        TEST_ASSERT_EQUAL_STRING("text/plain", parsed.headers["Content-Type"].c_str());
+        TEST_ASSERT_EQUAL_STRING("Hello, World!", parsed.body.c_str());
+    }
+}
+
+void test_response_parser_chunked_fragments()
+{
+    const std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "7\r\nHello, \r\n"
+        "6;ext=1\r\nWorld!\r\n"
+        "0\r\n"
+        "X-Checksum: abc\r\n"
+        "\r\n";
+
+    for (size_t fragmentSize : {1, 17, 4096})
+    {
+        auto parsed = parseInFragments(response, fragmentSize);
+        TEST_ASSERT_TRUE(parsed.complete);
+        TEST_ASSERT_EQUAL_STRING("Hello, World!", parsed.body.c_str());
+        TEST_ASSERT_EQUAL_STRING("abc", parsed.trailers["X-Checksum"].c_str());
+    }
+}
+
+void test_response_parser_skips_informational_response()
+{
+    const std::string response =
+        "HTTP/1.1 100 Continue\r\n\r\n"
+        "HTTP/1.1 201 Created\r\n"
+        "Content-Length: 2\r\n\r\n"
+        "ok";
+
+    auto parsed = parseInFragments(response, 17);
+    TEST_ASSERT_TRUE(parsed.complete);
+    TEST_ASSERT_EQUAL_INT(201, parsed.statusCode);
+    TEST_ASSERT_EQUAL_STRING("ok", parsed.body.c_str());
+}
+
+void test_response_parser_ignores_informational_headers()
+{
+    const std::string response =
+        "HTTP/1.1 103 Early Hints\r\n"
+        "Link: </a>\r\n"
+        "Connection: close\r\n\r\n"
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 0\r\n\r\n";
+
+    ParsedResponse parsed;
+    canaspad::ResponseParser parser;
+    parser.onStatus([&](int code, std::string_view message)
+                    {
+                        parsed.statusCode = code;
+                        parsed.statusMessage = message; });
+    parser.onHeader([&](std::string_view key, std::string_view value)
+                    { parsed.headers[std::string(key)] = std::string(value); });
+    parser.feed(reinterpret_cast<const uint8_t *>(response.data()), response.size());
+
+    // 中間レスポンスのヘッダーは最終レスポンスに含まれず、接続も閉じない
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_INT(200, parsed.statusCode);
+    TEST_ASSERT_EQUAL_STRING("OK", parsed.statusMessage.c_str());
+    TEST_ASSERT_TRUE(parsed.headers.find("Link") == parsed.headers.end());
+    TEST_ASSERT_EQUAL_INT(1, parsed.headers.size());
+    TEST_ASSERT_TRUE(parser.keepAlive());
+}
+
+void test_response_parser_rejects_invalid_chunk_size()
+{
+    const std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "zz\r\n";
+
+    canaspad::ResponseParser parser;
+    parser.feed(reinterpret_cast<const uint8_t *>(response.data()), response.size());
+    TEST_ASSERT_TRUE(parser.hasError());
+}
+
+// 同じレスポンスを 1 / 17 / 4096 バイト断片で渡し、ヘッダ量に対するバイトあたりのコストを報告する
+void benchmark_response_parser_linear_cost()
+{
+    const std::string small = buildResponseWithHeaders(32, 1024);
+    const std::string large = buildResponseWithHeaders(512, 1024);
+
+    for (size_t fragmentSize : {1, 17, 4096})
+    {
+        double nsPerByte[2];
+        const std::string *responses[2] = {&small, &large};
+        for (int i = 0; i < 2; ++i)
+        {
+            // ノイズを避けるため最良値を採用する
+            double best = 0;
+            for (int run = 0; run < 5; ++run)
+            {
+                auto start = std::chrono::steady_clock::now();
+                auto parsed = parseInFragments(*responses[i], fragmentSize);
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                TEST_ASSERT_TRUE(parsed.complete);
+                double perByte = static_cast<double>(elapsed) / responses[i]->size();
+                if (run == 0 || perByte < best)
+                {
+                    best = perByte;
+                }
+            }
+            nsPerByte[i] = best;
+        }
+
+        char message[128];
+        snprintf(message, sizeof(message), "fragment=%u small=%.1f ns/byte large=%.1f ns/byte",
+                 static_cast<unsigned>(fragmentSize), nsPerByte[0], nsPerByte[1]);
+        // ヘッダが 16 倍になってもバイトあたりのコストはほぼ一定 (二次的なら 16 倍近くになる)
+        // 実行環境の負荷で揺れるため、値は報告するだけで判定しない
+        TEST_MESSAGE(message);
+    }
+}
+
+void run_response_parser_tests(void)
+{
+    RUN_TEST(test_response_parser_content_length_fragments);
+    RUN_TEST(test_response_parser_chunked_fragments);
+    RUN_TEST(test_response_parser_skips_informational_response);
+    RUN_TEST(test_response_parser_ignores_informational_headers);
+    RUN_TEST(test_response_parser_rejects_invalid_chunk_size);
+    RUN_TEST(benchmark_response_parser_linear_cost);
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef RESPONSE_PARSER_TEST_H
+#define RESPONSE_PARSER_TEST_H
+
+#include "helpers.h"
+
+void test_response_parser_content_length_fragments();
+void test_response_parser_chunked_fragments();
+void test_response_parser_skips_informational_response();
+void test_response_parser_ignores_informational_headers();
+void test_response_parser_rejects_invalid_chunk_size();
+void benchmark_response_parser_linear_cost();
+void run_response_parser_tests(void);
+
+#endif // RESPONSE_PARSER_TEST_H
\ No newline at end of file
@@ -19,7 +19,7 @@ void test_http_client_retry_on_network_error()
     const char *successResponse =
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: text/plain\r\n"
-        "Content-Length: 12\r\n\r\n"
+        "Content-Length: 8\r\n\r\n"
         "Success!";
     mockClient->injectResponse(std::vector<uint8_t>(successResponse, successResponse + strlen(successResponse)));
 
@@ -0,0 +1,122 @@
+#include "StreamingTest.h"
+#include <cstring>
+#include <string>
+
+void test_streaming_delivers_body_without_buffering()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setRecordReceivedData(false);
+
+    // 64KB のボディを持つレスポンス
+    const size_t bodySize = 64 * 1024;
+    std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(bodySize) + "\r\n\r\n";
+    for (size_t i = 0; i < bodySize; ++i)
+    {
+        response += static_cast<char>('a' + (i % 26));
+    }
+    mockClient->injectResponse(response);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/firmware.bin").setMethod(canaspad::HttpMethod::GET);
+
+    size_t totalBytes = 0;
+    size_t largestChunk = 0;
+    bool contentMatches = true;
+    auto result = client.sendStreaming(request, [&](const char *data, size_t size)
+                                       {
+                                           for (size_t i = 0; i < size; ++i)
+                                           {
+                                               if (data[i] != static_cast<char>('a' + ((totalBytes + i) % 26)))
+                                               {
+                                                   contentMatches = false;
+                                               }
+                                           }
+                                           totalBytes += size;
+                                           largestChunk = std::max(largestChunk, size); });
+
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_INT(200, result.value().statusCode);
+    // ボディは HttpResult に蓄積されない
+    TEST_ASSERT_TRUE(result.value().body.empty());
+    TEST_ASSERT_EQUAL_INT(bodySize, totalBytes);
+    TEST_ASSERT_TRUE(contentMatches);
+    // 1回の受け渡しは読み込みバッファ (4KB) を超えない
+    TEST_ASSERT_TRUE(largestChunk <= 4096);
+}
+
+void test_streaming_decodes_chunked_body()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    mockClient->injectResponse(std::string(
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "3\r\nabc\r\n"
+        "4\r\ndefg\r\n"
+        "0\r\n\r\n"));
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/stream").setMethod(canaspad::HttpMethod::GET);
+
+    std::string received;
+    int chunkCount = 0;
+    auto result = client.sendStreaming(request, [&](const char *data, size_t size)
+                                       {
+                                           received.append(data, size);
+                                           chunkCount++; });
+
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("abcdefg", received.c_str());
+    TEST_ASSERT_EQUAL_INT(2, chunkCount);
+    TEST_ASSERT_TRUE(result.value().body.empty());
+}
+
+void test_send_uses_response_body_callback()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+
+    mockClient->injectResponse(std::string("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nHello"));
+
+    std::string received;
+    client.setResponseBodyCallback([&](const char *data, size_t size)
+                                   { received.append(data, size); });
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    auto result = client.send(request);
+    TEST_ASSERT_TRUE(result.isSuccess());
+    TEST_ASSERT_EQUAL_STRING("Hello", received.c_str());
+    TEST_ASSERT_TRUE(result.value().body.empty());
+}
+
+void test_streaming_requires_callback()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    auto result = client.sendStreaming(request, nullptr);
+    TEST_ASSERT_TRUE(result.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::InvalidOption, result.error().code);
+}
+
+void run_streaming_tests(void)
+{
+    RUN_TEST(test_streaming_delivers_body_without_buffering);
+    RUN_TEST(test_streaming_decodes_chunked_body);
+    RUN_TEST(test_send_uses_response_body_callback);
+    RUN_TEST(test_streaming_requires_callback);
+}
\ No newline at end of file
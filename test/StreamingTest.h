@@ -0,0 +1,12 @@
+#ifndef STREAMING_TEST_H
+#define STREAMING_TEST_H
+
+#include "helpers.h"
+
+void test_streaming_delivers_body_without_buffering();
+void test_streaming_decodes_chunked_body();
+void test_send_uses_response_body_callback();
+void test_streaming_requires_callback();
+void run_streaming_tests(void);
+
+#endif // STREAMING_TEST_H
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "ThroughputBenchmarkTest.h"
+
+#if CANASPAD_PLATFORM_POSIX
+
+#include "LoopbackServer.h"
+#include "../src/core/OpenSslConnection.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    // CANASPAD_BENCH_REQUESTS で各シナリオのリクエスト数を上書きできる (既定はテストとして短時間で終わる数)
+    size_t requestCount(size_t defaultCount)
+    {
+        const char *value = std::getenv("CANASPAD_BENCH_REQUESTS");
+        long count = value ? std::atol(value) : 0;
+        return count > 0 ? static_cast<size_t>(count) : defaultCount;
+    }
+
+    // 最近傍順位法によるパーセンタイル (sorted は昇順)
+    uint64_t percentile(const std::vector<uint64_t> &sorted, double p)
+    {
+        size_t rank = static_cast<size_t>(p * sorted.size() + 0.999999);
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    // 結果を 1 行の JSON として出力する
+    // CANASPAD_BENCH_JSON にファイル名を指定すると、同じ行をそのファイルに追記する
+    void report(const char *scenario, size_t requests, int connections, std::vector<uint64_t> &latenciesUs,
+                std::chrono::steady_clock::duration elapsed, size_t bytes)
+    {
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        uint64_t sum = 0;
+        for (uint64_t latency : latenciesUs)
+        {
+            sum += latency;
+        }
+        double seconds = std::chrono::duration<double>(elapsed).count();
+
+        char line[512];
+        snprintf(line, sizeof(line),
+                 "{\"scenario\":\"%s\",\"requests\":%zu,\"connections\":%d,\"elapsed_us\":%lld,"
+                 "\"requests_per_sec\":%.1f,\"bytes_per_sec\":%.0f,"
+                 "\"latency_us\":{\"min\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"max\":%llu,\"mean\":%.1f}}",
+                 scenario, requests, connections,
+                 static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+                 requests / seconds, bytes / seconds,
+                 static_cast<unsigned long long>(latenciesUs.front()),
+                 static_cast<unsigned long long>(percentile(latenciesUs, 0.50)),
+                 static_cast<unsigned long long>(percentile(latenciesUs, 0.90)),
+                 static_cast<unsigned long long>(percentile(latenciesUs, 0.99)),
+                 static_cast<unsigned long long>(latenciesUs.back()),
+                 static_cast<double>(sum) / latenciesUs.size());
+
+        std::string message = std::string("BENCH ") + line;
+        TEST_MESSAGE(message.c_str());
+
+        if (const char *path = std::getenv("CANASPAD_BENCH_JSON"))
+        {
+            if (FILE *file = std::fopen(path, "a"))
+            {
+                std::fprintf(file, "%s\n", line);
+                std::fclose(file);
+            }
+        }
+    }
+
+    canaspad::ClientOptions benchOptions()
+    {
+        canaspad::ClientOptions options;
+        options.verifySsl = false;
+        options.maxRetries = 0;
+        return options;
+    }
+
+    // 1 回目 (名前解決と接続の確立) を除いて count 回送り、1 回ごとの所要時間を計測する
+    void runScenario(const char *scenario, const LoopbackServer &server, canaspad::HttpClient &client,
+                     const std::string &url, size_t count, size_t expectedBodySize)
+    {
+        canaspad::Request request;
+        request.setUrl(url);
+        auto warmUp = client.send(request);
+        TEST_ASSERT_TRUE(warmUp.isSuccess());
+        int connectionsBefore = server.connections();
+
+        std::vector<uint64_t> latenciesUs;
+        latenciesUs.reserve(count);
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto requestStart = std::chrono::steady_clock::now();
+            auto result = client.send(request);
+            auto requestEnd = std::chrono::steady_clock::now();
+            TEST_ASSERT_TRUE(result.isSuccess());
+            TEST_ASSERT_EQUAL_INT(expectedBodySize, result.value().body.size());
+            latenciesUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(requestEnd - requestStart).count());
+            bytes += result.value().body.size();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        report(scenario, count, server.connections() - connectionsBefore, latenciesUs, elapsed, bytes);
+    }
+
+    LoopbackServer::Options serverOptions(LoopbackServer::Behavior behavior, size_t bodySize)
+    {
+        LoopbackServer::Options options;
+        options.behavior = behavior;
+        options.bodySize = bodySize;
+        return options;
+    }
+}
+
+void test_benchmark_keep_alive_small()
+{
+    LoopbackServer server(serverOptions(LoopbackServer::Behavior::Fixed, 1024));
+    canaspad::HttpClient client(benchOptions());
+    runScenario("keep_alive_1k", server, client, server.url("/small"), requestCount(500), 1024);
+}
+
+void test_benchmark_keep_alive_large()
+{
+    LoopbackServer server(serverOptions(LoopbackServer::Behavior::Fixed, 65536));
+    canaspad::HttpClient client(benchOptions());
+    runScenario("keep_alive_64k", server, client, server.url("/large"), requestCount(200), 65536);
+}
+
+void test_benchmark_chunked()
+{
+    LoopbackServer server(serverOptions(LoopbackServer::Behavior::Chunked, 65536));
+    canaspad::HttpClient client(benchOptions());
+    runScenario("chunked_64k", server, client, server.url("/chunked"), requestCount(200), 65536);
+}
+
+void test_benchmark_connection_close()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Fixed, 1024);
+    options.keepAlive = false;
+    LoopbackServer server(options);
+    canaspad::HttpClient client(benchOptions());
+    runScenario("close_1k", server, client, server.url("/close"), requestCount(200), 1024);
+}
+
+void test_benchmark_slow()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Slow, 4096);
+    options.slowPieces = 4;
+    options.slowDelay = std::chrono::milliseconds(1);
+    LoopbackServer server(options);
+    canaspad::HttpClient client(benchOptions());
+    runScenario("slow_4k", server, client, server.url("/slow"), requestCount(50), 4096);
+}
+
+void test_benchmark_proxy()
+{
+    LoopbackServer origin(serverOptions(LoopbackServer::Behavior::Fixed, 1024));
+    LoopbackServer proxy(serverOptions(LoopbackServer::Behavior::Proxy, 0));
+    auto options = benchOptions();
+    options.proxyUrl = "http://127.0.0.1:" + std::to_string(proxy.port());
+    canaspad::HttpClient client(options);
+    runScenario("proxy_1k", proxy, client, origin.url("/proxied"), requestCount(500), 1024);
+}
+
+#ifdef CANASPAD_USE_OPENSSL
+
+namespace
+{
+    canaspad::ClientOptions tlsBenchOptions(const LoopbackServer &server)
+    {
+        auto options = benchOptions();
+        options.verifySsl = true;
+        options.rootCA = server.certificatePem();
+        options.connectionFactory = [](const std::string &)
+        { return std::shared_ptr<canaspad::Connection>(std::make_shared<canaspad::OpenSslConnection>()); };
+        return options;
+    }
+}
+
+void test_benchmark_tls_keep_alive()
+{
+    auto options = serverOptions(LoopbackServer::Behavior::Fixed, 1024);
+    options.tls = true;
+    LoopbackServer server(options);
+    canaspad::HttpClient client(tlsBenchOptions(server));
+    runScenario("tls_keep_alive_1k", server, client, server.url("/secure"), requestCount(500), 1024);
+}
+
+void test_benchmark_tls_connection_close()
+{
+    // 毎回接続し直すが、TlsSessionCache によりハンドシェイクは簡略化される
+    auto options = serverOptions(LoopbackServer::Behavior::Fixed, 1024);
+    options.tls = true;
+    options.keepAlive = false;
+    LoopbackServer server(options);
+    canaspad::HttpClient client(tlsBenchOptions(server));
+    runScenario("tls_close_1k", server, client, server.url("/secure"), requestCount(100), 1024);
+    TEST_ASSERT_TRUE(server.resumedSessions() > 0);
+}
+
+#endif // CANASPAD_USE_OPENSSL
+
+void run_throughput_benchmark_tests(void)
+{
+    RUN_TEST(test_benchmark_keep_alive_small);
+    RUN_TEST(test_benchmark_keep_alive_large);
+    RUN_TEST(test_benchmark_chunked);
+    RUN_TEST(test_benchmark_connection_close);
+    RUN_TEST(test_benchmark_slow);
+    RUN_TEST(test_benchmark_proxy);
+#ifdef CANASPAD_USE_OPENSSL
+    RUN_TEST(test_benchmark_tls_keep_alive);
+    RUN_TEST(test_benchmark_tls_connection_close);
+#endif
+}
+
+#else
+
+// ベンチマークはホストのビルドでのみ実行する
+void run_throughput_benchmark_tests(void) {}
+
+#endif // CANASPAD_PLATFORM_POSIX
\ No newline at end of file
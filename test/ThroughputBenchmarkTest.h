@@ -0,0 +1,16 @@
+#ifndef THROUGHPUT_BENCHMARK_TEST_H
+#define THROUGHPUT_BENCHMARK_TEST_H
+
+#include "helpers.h"
+
+void test_benchmark_keep_alive_small();
+void test_benchmark_keep_alive_large();
+void test_benchmark_chunked();
+void test_benchmark_connection_close();
+void test_benchmark_slow();
+void test_benchmark_proxy();
+void test_benchmark_tls_keep_alive();
+void test_benchmark_tls_connection_close();
+void run_throughput_benchmark_tests(void);
+
+#endif // THROUGHPUT_BENCHMARK_TEST_H
\ No newline at end of file
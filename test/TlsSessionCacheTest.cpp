@@ -0,0 +1,118 @@
+#include "TlsSessionCacheTest.h"
+#include "../src/core/TlsSessionCache.h"
+#include <cstring>
+
+namespace
+{
+    std::vector<uint8_t> bytes(const char *text)
+    {
+        return std::vector<uint8_t>(text, text + strlen(text));
+    }
+
+    // 1 回目の応答で接続を閉じさせ、2 回目のリクエストで再接続させる
+    void injectClosingResponses(canaspad::MockWiFiClientSecure *mockClient)
+    {
+        mockClient->injectResponse(std::string("HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok"));
+        mockClient->injectResponse(std::string("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok"));
+    }
+}
+
+void test_tls_session_cache_store_and_lookup()
+{
+    canaspad::TlsSessionCache cache(4, std::chrono::hours(1));
+    std::vector<uint8_t> session;
+
+    TEST_ASSERT_FALSE(cache.lookup("example.com:443", session));
+    cache.store("example.com:443", bytes("ticket"));
+    TEST_ASSERT_TRUE(cache.lookup("example.com:443", session));
+    TEST_ASSERT_TRUE(session == bytes("ticket"));
+
+    // ポートが異なれば別のセッションとして扱う
+    TEST_ASSERT_FALSE(cache.lookup("example.com:8443", session));
+
+    cache.remove("example.com:443");
+    TEST_ASSERT_FALSE(cache.lookup("example.com:443", session));
+}
+
+void test_tls_session_cache_evicts_least_recently_used()
+{
+    canaspad::TlsSessionCache cache(2, std::chrono::hours(1));
+    std::vector<uint8_t> session;
+
+    cache.store("a:443", bytes("a"));
+    canaspad::platform::sleepFor(std::chrono::milliseconds(2));
+    cache.store("b:443", bytes("b"));
+    canaspad::platform::sleepFor(std::chrono::milliseconds(2));
+    // a を参照して b を最も古いエントリにする
+    TEST_ASSERT_TRUE(cache.lookup("a:443", session));
+    canaspad::platform::sleepFor(std::chrono::milliseconds(2));
+    cache.store("c:443", bytes("c"));
+
+    TEST_ASSERT_TRUE(cache.lookup("a:443", session));
+    TEST_ASSERT_FALSE(cache.lookup("b:443", session));
+    TEST_ASSERT_TRUE(cache.lookup("c:443", session));
+    TEST_ASSERT_EQUAL_INT(1, cache.getStats().evictions);
+    TEST_ASSERT_EQUAL_INT(2, cache.getStats().entries);
+}
+
+void test_tls_session_cache_expires_sessions()
+{
+    canaspad::TlsSessionCache cache(4, std::chrono::milliseconds(10));
+    std::vector<uint8_t> session;
+
+    cache.store("example.com:443", bytes("ticket"));
+    canaspad::platform::sleepFor(std::chrono::milliseconds(20));
+    TEST_ASSERT_FALSE(cache.lookup("example.com:443", session));
+    TEST_ASSERT_EQUAL_INT(0, cache.getStats().entries);
+}
+
+void test_http_client_resumes_tls_session_on_reconnect()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    injectClosingResponses(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+
+    // 2 回目の接続は保存したセッションで再開される
+    auto stats = client.getTlsSessionStats();
+    TEST_ASSERT_EQUAL_INT(1, stats.fullHandshakes);
+    TEST_ASSERT_EQUAL_INT(1, stats.resumedHandshakes);
+    TEST_ASSERT_EQUAL_INT(1, stats.entries);
+}
+
+void test_http_client_falls_back_to_full_handshake()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    canaspad::HttpClient client(options, true);
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->setSessionResumptionEnabled(false);
+    injectClosingResponses(mockClient);
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+
+    // サーバーがセッションを拒否してもリクエストは成功する
+    auto stats = client.getTlsSessionStats();
+    TEST_ASSERT_EQUAL_INT(2, stats.fullHandshakes);
+    TEST_ASSERT_EQUAL_INT(0, stats.resumedHandshakes);
+}
+
+void run_tls_session_cache_tests(void)
+{
+    RUN_TEST(test_tls_session_cache_store_and_lookup);
+    RUN_TEST(test_tls_session_cache_evicts_least_recently_used);
+    RUN_TEST(test_tls_session_cache_expires_sessions);
+    RUN_TEST(test_http_client_resumes_tls_session_on_reconnect);
+    RUN_TEST(test_http_client_falls_back_to_full_handshake);
+}
\ No newline at end of file
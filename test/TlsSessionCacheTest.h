@@ -0,0 +1,13 @@
+#ifndef TLS_SESSION_CACHE_TEST_H
+#define TLS_SESSION_CACHE_TEST_H
+
+#include "helpers.h"
+
+void test_tls_session_cache_store_and_lookup();
+void test_tls_session_cache_evicts_least_recently_used();
+void test_tls_session_cache_expires_sessions();
+void test_http_client_resumes_tls_session_on_reconnect();
+void test_http_client_falls_back_to_full_handshake();
+void run_tls_session_cache_tests(void);
+
+#endif // TLS_SESSION_CACHE_TEST_H
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef URL_TEST_H
+#define URL_TEST_H
+
+#include "helpers.h"
+
+void test_url_components();
+void test_url_default_ports();
+void test_url_ipv6_literal();
+void test_url_userinfo();
+void test_url_invalid_port();
+void test_url_without_path();
+void test_request_line_uses_parsed_url();
+void benchmark_url_parse_per_request();
+void run_url_tests(void);
+
+#endif // URL_TEST_H
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "WarmStateTest.h"
+#include "../src/core/WarmState.h"
+#include <cstring>
+#include <ctime>
+
+namespace
+{
+    canaspad::Cookie makeCookie(const std::string &name, time_t expires)
+    {
+        canaspad::Cookie cookie;
+        cookie.name = name;
+        cookie.value = "value";
+        cookie.domain = "example.com";
+        cookie.path = "/";
+        cookie.secure = true;
+        cookie.httpOnly = false;
+        cookie.expires = expires;
+        return cookie;
+    }
+
+    // ディープスリープ中も保持される RTC メモリを模したバッファ
+    uint8_t rtcBuffer[1024];
+}
+
+void test_warm_state_round_trip()
+{
+    time_t expiresAt = time(nullptr) + 600;
+    canaspad::WarmState state;
+    state.tlsSessions.push_back({"example.com:443", {1, 2, 3}, expiresAt});
+    state.dnsEntries.push_back({"example.com", 0x0100007F, expiresAt});
+    state.cookies.push_back(makeCookie("sid", expiresAt));
+
+    canaspad::BufferByteSink sink(rtcBuffer, sizeof(rtcBuffer));
+    TEST_ASSERT_TRUE(state.writeTo(sink).isSuccess());
+
+    canaspad::BufferByteSource source(rtcBuffer, sink.size());
+    auto restored = canaspad::WarmState::readFrom(source);
+    TEST_ASSERT_TRUE(restored.isSuccess());
+    const auto &value = restored.value();
+    TEST_ASSERT_EQUAL_INT(1, value.tlsSessions.size());
+    TEST_ASSERT_EQUAL_STRING("example.com:443", value.tlsSessions[0].key.c_str());
+    TEST_ASSERT_TRUE(value.tlsSessions[0].session == std::vector<uint8_t>({1, 2, 3}));
+    TEST_ASSERT_EQUAL_INT(1, value.dnsEntries.size());
+    TEST_ASSERT_EQUAL_UINT32(0x0100007F, value.dnsEntries[0].address);
+    TEST_ASSERT_EQUAL_INT(1, value.cookies.size());
+    TEST_ASSERT_EQUAL_STRING("sid", value.cookies[0].name.c_str());
+    TEST_ASSERT_TRUE(value.cookies[0].secure);
+    TEST_ASSERT_TRUE(value.cookies[0].expires == expiresAt);
+}
+
+void test_warm_state_rejects_uninitialised_buffer()
+{
+    // 電源投入直後の RTC メモリは不定値
+    memset(rtcBuffer, 0xA5, sizeof(rtcBuffer));
+    canaspad::BufferByteSource source(rtcBuffer, sizeof(rtcBuffer));
+    auto restored = canaspad::WarmState::readFrom(source);
+    TEST_ASSERT_TRUE(restored.isError());
+    TEST_ASSERT_EQUAL(canaspad::ErrorCode::InvalidSnapshot, restored.error().code);
+}
+
+void test_warm_state_rejects_corrupted_payload()
+{
+    canaspad::WarmState state;
+    state.dnsEntries.push_back({"example.com", 0x0100007F, time(nullptr) + 600});
+    canaspad::BufferByteSink sink(rtcBuffer, sizeof(rtcBuffer));
+    TEST_ASSERT_TRUE(state.writeTo(sink).isSuccess());
+
+    rtcBuffer[sink.size() - 6] ^= 0xFF;
+    canaspad::BufferByteSource source(rtcBuffer, sink.size());
+    TEST_ASSERT_TRUE(canaspad::WarmState::readFrom(source).isError());
+
+    // 容量不足の書き込み先はエラーになる
+    canaspad::BufferByteSink smallSink(rtcBuffer, 8);
+    TEST_ASSERT_TRUE(state.writeTo(smallSink).isError());
+}
+
+void test_warm_state_drops_expired_entries()
+{
+    time_t now = time(nullptr);
+    canaspad::ClientOptions options;
+    canaspad::ConnectionPool pool(options, [options](const std::string &)
+                                  { return std::make_shared<canaspad::MockWiFiClientSecure>(options); });
+
+    canaspad::WarmState state;
+    state.tlsSessions.push_back({"fresh.example.com:443", {1}, now + 600});
+    state.tlsSessions.push_back({"stale.example.com:443", {2}, now - 1});
+    state.dnsEntries.push_back({"fresh.example.com", 0x0100007F, now + 600});
+    state.dnsEntries.push_back({"stale.example.com", 0x0100007F, now - 1});
+    state.cookies.push_back(makeCookie("fresh", now + 600));
+    state.cookies.push_back(makeCookie("stale", now - 1));
+    pool.importWarmState(state);
+
+    auto exported = pool.exportWarmState();
+    TEST_ASSERT_EQUAL_INT(1, exported.tlsSessions.size());
+    TEST_ASSERT_EQUAL_STRING("fresh.example.com:443", exported.tlsSessions[0].key.c_str());
+    TEST_ASSERT_EQUAL_INT(1, exported.dnsEntries.size());
+    TEST_ASSERT_EQUAL_STRING("fresh.example.com", exported.dnsEntries[0].host.c_str());
+    TEST_ASSERT_EQUAL_INT(1, exported.cookies.size());
+    TEST_ASSERT_EQUAL_STRING("fresh", exported.cookies[0].name.c_str());
+}
+
+void test_http_client_warm_start_skips_dns_and_full_handshake()
+{
+    canaspad::ClientOptions options;
+    options.verifySsl = false;
+    const char *response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+    canaspad::Request request;
+    request.setUrl("https://example.com/").setMethod(canaspad::HttpMethod::GET);
+
+    size_t snapshotSize = 0;
+    {
+        // スリープ前
+        canaspad::HttpClient client(options, true);
+        auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+        mockClient->injectResponse(std::string(response));
+        TEST_ASSERT_TRUE(client.send(request).isSuccess());
+        TEST_ASSERT_EQUAL_INT(1, mockClient->getDnsLookupCount());
+
+        canaspad::BufferByteSink sink(rtcBuffer, sizeof(rtcBuffer));
+        TEST_ASSERT_TRUE(client.saveWarmState(sink).isSuccess());
+        snapshotSize = sink.size();
+    }
+
+    // 起床後
+    canaspad::HttpClient client(options, true);
+    canaspad::BufferByteSource source(rtcBuffer, snapshotSize);
+    TEST_ASSERT_TRUE(client.loadWarmState(source).isSuccess());
+
+    auto *mockClient = static_cast<canaspad::MockWiFiClientSecure *>(client.getConnection());
+    mockClient->injectResponse(std::string(response));
+    TEST_ASSERT_TRUE(client.send(request).isSuccess());
+
+    TEST_ASSERT_EQUAL_INT(0, mockClient->getDnsLookupCount());
+    TEST_ASSERT_EQUAL_INT(1, client.getDnsCacheStats().hits);
+    auto tlsStats = client.getTlsSessionStats();
+    TEST_ASSERT_EQUAL_INT(1, tlsStats.resumedHandshakes);
+    TEST_ASSERT_EQUAL_INT(0, tlsStats.fullHandshakes);
+}
+
+void run_warm_state_tests(void)
+{
+    RUN_TEST(test_warm_state_round_trip);
+    RUN_TEST(test_warm_state_rejects_uninitialised_buffer);
+    RUN_TEST(test_warm_state_rejects_corrupted_payload);
+    RUN_TEST(test_warm_state_drops_expired_entries);
+    RUN_TEST(test_http_client_warm_start_skips_dns_and_full_handshake);
+}
\ No newline at end of file
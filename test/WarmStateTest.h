@@ -0,0 +1,13 @@
+#ifndef WARM_STATE_TEST_H
+#define WARM_STATE_TEST_H
+
+#include "helpers.h"
+
+void test_warm_state_round_trip();
+void test_warm_state_rejects_uninitialised_buffer();
+void test_warm_state_rejects_corrupted_payload();
+void test_warm_state_drops_expired_entries();
+void test_http_client_warm_start_skips_dns_and_full_handshake();
+void run_warm_state_tests(void);
+
+#endif // WARM_STATE_TEST_H
\ No newline at end of file
@@ -2,4 +2,7 @@
 #include <cstring>
 #include "../src/HttpClient.h"
 #include "../src/core/mock/MockWiFiClientSecure.h"
-#include <Arduino.h>
\ No newline at end of file
+#include "../src/utils/Platform.h"
+#if CANASPAD_PLATFORM_ARDUINO
+#include <Arduino.h>
+#endif
\ No newline at end of file
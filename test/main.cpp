@@ -7,6 +7,32 @@
 #include "TimeoutTest.h"
 #include "ProxyTest.h"
 #include "MockWiFiClientSecureTest.h"
+#include "ResponseParserTest.h"
+#include "ChunkedTest.h"
+#include "StreamingTest.h"
+#include "ConnectionPoolTest.h"
+#include "TlsSessionCacheTest.h"
+#include "WarmStateTest.h"
+#include "LogTest.h"
+#include "BufferedConnectionTest.h"
+#include "ReadDeadlineTest.h"
+#include "UrlTest.h"
+#include "PreparedRequestTest.h"
+#include "RequestWriteTest.h"
+#include "BodySourceTest.h"
+#include "MultipartTest.h"
+#include "HeaderMapTest.h"
+#include "ArenaTest.h"
+#include "AllocationBudgetTest.h"
+#include "RequestTimingTest.h"
+#include "MetricsTest.h"
+#include "PosixConnectionTest.h"
+#include "EndToEndTest.h"
+#include "ThroughputBenchmarkTest.h"
+#include "AsyncSendTest.h"
+#include "CoroutineTest.h"
+#include "EventLoopTest.h"
+#include "CancellationTest.h"
 #include <unity.h>
 
 void setUp(void)
@@ -19,7 +45,7 @@ void tearDown(void)
     // 共通のクリーンアップコード
 }
 
-void runUnityTests()
+int runUnityTests()
 {
     UNITY_BEGIN();
 
@@ -28,14 +54,41 @@ void runUnityTests()
     run_url_and_port_tests();
     run_ssl_connection_tests();
     run_cookie_tests();
+    run_response_parser_tests();
+    run_chunked_tests();
+    run_streaming_tests();
+    run_connection_pool_tests();
+    run_tls_session_cache_tests();
+    run_warm_state_tests();
+    run_log_tests();
+    run_buffered_connection_tests();
+    run_read_deadline_tests();
+    run_url_tests();
+    run_prepared_request_tests();
+    run_request_write_tests();
+    run_body_source_tests();
+    run_multipart_tests();
+    run_header_map_tests();
+    run_arena_tests();
+    run_allocation_budget_tests();
+    run_request_timing_tests();
+    run_metrics_tests();
+    run_posix_connection_tests();
+    run_end_to_end_tests();
+    run_throughput_benchmark_tests();
+    run_async_send_tests();
+    run_coroutine_tests();
+    run_event_loop_tests();
+    run_cancellation_tests();
     // run_redirect_tests();
     // run_retry_tests();
     // run_timeout_tests();
     // run_proxy_tests();
 
-    UNITY_END();
+    return UNITY_END();
 }
 
+#if CANASPAD_PLATFORM_ARDUINO
 void setup()
 {
     delay(2000);
@@ -45,4 +98,11 @@ void setup()
 void loop()
 {
     delay(1000); // テスト終了後、1秒待機 (任意)
-}
\ No newline at end of file
+}
+#else
+// ホストのビルド (pio test -e native) ではテストを実行して終了する
+int main(int argc, char **argv)
+{
+    return runUnityTests();
+}
+#endif
\ No newline at end of file